@@ -0,0 +1,47 @@
+////////////////////////////////////////////////////////////
+//                                                        //
+// This file is part of the VRPH software package for     //
+// generating solutions to vehicle routing problems.      //
+// VRPH was developed by Chris Groer (cgroer@gmail.com).  //
+//                                                        //
+// (c) Copyright 2010 Chris Groer.                        //
+// All Rights Reserved.  VRPH is licensed under the       //
+// Common Public License.  See LICENSE file for details.  //
+//                                                        //
+////////////////////////////////////////////////////////////
+
+#ifndef _COMPOSITE_SEARCH_H
+#define _COMPOSITE_SEARCH_H
+
+class CompositeSearch
+{
+public:
+    bool search(class VRP *V, int j, int heuristics, int rules);
+
+private:
+    void load(class VRP *V, int j, int heuristics, int rules);
+    bool consider(class VRP *V, int heuristic, VRPMove *M);
+    bool move(class VRP *V, int heuristic, VRPMove *M);
+
+    OnePointMove OPM;
+    TwoPointMove TPM;
+    TwoOpt TO;
+    OrOpt OR;
+
+    int heuristics;
+    int rules;
+    int accept_type;
+    bool reverted;
+    VRPMove BestM;
+    int best_heuristic;
+
+    // The node being searched, its neighbors t-j-v-w and the
+    // distances that every candidate shares
+    int j, t, v, w;
+    bool do_opm, do_tpm, do_to, do_or;
+    double tj, jv, opm_removal, or_removal, max_gain;
+
+};
+
+#endif
+
@@ -12,10 +12,14 @@
 #ifndef _CROSS_EX_H
 #define _CROSS_EX_H
 
+// Longest segment exchanged by the bounded search in RTR_solve
+#define CE_MAX_SEGMENT_LENGTH   8
+
 class CrossExchange
 {
 public:
     bool route_search(class VRP *V, int r1, int r2, int criteria);
+    bool route_search(class VRP *V, int r1, int r2, int max_len, int criteria);
 
 private:
     bool evaluate(class VRP *V, int i1, int i2, int k1, int k2, int j1, int j2, int l1, int l2,
@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////
+//                                                        //
+// This file is part of the VRPH software package for     //
+// generating solutions to vehicle routing problems.      //
+// VRPH was developed by Chris Groer (cgroer@gmail.com).  //
+//                                                        //
+// (c) Copyright 2010 Chris Groer.                        //
+// All Rights Reserved.  VRPH is licensed under the       //
+// Common Public License.  See LICENSE file for details.  //
+//                                                        //
+////////////////////////////////////////////////////////////
+
+#ifndef _HELD_KARP_H
+#define _HELD_KARP_H
+
+// Routes with up to VRP::held_karp_size customers are solved exactly.  The
+// table has 2^k*k entries for k customers, so the size is capped.
+#define HELD_KARP_DEFAULT_SIZE      12
+#define HELD_KARP_MAX_SIZE          16
+
+class HeldKarp
+{
+public:
+    HeldKarp();
+    ~HeldKarp();
+
+    bool route_search(class VRP *V, int r, int rules);
+    bool search_routes(class VRP *V, int rules);
+
+private:
+    bool solve(class VRP *V, int r, int rules);
+    bool move(class VRP *V, int r);
+
+    // cost[mask*m+u] is the length of the cheapest path from the VRPH_DEPOT
+    // through the units in mask ending with unit u, and parent[] the unit
+    // before u on it
+    double *cost;
+    int *parent;
+    int table_size;
+
+    // The route is split into m units, strings joined by fixed edges or
+    // single customers, with their first and last customers and the length
+    // of the string between them
+    int m;
+    int first[HELD_KARP_MAX_SIZE];
+    int last[HELD_KARP_MAX_SIZE];
+    double inner[HELD_KARP_MAX_SIZE];
+
+    // The new order of the customers
+    int num_customers;
+    int order[HELD_KARP_MAX_SIZE];
+
+};
+
+#endif
+
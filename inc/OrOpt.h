@@ -13,15 +13,22 @@
 #ifndef _OR_H
 #define _OR_H
 
+// Longest string searched by OrOpt::search over several lengths
+#define OR_MAX_STRING_LENGTH    10
+
 
 class OrOpt
 {
+    friend class CompositeSearch;
+
 public:
     bool search(class VRP *V, int i, int j, int rules);
+    bool search(class VRP *V, int a, int min_len, int max_len, int rules);
     bool route_search(class VRP *V, int r1, int r2, int k, int rules);
 
 private:
-    bool evaluate(class VRP *V, int a, int len, int c, int d, int rules, VRPMove *M);
+    bool evaluate(class VRP *V, int a, int len, int c, int d, bool reversed, int rules, 
+        VRPMove *M);
     bool move(class VRP *V, VRPMove *M);	
 
 };
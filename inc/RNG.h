@@ -17,6 +17,9 @@
 
 double lcgrand(int stream);
 void random_permutation(int *perm, int n);
+#if VRPH_SMALL_INDEX
+void random_permutation(VRPIndex *perm, int n);
+#endif
 
 #endif
 
@@ -0,0 +1,33 @@
+////////////////////////////////////////////////////////////
+//                                                        //
+// This file is part of the VRPH software package for     //
+// generating solutions to vehicle routing problems.      //
+// VRPH was developed by Chris Groer (cgroer@gmail.com).  //
+//                                                        //
+// (c) Copyright 2010 Chris Groer.                        //
+// All Rights Reserved.  VRPH is licensed under the       //
+// Common Public License.  See LICENSE file for details.  //
+//                                                        //
+////////////////////////////////////////////////////////////
+
+#ifndef _SWAP_STAR_H
+#define _SWAP_STAR_H
+
+class SwapStar
+{
+public:
+    bool route_search(class VRP *V, int r1, int r2, int rules);
+
+private:
+    void find_best_insertions(class VRP *V, int u, int *seq, int L, int rules,
+        VRPBestInsertions *B);
+    double best_insertion(class VRP *V, int u, VRPBestInsertions *B, int t, int v, int w,
+        int *after);
+    void find_sector(class VRP *V, int r, double *start, double *width);
+    bool sectors_overlap(class VRP *V, int r1, int r2);
+    bool move(class VRP *V, VRPMove *M);
+
+};
+
+#endif
+
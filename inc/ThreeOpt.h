@@ -16,11 +16,58 @@
 class ThreeOpt
 {
 public:
+	ThreeOpt();
+	~ThreeOpt();
+
 	bool route_search(class VRP *V, int r, int criteria);
+	bool search_routes(class VRP *V, int criteria);
+	bool search_routes(class VRP *V, int num_routes, int *routes, int criteria);
 
 private:
+	bool neighbor_search(class VRP *V, int r, int criteria);
+	int route_positions(class VRP *V, int r, int t, int *pos, int *p);
 	bool evaluate(class VRP *V, int a, int b, int c, int d, int e, int f, int criteria, VRPMove *M);
 	bool move(class VRP *V, VRPMove *M);
+
+	// Searching a copy of a route
+	bool copy_search(class VRP *V, int r, int criteria);
+	bool copy_step(class VRP *V, int r, int criteria);
+	bool copy_try(class VRP *V, int *p, int criteria, int accept_type);
+	bool copy_evaluate(class VRP *V, int *p, int criteria, int *type, double *savings);
+	bool copy_time_windows(class VRP *V, int *p, int type);
+	bool copy_visit(class VRP *V, double *t, int *prev, int from, int to);
+	void copy_times(class VRP *V);
+	bool copy_move(class VRP *V);
+	void reverse(int from, int to);
+	double flip_savings(class VRP *V, int s, int ps, int pe, int e);
+
+	// The copy of the route: seq[p] is the node in position p with the
+	// VRPH_DEPOT at 0 and L+1, pos[] is its inverse for the customers and
+	// len is the length the route has in V.  With time windows the arrival,
+	// waiting time and forward time slack are kept by position.
+	int L;
+	double len;
+	int *seq;
+	int *pos;
+	double *arrival;
+	double *wait;
+	double *slack;
+	int seq_size;
+	int pos_size;
+
+	// The move found by copy_step(), by position
+	int best_p[6];
+	int best_type;
+	double best_savings;
+	bool have_best;
+
+	// The moves made on the copy, each as the six nodes a..f, the type and
+	// the number of evaluations made to find it
+	int *path;
+	double *path_savings;
+	int path_size;
+	int num_path_moves;
+	int num_copy_evaluations;
 	
 };
 
@@ -15,12 +15,16 @@
 
 class TwoOpt
 {
+    friend class CompositeSearch;
+
 public:
     bool search(class VRP *V, int i, int criteria);
     bool route_search(class VRP *V, int r1, int r2, int criteria);
 
 private:
     bool evaluate(class VRP *V, int a, int b, int c, int d, int criteria, VRPMove *M);
+    template<int R> bool search_rules(class VRP *V, int b, int rules);
+    template<int R> bool evaluate_rules(class VRP *V, int a, int b, int c, int d, int rules, VRPMove *M);
     bool move(class VRP *V, VRPMove *M);
 
 };
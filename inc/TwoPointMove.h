@@ -16,12 +16,17 @@
 
 class TwoPointMove
 {
+    friend class CompositeSearch;
+
 public:
     bool search(class VRP *V, int i, int rules);
     bool route_search(class VRP *V, int r1, int r2, int rules);
 
 private:
     bool evaluate(class VRP *V, int i, int j, int rules, VRPMove *M);
+    template<int R> bool search_rules(class VRP *V, int j, int rules);
+    template<int R> bool evaluate_rules(class VRP *V, int j, int b, int rules, VRPMove *M);
+    void screen(class VRP *V, int j, double limit);
     bool move(class VRP *V, VRPMove *M);//, int i, int j);
 
 };
@@ -13,6 +13,9 @@
 #ifndef _VRP_H
 #define _VRP_H
 
+// Number of operators that keep separate don't-look bits at once
+#define VRPH_IDLE_SLOTS     1
+
 // VRP class
 class VRP
 {
@@ -24,6 +27,9 @@ class VRP
     friend class ThreeOpt;
     friend class OrOpt;
     friend class CrossExchange;
+    friend class SwapStar;
+    friend class CompositeSearch;
+    friend class HeldKarp;
 
     friend class Postsert;
     friend class Presert;
@@ -34,6 +40,7 @@ class VRP
     friend class Flip;
 
     friend class ClarkeWright;
+    friend class VRPMoveQueue;
     friend class Sweep;
 
 public:
@@ -41,6 +48,8 @@ public:
     // Constructor for problems with n non-VRPH_DEPOT nodes
     VRP(int n, int ndays);
     // Construct for problems with n non-VRPH_DEPOT nodes and num_days days
+    VRP(VRP *W);
+    // Construct a search state that shares the instance data of the loaded problem W
 
     // Destructor
     ~VRP();
@@ -55,6 +64,7 @@ public:
     void show_pred_array();
     bool verify_routes(const char *message);
     bool check_fixed_edges(const char *message);
+    bool check_feasibility(VRPViolation *VV);
     void create_pred_array();
     void print_stats();
 
@@ -66,9 +76,9 @@ public:
     int read_fixed_edges(const char *filename);
 
     // Solution buffers (import/export)
-    void export_solution_buff(int *sol_buff);
-    void import_solution_buff(int *sol_buff);
-    void export_canonical_solution_buff(int *sol_buff);
+    void export_solution_buff(VRPIndex *sol_buff);
+    void import_solution_buff(VRPIndex *sol_buff);
+    void export_canonical_solution_buff(VRPIndex *sol_buff);
 
     // Solution display
     void show_routes();
@@ -114,12 +124,13 @@ public:
     void normalize_route_numbers();
     void update_route(int j, VRPRoute *R);
     void clean_route(int r, int heuristics);
+    void clean_routes(int heuristics);
     double split(double p);
     int split_routes(double p, int **ejected_routes, double *t);
     void add_route(int *route_buff);
-    void append_route(int *sol_buff, int *route_buff);
-    int intersect_solutions(int *new_sol, int **routes, int *sol1, int *sol2, int min_routes);
-    int find_common_routes(int *sol1, int *sol2, int *route_nums);
+    void append_route(VRPIndex *sol_buff, int *route_buff);
+    int intersect_solutions(VRPIndex *new_sol, int **routes, VRPIndex *sol1, VRPIndex *sol2, int min_routes);
+    int find_common_routes(VRPIndex *sol1, VRPIndex *sol2, int *route_nums);
 
     // Fixing edges
     void list_fixed_edges(int *fixed_list);
@@ -132,7 +143,7 @@ public:
     int get_num_nodes();
     double get_total_route_length();
     double get_total_service_time();
-    double get_best_sol_buff(int *sol_buff);
+    double get_best_sol_buff(VRPIndex *sol_buff);
     double get_best_total_route_length();
     int get_total_number_of_routes();
     int get_num_original_nodes();
@@ -159,6 +170,12 @@ public:
     // Route reversal
     void reverse_route(int i);
 
+    // If true, RTR_solve and clean_route solve short routes exactly with
+    // HELD_KARP in place of the THREE_OPT search.  Routes with at most
+    // held_karp_size customers are solved exactly, up to HELD_KARP_MAX_SIZE
+    bool use_held_karp;
+    int held_karp_size;
+
     // Statistics
     int num_evaluations[NUM_HEURISTICS];
     int num_moves[NUM_HEURISTICS];
@@ -169,7 +186,7 @@ private:
     int num_nodes;
     double total_route_length;
     double total_service_time;
-    int *best_sol_buff;                // Place for the best solution to live
+    VRPIndex *best_sol_buff;           // Place for the best solution to live
     double best_total_route_length;
     int total_number_of_routes;
     int num_original_nodes;
@@ -202,11 +219,48 @@ private:
     bool can_display;
 
     double **d;                    // The distance matrix d
-    bool **fixed;                // Matrix to keep track of fixed edges
+    // Fixed edges are undirected and a customer usually lies on at most two of
+    // them, so the fixed neighbors of customer i (possibly VRPH_DEPOT) are kept in
+    // fixed_neighbors[2*i] and fixed_neighbors[2*i+1], with -1 if unused.  An edge
+    // whose customer endpoints do not both have a free slot goes in fixed_edge_set
+    VRPIndex *fixed_neighbors;
+    VRPEdgeSet *fixed_edge_set;
+    int num_fixed_depot_edges;
+    inline bool is_fixed(int a, int b){
+        ///
+        /// Returns true if the edge a-b has been fixed.  The dummy node
+        /// is fixed to the VRPH_DEPOT whenever some VRPH_DEPOT edge is.
+        ///
+
+        if(a==dummy_index || b==dummy_index)
+            return (a==VRPH_DEPOT || b==VRPH_DEPOT) && num_fixed_depot_edges>0;
+        if(a==VRPH_DEPOT)
+        {
+            a=b;
+            b=VRPH_DEPOT;
+        }
+        if(fixed_neighbors[2*a]==b || fixed_neighbors[2*a+1]==b)
+            return true;
+        return fixed_edge_set->num_edges>0 && fixed_edge_set->contains(a,b);
+    }
 
     class VRPNode *nodes;        // Array of nodes - contains coordinates, demand
     // amounts, etc.
 
+    // Demand and service time of each node, copied out of nodes[] so that
+    // the feasibility checks in the move evaluations read dense arrays
+    int *demand_array;
+    double *service_time_array;
+    void update_node_arrays();
+
+    // The instance data d, fixed_neighbors, fixed_edge_set, nodes and the node arrays is read-only during the search and
+    // may be shared by several VRP objects - only the owner frees it.  The owner counts the VRPs sharing
+    // its data and must outlive them.
+    bool owns_instance;
+    VRP *instance_owner;
+    int num_instance_sharers;
+    void share_instance(VRP *W);
+
     bool depot_normalized;        // Set to true if VRPH_DEPOT coords normalized to origin
     // for Euclidean problem.
 
@@ -216,19 +270,39 @@ private:
     // Local search neighborhood creation
     bool create_search_neighborhood(int j, int rules);    
     int search_size;            
-    int *search_space;            
+    VRPIndex *search_space;            
 
     // Solution storage
-    int *next_array;
-    int *pred_array;
-    int *route_num;
+    VRPIndex *next_array;
+    VRPIndex *pred_array;
+    VRPIndex *route_num;
     bool *routed;            // Indicates whether the customer is in a route yet or not
 
     class VRPRoute *route;    // Array stores useful information about the routes in a solution
 
+    // Route ids are kept dense (1,2,...,R) by recycling the ids of emptied routes
+    VRPIndex *free_routes;   // Ids of routes emptied since the last call to reclaim_routes()
+    int num_free_routes;
+    void reclaim_routes();
+
     // Tabu search - very limited testing so far!!
     class VRPTabuList *tabu_list;
-    bool check_tabu_status(VRPMove *M, int *old_sol);
+    bool check_tabu_status(VRPMove *M);
+
+    // Undo journal - while active, the pre-image of every node and route
+    // is recorded before its first modification so that the moves made
+    // since start_journal() can be undone in O(changes).  The node arrays
+    // must be written with set_next(), set_pred() and set_route_num()
+    class VRPJournal *journal;
+    bool journal_on;
+#if JOURNAL_VERIFY
+    VRPIndex *journal_sol;
+#endif
+    void start_journal();
+    void stop_journal();
+    void undo_journal();
+    void journal_node(int j);
+    void journal_route_info(int r);
 
     double record;        // For RTR
     double deviation;    // For RTR
@@ -236,13 +310,12 @@ private:
     double min_theta;
     double max_theta;    // Polar min/max
 
-    int *current_sol_buff;  // Place for the current solution if desired
+    VRPIndex *current_sol_buff;  // Place for the current solution if desired
 
     // Accessing edge information
     bool before(int a, int b);
 
     // To handle infeasibilities
-    bool check_feasibility(VRPViolation *VV);
     class VRPViolation violation;
     bool is_feasible(VRPMove *M, int rules);    
 
@@ -273,9 +346,185 @@ private:
     int get_string_end(int a, int len);
     int count_num_routes();
     void update_arrival_times();
-    bool  check_move(VRPMove *M, int rules);
+
+    // Route versions - route_changed(r) is called whenever route r is modified
+    // and gives it the next value of route_clock
+    int route_clock;
+    inline void route_changed(int r){
+        route[r].times_valid=false;
+        route[r].version=++route_clock;
+    }
+
+    // Don't-look bits for the downhill phase of RTR_solve.  An operator skips
+    // node j while neither the route of j nor the route of any node in its 
+    // neighbor list has changed since it last searched j without success.
+    int *idle_stamp;
+    void clear_idle_stamps();
+    bool is_idle(int j, int slot);
+    void set_idle(int j, int slot);
+
+    // Route pair searches that found no move.  The search of routes r1 and r2
+    // by a heuristic with the same rules is skipped until either route changes.
+    struct VRPPairSearch *pair_cache;
+    int pair_cache_size;
+    void clear_pair_cache();
+    bool pair_searched(int r1, int r2, int heuristic, int rules);
+    void pair_search_failed(int r1, int r2, int heuristic, int rules);
+
+    // Cheapest insertions of single customers into routes.  The insertions of
+    // j into route r are found again only once route r has changed.
+    struct VRPRouteInsertions *insertion_cache;
+    int insertion_cache_size;
+    void clear_insertion_cache();
+    struct VRPBestInsertions *best_insertions(int j, int r);
+
+    // The customers of each route in order.  A route is listed again only once
+    // it has changed, so search spaces are copied from here rather than
+    // found by walking the solution.
+    struct VRPRouteMembers *route_members;
+    void clear_route_members();
+    VRPIndex *route_customers(int r);
+
+    // Routes known to be locally optimal under a set of intra-route heuristics.
+    // A route whose customer sequence is found here is not searched again by
+    // those heuristics, even if it was changed and later restored.
+    struct VRPOptimalRoute *route_memo;
+    int route_memo_size;
+    VRPRoute *memo_route;
+    void clear_route_memo();
+    bool route_is_optimal(int r, int heuristics);
+    void route_found_optimal(int r, int heuristics);
+    void clean_route_moves(int r, int heuristics);
+
+    // Savings of the best move found by a search with VRPH_EVALUATE_ONLY
+    double best_savings;
+
+    // Time windows - the arrival time, waiting time and forward time slack
+    // at each node are recomputed one route at a time after the route changes
+    bool has_time_windows;
+    double *arrival_time;
+    double *wait_time;
+    double *time_slack;
+    void update_route_times(int r);
+    double travel_time(int i, int j);
+    double departure_time(int i);
+    bool tw_visit(double *t, int *prev, int j);
+    bool tw_visit_string(double *t, int *prev, int first, int last, bool reversed);
+    bool tw_push(double t, int prev, int k, double *push);
+    bool tw_before(int p, int q);
+    bool tw_splice(int p, double delay, int first, int last, bool reversed, int k, double *push);
+    bool tw_splices(int *p, int *first, int *last, bool *reversed, int *q, bool same_route);
+    bool tw_replace(int v, int u, int x);
+    bool tw_insert(int j, int a, int b);
+    bool check_time_windows(VRPMove *M);
+
+    // Solution hashing - solution_hash is the sum over all edges in the current
+    // solution of a 64-bit edge key and is updated whenever next_array[] changes.
+    // Edges are undirected unless there are time windows.
+    VRPHash solution_hash;
+    VRPHash *node_keys;
+    VRPHash *node_keys2;
+    VRPHash hash_solution();
+    VRPHash hash_route(int r);
+
+    inline VRPHash edge_key(int a, int b){
+        if(has_time_windows)
+            return node_keys[a]*node_keys2[b];
+        return node_keys[a]*node_keys[b];
+    }
+
+    inline VRPHash next_key(int i, int v){
+        ///
+        /// Returns the sum of the keys of the edges implied by next_array[i]=v.
+        ///
+
+        if(i==VRPH_DEPOT)
+            return (v==VRPH_DEPOT) ? 0 : edge_key(VRPH_DEPOT,VRPH_ABS(v));
+        if(v>=0)
+            return edge_key(i,v);
+        // i ends a route and -v starts the next one
+        return edge_key(i,VRPH_DEPOT)+edge_key(VRPH_DEPOT,-v);
+    }
+
+    inline void set_next(int i, int v){
+        ///
+        /// Sets next_array[i]=v, updating the solution_hash and the journal.
+        ///
+
+        if(journal_on)
+            journal_node(i);
+        solution_hash += next_key(i,v) - next_key(i,next_array[i]);
+        next_array[i]=v;
+    }
+
+    inline void set_pred(int i, int v){
+        ///
+        /// Sets pred_array[i]=v.
+        ///
+
+        if(journal_on)
+            journal_node(i);
+        pred_array[i]=v;
+    }
+
+    inline void set_route_num(int i, int r){
+        ///
+        /// Sets route_num[i]=r.
+        ///
+
+        if(journal_on)
+            journal_node(i);
+        route_num[i]=r;
+    }
 
     // Savings evaluation - inline this to speed things up 
+    inline bool within_record(double savings){
+        ///
+        /// Returns true if a move with the given savings keeps the solution
+        /// within the record-to-record deviation of the record.  With service
+        /// times the service time is removed from the deviation calculation.
+        ///
+
+        if(has_service_times==false)
+            return (total_route_length+savings <= (1+deviation)*record);
+
+        return ((total_route_length - total_service_time) + savings <= 
+            ((1+deviation)*(record-total_service_time)));
+    }
+
+    inline double savings_limit(int rules){
+        ///
+        /// Returns a value that the savings of any move accepted by check_move
+        /// under the rules cannot exceed, or VRP_INFINITY if acceptance does
+        /// not depend on the savings alone.  The limit includes a tolerance
+        /// of VRPH_EPSILON so that savings computed in a different order
+        /// can be compared against it safely.
+        ///
+
+        double limit;
+
+        switch(rules & VRPH_ACCEPTANCE_RULES)
+        {
+        case VRPH_DOWNHILL:
+            limit=-VRPH_EPSILON;
+            break;
+
+        case VRPH_RECORD_TO_RECORD:
+            if(has_service_times==false)
+                limit=(1+deviation)*record - total_route_length;
+            else
+                limit=(1+deviation)*(record-total_service_time) -
+                (total_route_length-total_service_time);
+            limit=VRPH_MAX(limit,-VRPH_EPSILON);
+            break;
+
+        default:
+            return VRP_INFINITY;
+        }
+
+        return limit+VRPH_EPSILON;
+    }
+
     inline bool check_savings(VRPMove *M, int rules){
         ///
         /// Evaluates the given savings in terms of the rules.
@@ -293,6 +542,7 @@ private:
             M->evaluated_savings=true;
             return true;
         }
+
         // The order needs to be changed if we eventually add additional rules
         // that do not always accept improving moves!!
 
@@ -302,50 +552,18 @@ private:
 
         if( (rules & VRPH_DOWNHILL) )
         {
-            if(M->savings>=-VRPH_EPSILON )
-            {
-                M->evaluated_savings=true;
-                return false;
-            }
+            M->evaluated_savings=true;
+            return false;
         }
 
         if( (rules & VRPH_RECORD_TO_RECORD) )
         {
-            if(M->savings<-VRPH_EPSILON)
+            if(within_record(M->savings))
             {
                 M->evaluated_savings=true;
                 return true;
             }
-            else
-            {
-
-                if(has_service_times==false)
-                {
-                    if( (total_route_length+M->savings<= (1+deviation)*record) )
-                    {
-                        M->evaluated_savings=true;
-                        return true;
-                    }
-                    else
-                        return false;
-                }
-                else
-                {
-                    // We have service times so remove the service time from the
-                    // deviation calculation
-                    if( ((total_route_length - total_service_time) + M->savings <= 
-                        ((1+deviation)*(record-total_service_time))) )
-                    {
-                        M->evaluated_savings=true;
-                        return true;
-                    }
-                    else
-                        return false;
-                }
-
-
-            }
-
+            return false;
         }
 
         if( rules & VRPH_SIMULATED_ANNEALING )
@@ -365,7 +583,66 @@ private:
 
     };
 
+    inline bool check_move(VRPMove *M, int rules){
+        ///
+        /// Evaluates the move in terms of the rules.  Can consider savings,
+        /// as well as other aspects of the VRPMove M.  Inlined so that the
+        /// rule tests fold away in the searches specialized on the rules.
+        ///
+
+        double savings;
+
+        savings=M->savings;
+
+        if(this->forbid_tiny_moves)
+        {
+            // See if it is a "meaningless" move
+            if(savings>-VRPH_EPSILON && savings < VRPH_EPSILON)
+                return false;
+        }
+
+        if(this->has_time_windows && this->check_time_windows(M)==false)
+            return false;
+
+        if( (rules & VRPH_FREE) == VRPH_FREE )
+        {
+            // use with care!
+            return true;
+        }
+
+        if( (rules & VRPH_DOWNHILL) == VRPH_DOWNHILL)
+        {
+            if(savings<-VRPH_EPSILON )
+                return true;
+            else
+                return false;
+        }
+
+        if( rules & VRPH_RECORD_TO_RECORD )
+        {
+            if(savings<=-VRPH_EPSILON)
+                return true;
+
+            // o/w savings is positive but must be less than deviation*record
+            return this->within_record(savings);
+        }
+
+        if( rules & VRPH_SIMULATED_ANNEALING )
+        {
+            if(M->evaluated_savings==true)
+                return true;    // We already checked the random acceptance
+
+            // Otherwise, determine whether to accept or not.
+            if( exp(- (M->savings / this->temperature)) > lcgrand(10) )
+                return true;
+            else
+                return false;
+        }
 
+        report_error("%s: didn't return yet!\n",__FUNCTION__);
+
+        return false;
+    };
 
 
 };
@@ -75,6 +75,15 @@
 #define CROSS_EXCHANGE_DEBUG    0
 #define CROSS_EXCHANGE_VERIFY   0 + VERIFY_ALL
 
+#define SWAP_STAR_DEBUG         0
+#define SWAP_STAR_VERIFY        0 + VERIFY_ALL
+
+#define HELD_KARP_DEBUG         0
+#define HELD_KARP_VERIFY        0 + VERIFY_ALL
+
+#define JOURNAL_VERIFY          0 + VERIFY_ALL
+#define ROUTE_MEMBERS_VERIFY    0 + VERIFY_ALL
+
 
 #define NEIGHBOR_DEBUG          0
 #define TSPLIB_DEBUG            0
@@ -109,6 +109,22 @@
 #define VRPH_EPSILON                .00001
 #define VRPH_DEFAULT_DEVIATION      .01
 #define VRPH_MAX_NUM_ROUTES         10000
+// Node indices in the solution state (next_array, pred_array, route_num,
+// search_space and the undo journal) and in the solution buffers, including
+// those of the solution warehouse, are stored as VRPIndex.  Compile with 
+// -DVRPH_SMALL_INDEX=1 (make HAS_SMALL_INDEX=1) to use 16-bit indices,
+// halving the size of this state for instances with fewer than
+// VRPH_MAX_INDEX nodes.  The move arguments are still int.
+#ifndef VRPH_SMALL_INDEX
+#define VRPH_SMALL_INDEX            0
+#endif
+#if VRPH_SMALL_INDEX
+typedef short VRPIndex;
+#define VRPH_MAX_INDEX              32767
+#else
+typedef int VRPIndex;
+#define VRPH_MAX_INDEX              2147483647
+#endif
 // Perturb types
 #define VRPH_LI_PERTURB             0
 
@@ -132,6 +148,7 @@
 #include "VRPMove.h"
 #include "VRPSolution.h"
 #include "VRPTabuList.h"
+#include "VRPJournal.h"
 #include "VRP.h"
 #include "Postsert.h"
 #include "Presert.h"
@@ -148,8 +165,12 @@
 #include "OrOpt.h"
 #include "ThreeOpt.h"
 #include "CrossExchange.h"
+#include "SwapStar.h"
+#include "CompositeSearch.h"
+#include "HeldKarp.h"
 #include "VRPGenerator.h"
 #include "ThreePointMove.h"
+#include "VRPMoveQueue.h"
 
 void VRPH_version();
 
@@ -30,6 +30,7 @@
 #define VRPH_RANDOMIZED                         (1<<13)
 #define VRPH_SAVINGS_ONLY                       (1<<14)
 #define VRPH_MINIMIZE_NUM_ROUTES                (1<<15)
+#define VRPH_EVALUATE_ONLY                      (1<<16)
 #define VRPH_FIXED_EDGES                        (1<<17)
 #define VRPH_ALLOW_INFEASIBLE                   (1<<18)
 #define VRPH_NO_NEW_ROUTE                       (1<<19)
@@ -44,13 +45,63 @@
 #define CROSS_EXCHANGE                          (1<<26)
 #define THREE_POINT_MOVE                        (1<<27)
 #define KITCHEN_SINK                            (1<<28)
+#define VRPH_MOVE_QUEUE                         (1<<29)
+#define SWAP_STAR                               (1<<30)
+#define VRPH_COMPOSITE_SEARCH                   (1<<31)
+
+// The rules that decide whether a move is accepted
+#define VRPH_ACCEPTANCE_RULES                   (VRPH_DOWNHILL|VRPH_RECORD_TO_RECORD|VRPH_SIMULATED_ANNEALING|VRPH_FREE)
+
+// The rules fixed at compile time in the specialized searches of OnePointMove,
+// TwoPointMove and TwoOpt.  VRPH_STATIC_RULES(R,rules) replaces these bits of
+// rules with R, so that the tests on them fold away in a search instantiated
+// for R.  VRPH_DYNAMIC_RULES instantiates the search that tests every rule.
+#define VRPH_SPECIALIZED_RULES                  (VRPH_ACCEPTANCE_RULES|VRPH_FIRST_ACCEPT|VRPH_BEST_ACCEPT|\
+                                                 VRPH_LI_ACCEPT|VRPH_INTER_ROUTE_ONLY|VRPH_INTRA_ROUTE_ONLY|\
+                                                 VRPH_FIXED_EDGES|VRPH_TABU)
+#define VRPH_DYNAMIC_RULES                      (-1)
+#define VRPH_STATIC_RULES(R,rules)              ((R)==VRPH_DYNAMIC_RULES ? (rules) : \
+                                                 (((rules) & ~VRPH_SPECIALIZED_RULES) | (R)))
+
+// Calls F<R> args for the specialization R that matches the rules, or
+// F<VRPH_DYNAMIC_RULES> args if there is none.  The specializations are the
+// rules used by RTR_solve (the uphill and downhill phases without fixed edges
+// or tabu search) and by SA_solve.
+#define VRPH_DISPATCH_RULES(rules,F,args) \
+    switch((rules) & VRPH_SPECIALIZED_RULES) \
+    { \
+    case VRPH_RECORD_TO_RECORD|VRPH_LI_ACCEPT: \
+        return F<VRPH_RECORD_TO_RECORD|VRPH_LI_ACCEPT> args; \
+    case VRPH_RECORD_TO_RECORD|VRPH_LI_ACCEPT|VRPH_INTER_ROUTE_ONLY: \
+        return F<VRPH_RECORD_TO_RECORD|VRPH_LI_ACCEPT|VRPH_INTER_ROUTE_ONLY> args; \
+    case VRPH_DOWNHILL|VRPH_FIRST_ACCEPT: \
+        return F<VRPH_DOWNHILL|VRPH_FIRST_ACCEPT> args; \
+    case VRPH_DOWNHILL|VRPH_FIRST_ACCEPT|VRPH_INTER_ROUTE_ONLY: \
+        return F<VRPH_DOWNHILL|VRPH_FIRST_ACCEPT|VRPH_INTER_ROUTE_ONLY> args; \
+    case VRPH_DOWNHILL|VRPH_FIRST_ACCEPT|VRPH_INTRA_ROUTE_ONLY: \
+        return F<VRPH_DOWNHILL|VRPH_FIRST_ACCEPT|VRPH_INTRA_ROUTE_ONLY> args; \
+    case VRPH_DOWNHILL|VRPH_BEST_ACCEPT: \
+        return F<VRPH_DOWNHILL|VRPH_BEST_ACCEPT> args; \
+    case VRPH_DOWNHILL|VRPH_BEST_ACCEPT|VRPH_INTER_ROUTE_ONLY: \
+        return F<VRPH_DOWNHILL|VRPH_BEST_ACCEPT|VRPH_INTER_ROUTE_ONLY> args; \
+    case VRPH_DOWNHILL|VRPH_BEST_ACCEPT|VRPH_INTRA_ROUTE_ONLY: \
+        return F<VRPH_DOWNHILL|VRPH_BEST_ACCEPT|VRPH_INTRA_ROUTE_ONLY> args; \
+    case VRPH_SIMULATED_ANNEALING: \
+        return F<VRPH_SIMULATED_ANNEALING> args; \
+    case VRPH_SIMULATED_ANNEALING|VRPH_INTER_ROUTE_ONLY: \
+        return F<VRPH_SIMULATED_ANNEALING|VRPH_INTER_ROUTE_ONLY> args; \
+    case VRPH_SIMULATED_ANNEALING|VRPH_INTRA_ROUTE_ONLY: \
+        return F<VRPH_SIMULATED_ANNEALING|VRPH_INTRA_ROUTE_ONLY> args; \
+    default: \
+        return F<VRPH_DYNAMIC_RULES> args; \
+    }
 
 #define ALL_HEURISTICS                          (1<<20)|(1<<21)|(1<<22)|(1<<23)|(1<<24)|(1<<25)|(1<<26)|(1<<27)
 
 // Values of heuristics that can be used in functions such as 
 // clean_routes
 
-#define NUM_HEURISTICS                  7
+#define NUM_HEURISTICS                  9
 
 #define ONE_POINT_MOVE_INDEX            0                    
 #define TWO_POINT_MOVE_INDEX            1
@@ -59,6 +110,8 @@
 #define THREE_OPT_INDEX                 4
 #define CROSS_EXCHANGE_INDEX            5
 #define THREE_POINT_MOVE_INDEX          6
+#define SWAP_STAR_INDEX                 7
+#define HELD_KARP_INDEX                 8
 
 
 
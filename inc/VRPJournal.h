@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////
+//                                                        //
+// This file is part of the VRPH software package for     //
+// generating solutions to vehicle routing problems.      //
+// VRPH was developed by Chris Groer (cgroer@gmail.com).  //
+//                                                        //
+// (c) Copyright 2010 Chris Groer.                        //
+// All Rights Reserved.  VRPH is licensed under the       //
+// Common Public License.  See LICENSE file for details.  //
+//                                                        //
+////////////////////////////////////////////////////////////
+
+#ifndef _VRP_JOURNAL_H
+#define _VRP_JOURNAL_H
+
+class VRPJournal
+{
+    // Records the pre-image of every node and route touched since the
+    // last reset so that a sequence of moves can be undone in time
+    // proportional to the number of changes rather than to n.
+public:
+    VRPJournal();
+    VRPJournal(int n);
+
+    // Destructor
+    ~VRPJournal();
+
+    void reset();
+    bool add_node(int j);
+    bool add_route(int r);
+
+    int max_size;
+
+    // Node pre-images
+    int num_nodes;
+    VRPIndex *node;
+    VRPIndex *next;
+    VRPIndex *pred;
+    VRPIndex *route_num;
+    bool *routed;
+
+    // Route pre-images
+    int num_routes;
+    int *r;
+    int *start;
+    int *end;
+    int *load;
+    int *num_customers;
+    double *length;
+
+    // Solution-wide values at the time of the reset
+    double total_route_length;
+    int total_number_of_routes;
+    int num_vrp_nodes;
+    int num_free_routes;
+    VRPHash solution_hash;
+
+private:
+    // A node or route has been recorded iff its stamp equals
+    // current_stamp, so a reset does not have to clear anything
+    int current_stamp;
+    int *node_stamp;
+    int *route_stamp;
+};
+
+#endif
+
@@ -29,6 +29,7 @@ public:
     ~VRPMove();
 
 	bool is_better(class VRP *V, VRPMove *M2, int criteria);
+	bool is_better(class VRP *V, class VRPCompactMove *M2, int criteria);
 
 	int    criteria;
 	int    num_affected_routes;
@@ -51,5 +52,36 @@ public:
 
 };
 
+#define MAX_COMPACT_ARGUMENTS   4
+
+class VRPCompactMove
+{
+	///
+	/// The part of a VRPMove needed to compare it with other moves and
+	/// to make it, for moves that are made from at most
+	/// MAX_COMPACT_ARGUMENTS move_arguments alone (the eval_arguments are
+	/// not kept).  Fits in 64 bytes so that keeping the best move of a
+	/// search is cheap.  The route lengths and loads are recomputed when
+	/// the move is made.
+	///
+
+public:
+
+	VRPCompactMove();
+
+	VRPCompactMove& operator=(const VRPMove &M);
+	void expand(VRPMove *M);
+
+	double savings;
+	int    move_type;
+	int    total_number_of_routes;
+	int    num_affected_routes;
+	int    route_nums [MAX_AFFECTED_ROUTES];
+	int    route_custs[MAX_AFFECTED_ROUTES];
+	int    num_arguments;
+	int    move_arguments[MAX_COMPACT_ARGUMENTS];
+
+};
+
 #endif
 
@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////
+//                                                        //
+// This file is part of the VRPH software package for     //
+// generating solutions to vehicle routing problems.      //
+// VRPH was developed by Chris Groer (cgroer@gmail.com).  //
+//                                                        //
+// (c) Copyright 2010 Chris Groer.                        //
+// All Rights Reserved.  VRPH is licensed under the       //
+// Common Public License.  See LICENSE file for details.  //
+//                                                        //
+////////////////////////////////////////////////////////////
+
+#ifndef _VRP_MOVE_QUEUE_H
+#define _VRP_MOVE_QUEUE_H
+
+class VRPMoveQueue
+{
+    // Static move descriptors for best-improvement local search.  The savings
+    // of the best move of one operator for each node are kept in an indexed
+    // binary heap.  After a move is made only the descriptors of nodes on the
+    // changed routes, or with a neighbor on them, are recomputed.
+public:
+    VRPMoveQueue();
+    VRPMoveQueue(int n);
+
+    // Destructor
+    ~VRPMoveQueue();
+
+    int search(class VRP *V, int heuristic, int rules);
+
+private:
+    int max_size;
+
+    // Heap of the nodes that have an improving move, ordered by savings
+    int heap_size;
+    int *heap;
+    int *heap_pos;        // Position of each node in heap[], -1 if absent
+    double *savings;
+
+    // Nodes whose descriptors must be recomputed
+    int num_dirty;
+    int *dirty;
+    bool *is_dirty;
+
+    // rev_list[rev_start[k]],...,rev_list[rev_start[k+1]-1] are the nodes
+    // that have k in their neighbor list
+    int *rev_start;
+    int *rev_list;
+    int num_depot_nbrs;
+    int *depot_nbrs;    // Nodes with the VRPH_DEPOT in their neighbor list
+
+    void build_reverse_lists(class VRP *V);
+    bool evaluate(class VRP *V, int j, int heuristic, int rules);
+    bool make_move(class VRP *V, int j, int heuristic, int rules);
+    void mark_dirty(int j);
+    void set_key(int j, double s);
+    void remove(int j);
+    void sift_up(int p);
+    void sift_down(int p);
+};
+
+#endif
+
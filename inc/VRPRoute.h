@@ -41,6 +41,9 @@ public:
 	int num_customers;
 	double obj_val;
 
+	bool times_valid;	// false once the route changes; see VRP::update_route_times()
+	int version;		// Value of VRP::route_clock when the route last changed
+
 	int hash_val;
 	int hash_val2;
 	
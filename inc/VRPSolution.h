@@ -27,8 +27,9 @@ public:
 	bool in_IP;		// Flag to tell if the solution has been added to the IP before
 	double obj;		// objective function value
 	int n;			// # of non-DEPOT nodes in the solution
-	int *sol;		// Place for a solution buffer
+	VRPIndex *sol;	// Place for a solution buffer
 	double time;	// time at which the solution was first discovered
+	VRPHash edge_hash;	// VRP::solution_hash of the solution
 	int hash(int salt);	
 
 };
@@ -50,6 +51,7 @@ public:
 	struct htable_entry* hash_table;
 
 	int add_sol(VRPSolution *new_sol, int start_index);
+	bool contains(VRPHash h, double obj);
 	bool liquidate();
 	void sort_sols();
 	void show();
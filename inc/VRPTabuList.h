@@ -24,13 +24,13 @@ public:
 	// Destructor
 	~VRPTabuList();
 
-	void update_list(VRPRoute *r);
+	void update_list(VRPHash h);
+	bool contains(VRPHash h);
 	int max_entries;
 	int num_entries;
 	int start_index;
-	int *hash_vals1;
-	int *hash_vals2;
-	// Circular buffer containing the hash values of the routes
+	VRPHash *hash_vals;
+	// Circular buffer containing the edge hashes of the routes
 	bool full;
 	// Set to true once we have num_entries elements in the list
 	void show();
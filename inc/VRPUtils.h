@@ -27,6 +27,12 @@
 #define SALT_1					0
 #define SALT_2					11
 
+// 64-bit hash of a set of edges - unsigned so that the sums wrap around
+typedef unsigned long long VRPHash;
+// Position in a hash table and the check value stored there
+#define VRPH_WH_HASH_1(h)		((int)(((h)>>32)&(HASH_TABLE_SIZE-1)))
+#define VRPH_WH_HASH_2(h)		((int)((h)&0x7FFFFFFF))
+
 struct htable_entry
 {
 	///
@@ -80,6 +86,7 @@ class VRPViolation
 public:
 	double length_violation;
 	int    capacity_violation;
+	double time_window_violation;
 };
 
 
@@ -102,6 +109,83 @@ public:
 	VRPNeighborhood(int n);
 };
 
+#define VRPH_NUM_BEST_INSERTIONS	3
+
+struct VRPBestInsertions
+{
+	///
+	/// The VRPH_NUM_BEST_INSERTIONS cheapest places to insert a
+	/// customer into a route, in increasing order of cost.  The
+	/// customer goes right after after[i], where VRPH_DEPOT means
+	/// the start of the route.  Unused entries have cost VRP_INFINITY.
+	///
+
+	double cost[VRPH_NUM_BEST_INSERTIONS];
+	int after[VRPH_NUM_BEST_INSERTIONS];
+};
+
+struct VRPRouteInsertions
+{
+	///
+	/// The cheapest insertions of customer j into route r
+	/// when the route had the given version.
+	///
+
+	int j;
+	int r;
+	int version;
+	struct VRPBestInsertions B;
+
+};
+
+struct VRPRouteMembers
+{
+	///
+	/// The customers of a route in the order it visits them
+	/// when the route had the given version.  members has
+	/// room for size customers.
+	///
+
+	int version;
+	int num_customers;
+	int size;
+	VRPIndex *members;
+
+};
+
+struct VRPPairSearch
+{
+	///
+	/// A search of routes r1 and r2 by one heuristic that
+	/// found no move, and the versions of the two routes
+	/// at the time.
+	///
+
+	int r1;
+	int r2;
+	int v1;
+	int v2;
+	int heuristic;
+	int rules;
+
+};
+
+struct VRPOptimalRoute
+{
+	///
+	/// A route known to be locally optimal under the intra-route
+	/// heuristics, identified by its two VRPRoute::hash values,
+	/// its first customer and its length.
+	///
+
+	int hash_val;
+	int hash_val2;
+	int start;
+	double length;
+	int heuristics;
+
+};
+
 struct VRPSegment
 {
 	/// 
@@ -118,6 +202,34 @@ struct VRPSegment
 
 };
 
+class VRPEdgeSet
+{
+	///
+	/// A set of undirected edges a-b kept in an open addressing
+	/// hash table that grows as edges are added.  Each used slot
+	/// holds the key of one edge, and 0 marks an empty slot.
+	///
+
+public:
+	VRPEdgeSet();
+	~VRPEdgeSet();
+
+	bool add(int a, int b);
+	bool remove(int a, int b);
+	bool contains(int a, int b);
+	bool get_edge(int k, int *a, int *b);
+	void clear();
+
+	int num_edges;
+	int size;
+
+private:
+	VRPHash *keys;
+	VRPHash key(int a, int b);
+	int find(VRPHash k);
+	void grow();
+};
+
 
 
 double VRPDistance(int type, double x1, double y1, double x2, double y2);
@@ -132,6 +244,7 @@ int VRPSolutionCompare(const void *a, const void *b);
 int VRPCheckTSPLIBString(char *s);
 int VRPGetDimension(char *filename);
 int VRPGetNumDays(char *filename);
+VRPHash VRPHashMix(VRPHash x);
 
 
 #endif
@@ -133,10 +133,12 @@ bool ClarkeWright::Construct(VRP *V, double lambda, bool use_neighbor_list)
     unsigned char *status;
     double savings;    
     int i_route, j_route;
+    bool merge;
 
     Postsert postsert;
     Presert presert;
     Concatenate concatenate;
+    VRPMove M;
 
     n= V->num_nodes;    // # of non-VRPH_DEPOT nodes.
     num_routes=n;
@@ -247,6 +249,8 @@ bool ClarkeWright::Construct(VRP *V, double lambda, bool use_neighbor_list)
 
         case 0:
             // both i and j VRPH_UNUSED - merge the two routes making 1-i-j-1
+            if(V->has_time_windows && !(postsert.evaluate(V,j,i,&M) && V->is_feasible(&M,0)))
+                break;
             if(postsert.move(V,j,i)==true)
             {
                 status[i]=VRPH_ADDED;
@@ -262,6 +266,8 @@ bool ClarkeWright::Construct(VRP *V, double lambda, bool use_neighbor_list)
             if(V->next_array[i]>0)
             {
                 // i is the first node in its route
+                if(V->has_time_windows && !(presert.evaluate(V,j,i,&M) && V->is_feasible(&M,0)))
+                    break;
                 if(presert.move(V,j,i)==true)
                 {
                     status[i]=VRPH_INTERIOR;
@@ -272,7 +278,8 @@ bool ClarkeWright::Construct(VRP *V, double lambda, bool use_neighbor_list)
             else
             {
                 // i is the last node in its route
-
+                if(V->has_time_windows && !(postsert.evaluate(V,j,i,&M) && V->is_feasible(&M,0)))
+                    break;
                 if(postsert.move(V,j,i)==true)
                 {
                     status[i]=VRPH_INTERIOR;
@@ -289,6 +296,8 @@ bool ClarkeWright::Construct(VRP *V, double lambda, bool use_neighbor_list)
             if(V->next_array[j]>0)
             {
                 // j is 2nd in its route
+                if(V->has_time_windows && !(presert.evaluate(V,i,j,&M) && V->is_feasible(&M,0)))
+                    break;
                 if(presert.move(V,i,j)==true)
                 {
                     status[j]=VRPH_INTERIOR;
@@ -299,6 +308,8 @@ bool ClarkeWright::Construct(VRP *V, double lambda, bool use_neighbor_list)
             else
             {
                 // j is -2nd in its route
+                if(V->has_time_windows && !(postsert.evaluate(V,i,j,&M) && V->is_feasible(&M,0)))
+                    break;
                 if(postsert.move(V,i,j)==true)
                 {
                     status[j]=VRPH_INTERIOR;
@@ -318,6 +329,21 @@ bool ClarkeWright::Construct(VRP *V, double lambda, bool use_neighbor_list)
             if( V->route_num[i] == V->route_num[j] )
                 break;    
 
+            // With time windows the routes keep their direction, so they are
+            // only merged if the end of one is joined to the start of the other
+            if(V->has_time_windows)
+            {
+                merge=false;
+                if(V->next_array[i]>0 && V->next_array[j]<=0)
+                    merge=concatenate.evaluate(V,V->route_num[i],V->route_num[j],0,&M) && 
+                        V->is_feasible(&M,0);
+                else if(V->next_array[j]>0 && V->next_array[i]<=0)
+                    merge=concatenate.evaluate(V,V->route_num[j],V->route_num[i],0,&M) && 
+                        V->is_feasible(&M,0);
+                if(!merge)
+                    break;
+            }
+
             // Now we will rearrange the routes containing both i and j if necessary
             // so that i is the first node and j is the last node in their routes.
             // This will be done by a route reversal if necessary.
@@ -406,9 +432,6 @@ bool ClarkeWright::Construct(VRP *V, double lambda, bool use_neighbor_list)
     // Set the record
     V->record = V->total_route_length;
 
-    // Normalize the route numbers!
-    V->normalize_route_numbers();
-
 #if CW_DEBUG
     printf("Done normalizing\n");
 #endif
@@ -0,0 +1,359 @@
+////////////////////////////////////////////////////////////
+//                                                        //
+// This file is part of the VRPH software package for     //
+// generating solutions to vehicle routing problems.      //
+// VRPH was developed by Chris Groer (cgroer@gmail.com).  //
+//                                                        //
+// (c) Copyright 2010 Chris Groer.                        //
+// All Rights Reserved.  VRPH is licensed under the       //
+// Common Public License.  See LICENSE file for details.  //
+//                                                        //
+////////////////////////////////////////////////////////////
+
+#include "VRPH.h"
+
+bool CompositeSearch::search(class VRP *V, int j, int heuristics, int rules)
+{
+    ///
+    /// Searches the neighborhood of node j once, trying every operator in
+    /// heuristics (ONE_POINT_MOVE, TWO_POINT_MOVE, TWO_OPT and OR_OPT) with
+    /// each candidate k.  The neighbors of j and k and the distances between
+    /// them are loaded a single time and shared by the operators, and each
+    /// move is screened on these distances before it is evaluated.  Makes
+    /// the first or best acceptable move over all of the operators and
+    /// returns true, or returns false if there is none.
+    ///
+
+    VRPMove M;
+    int i,ii,k,h,l,s,e,orient,num_orients;
+    double limit,jk,hk,kl;
+    bool found;
+
+    if(j==VRPH_DEPOT || !V->routed[j])
+        return false;
+
+    this->rules=rules;
+    this->heuristics=heuristics;
+
+    //default setting
+    this->accept_type=VRPH_FIRST_ACCEPT;
+
+    if( (rules & VRPH_FIRST_ACCEPT) > 0)
+        this->accept_type=VRPH_FIRST_ACCEPT;
+    if( (rules & VRPH_BEST_ACCEPT) > 0)
+        this->accept_type=VRPH_BEST_ACCEPT;
+    if( (rules & VRPH_LI_ACCEPT) > 0)
+        this->accept_type=VRPH_LI_ACCEPT;
+
+    this->BestM.savings=VRP_INFINITY;
+    this->best_heuristic=0;
+
+    this->load(V,j,heuristics,rules);
+    if(!this->do_opm && !this->do_tpm && !this->do_to && !this->do_or)
+        return false;
+
+    num_orients=1;
+    if(V->symmetric)
+        num_orients=2;
+
+    // Create the search_space
+    V->create_search_neighborhood(j, rules);
+
+    // Undoing a tabu move can leave the routes reversed, so moves are only
+    // screened when the solution is not changed during the search
+    limit=VRP_INFINITY;
+    if(!(rules & VRPH_TABU))
+        limit=V->savings_limit(rules);
+    else
+    {
+        // Record the changes made from here on so that a tabu move
+        // can be undone
+        V->start_journal();
+    }
+
+    found=false;
+
+    for(ii=0;ii<V->search_size;ii++)
+    {
+        k=V->search_space[ii];
+        if(k==j)
+            continue;
+        this->reverted=false;
+
+        if(k==VRPH_DEPOT)
+        {
+            // The VRPH_DEPOT stands for the ends of every route
+            if(this->do_opm)
+            {
+                M.savings=VRP_INFINITY;
+                if(this->OPM.evaluate(V,j,VRPH_DEPOT,rules,&M) &&
+                    this->consider(V,ONE_POINT_MOVE,&M))
+                {
+                    found=true;
+                    goto done;
+                }
+            }
+
+            if(this->do_to && V->d[j][VRPH_DEPOT]<this->max_gain)
+            {
+                s=abs(V->next_array[VRPH_DEPOT]);
+                while(s!=VRPH_DEPOT)
+                {
+                    e=V->route[V->route_num[s]].end;
+                    for(i=0;i<4 && !this->reverted;i++)
+                    {
+                        M.savings=VRP_INFINITY;
+                        if( (i==0 && this->TO.evaluate(V,this->t,j,VRPH_DEPOT,s,rules,&M)) ||
+                            (i==1 && this->TO.evaluate(V,j,this->v,VRPH_DEPOT,s,rules,&M)) ||
+                            (i==2 && this->TO.evaluate(V,this->t,j,e,VRPH_DEPOT,rules,&M)) ||
+                            (i==3 && this->TO.evaluate(V,j,this->v,e,VRPH_DEPOT,rules,&M)) )
+                        {
+                            if(this->consider(V,TWO_OPT,&M))
+                            {
+                                found=true;
+                                goto done;
+                            }
+                        }
+                    }
+                    if(this->reverted)
+                        // The routes may have been reversed - stop walking them
+                        break;
+                    s=abs(V->next_array[e]);
+                }
+            }
+            continue;
+        }
+
+        if(!V->routed[k])
+            continue;
+
+        // Load everything the operators need about k
+        h=VRPH_MAX(V->pred_array[k],VRPH_DEPOT);
+        l=VRPH_MAX(V->next_array[k],VRPH_DEPOT);
+        jk=V->d[j][k];
+        hk=V->d[h][k];
+        kl=V->d[k][l];
+
+        if(this->do_opm)
+        {
+            // j between h and k or between k and l
+            if(this->opm_removal+VRPH_MIN(V->d[h][j]+V->d[j][k]-hk,
+                jk+V->d[j][l]-kl)<=limit)
+            {
+                M.savings=VRP_INFINITY;
+                if(this->OPM.evaluate(V,j,k,rules,&M) && this->consider(V,ONE_POINT_MOVE,&M))
+                {
+                    found=true;
+                    goto done;
+                }
+                if(this->reverted)
+                    continue;
+            }
+        }
+
+        if(this->do_tpm)
+        {
+            // t-j-v and h-k-l become t-k-v and h-j-l.  Nodes adjacent to
+            // j share an edge with it and are always evaluated.
+            if(k==this->t || k==this->v ||
+                (V->d[this->t][k]+V->d[k][this->v]+V->d[h][j]+V->d[j][l]) -
+                (this->tj+this->jv+hk+kl)<=limit)
+            {
+                M.savings=VRP_INFINITY;
+                if(this->TPM.evaluate(V,j,k,rules,&M) && this->consider(V,TWO_POINT_MOVE,&M))
+                {
+                    found=true;
+                    goto done;
+                }
+                if(this->reverted)
+                    continue;
+            }
+        }
+
+        if(this->do_to && jk<this->max_gain)
+        {
+            // The four ways of removing one of the edges t-j, j-v and one
+            // of the edges h-k, k-l
+            for(i=0;i<4 && !this->reverted;i++)
+            {
+                M.savings=VRP_INFINITY;
+                if( (i==0 && this->TO.evaluate(V,this->t,j,h,k,rules,&M)) ||
+                    (i==1 && this->TO.evaluate(V,this->t,j,k,l,rules,&M)) ||
+                    (i==2 && this->TO.evaluate(V,j,this->v,h,k,rules,&M)) ||
+                    (i==3 && this->TO.evaluate(V,j,this->v,k,l,rules,&M)) )
+                {
+                    if(this->consider(V,TWO_OPT,&M))
+                    {
+                        found=true;
+                        goto done;
+                    }
+                }
+            }
+            if(this->reverted)
+                continue;
+        }
+
+        if(this->do_or && k!=this->t && k!=this->v && l!=VRPH_DEPOT)
+        {
+            // The string j-v between k and l, in both orientations when
+            // the problem is symmetric
+            for(orient=0;orient<num_orients && !this->reverted;orient++)
+            {
+                if(orient==0)
+                {
+                    if(jk+V->d[this->v][l]-kl-this->or_removal>limit)
+                        continue;
+                }
+                else
+                {
+                    if(V->d[k][this->v]+V->d[j][l]-kl-this->or_removal>limit)
+                        continue;
+                }
+
+                if(this->OR.evaluate(V,j,2,k,l,(orient==1),rules,&M) &&
+                    this->consider(V,OR_OPT,&M))
+                {
+                    found=true;
+                    goto done;
+                }
+            }
+        }
+    }
+
+    if(this->accept_type==VRPH_FIRST_ACCEPT || this->BestM.savings==VRP_INFINITY)
+        // No moves found
+        goto done;
+
+    if(rules & VRPH_EVALUATE_ONLY)
+    {
+        // Report the best move without making it
+        V->best_savings=this->BestM.savings;
+        found=true;
+        goto done;
+    }
+
+    if(this->move(V,this->best_heuristic,&this->BestM)==false)
+        report_error("%s: best move evaluates to false\n",__FUNCTION__);
+
+    // Check VRPH_TABU status of move - if it is not ok
+    // then we reverted back - search over
+    if(!(rules & VRPH_TABU) || V->check_tabu_status(&this->BestM))
+        found=true;
+
+done:
+    if(rules & VRPH_TABU)
+        V->stop_journal();
+
+    return found;
+
+}
+
+void CompositeSearch::load(class VRP *V, int j, int heuristics, int rules)
+{
+    ///
+    /// Loads the neighbors t-j-v-w of j and the parts of the savings that
+    /// are the same for every candidate, and decides which operators can
+    /// move j at all.
+    ///
+
+    this->j=j;
+    this->t=VRPH_MAX(V->pred_array[j],VRPH_DEPOT);
+    this->v=VRPH_MAX(V->next_array[j],VRPH_DEPOT);
+    this->w=VRPH_DEPOT;
+    if(this->v!=VRPH_DEPOT)
+        this->w=VRPH_MAX(V->next_array[this->v],VRPH_DEPOT);
+
+    this->tj=V->d[this->t][j];
+    this->jv=V->d[j][this->v];
+
+    // The change from taking out j and from taking out the string j-v
+    this->opm_removal=V->d[this->t][this->v]-this->tj-this->jv;
+    this->or_removal=this->tj+V->d[this->v][this->w]-V->d[this->t][this->w];
+
+    this->do_opm=(heuristics & ONE_POINT_MOVE) &&
+        V->route[V->route_num[j]].num_customers>3;
+    this->do_tpm=(heuristics & TWO_POINT_MOVE)!=0;
+    this->do_to=(heuristics & TWO_OPT)!=0;
+    this->do_or=(heuristics & OR_OPT) && this->v!=VRPH_DEPOT;
+
+    if(rules & VRPH_FIXED_EDGES)
+    {
+        // Make sure we aren't disturbing fixed edges
+        if(V->is_fixed(this->t,j) || V->is_fixed(j,this->v))
+            this->do_opm=this->do_tpm=false;
+        if(V->is_fixed(this->t,j) && V->is_fixed(j,this->v))
+            this->do_to=false;
+        if(V->is_fixed(this->t,j) || (this->v!=VRPH_DEPOT && V->is_fixed(this->v,this->w)))
+            this->do_or=false;
+    }
+
+    // Lin-Kernighan gain criterion for downhill searches as in TwoOpt::search
+    this->max_gain=VRP_INFINITY;
+    if( (rules & VRPH_DOWNHILL) && !(rules & (VRPH_RECORD_TO_RECORD |
+        VRPH_SIMULATED_ANNEALING | VRPH_MINIMIZE_NUM_ROUTES)) )
+        this->max_gain=VRPH_MAX(this->tj,this->jv);
+
+}
+
+bool CompositeSearch::consider(class VRP *V, int heuristic, VRPMove *M)
+{
+    ///
+    /// Handles the feasible move M found by heuristic.  Makes it and returns
+    /// true if it is to be accepted right away, and otherwise stores it if
+    /// it is the best so far and returns false.  If a tabu move is made and
+    /// undone, the neighbors of j are loaded again since the routes may
+    /// have been reversed, and reverted is set so that the search moves on
+    /// to the next candidate.
+    ///
+
+    if(this->accept_type==VRPH_FIRST_ACCEPT ||
+        (this->accept_type==VRPH_LI_ACCEPT && M->savings<-VRPH_EPSILON))
+    {
+        if(this->move(V,heuristic,M)==false)
+            report_error("%s: move error\n",__FUNCTION__);
+
+        // Check VRPH_TABU status of move - if it is not ok then
+        // we reverted back - continue the search for a move
+        if(!(this->rules & VRPH_TABU) || V->check_tabu_status(M))
+            return true;
+
+        this->reverted=true;
+        this->load(V,this->j,this->heuristics,this->rules);
+        return false;
+    }
+
+    if(M->is_better(V, &this->BestM, this->rules))
+    {
+        this->BestM=*M;
+        this->best_heuristic=heuristic;
+    }
+
+    return false;
+
+}
+
+bool CompositeSearch::move(class VRP *V, int heuristic, VRPMove *M)
+{
+    ///
+    /// Makes the move M found by heuristic.  The TwoOpt and OrOpt moves are
+    /// made from the eval_arguments of M, so M must be the VRPMove that
+    /// their evaluate filled in.
+    ///
+
+    switch(heuristic)
+    {
+    case ONE_POINT_MOVE:
+        return this->OPM.move(V,M);
+    case TWO_POINT_MOVE:
+        return this->TPM.move(V,M);
+    case TWO_OPT:
+        return this->TO.move(V,M);
+    case OR_OPT:
+        return this->OR.move(V,M);
+    }
+
+    report_error("%s: unsupported heuristic\n",__FUNCTION__);
+    return false;
+
+}
+
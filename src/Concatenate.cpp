@@ -137,23 +137,26 @@ bool Concatenate::move(VRP *V, int i_route, int j_route)
     // becomes
     // 1-aa-bb-...-zz-j-i-a-b-c-...-x-1
 
-    V->next_array[j]=i;
-    V->pred_array[i]=j;
+    V->set_next(j,i);
+    V->set_pred(i,j);
 
     if(VRPH_ABS(route_after_j)==i)
     {
         current_node=start_j;
         while( (next_node= V->next_array[current_node]) > 0)
         {
-            V->route_num[current_node]=i_route;
+            V->set_route_num(current_node,i_route);
 
             current_node=next_node;
         }
 
-        V->route_num[current_node]=i_route;
+        V->set_route_num(current_node,i_route);
         // Update i_route information
         V->route[i_route].end=end_i;
         V->route[i_route].start=start_j;
+
+        // j_route is now empty - recycle its id
+        V->reclaim_routes();
         
 #if CONCATENATE_VERIFY
         V->verify_routes("Concatenate 1\n");
@@ -164,20 +167,20 @@ bool Concatenate::move(VRP *V, int i_route, int j_route)
 
     if(VRPH_ABS(route_after_i)!=start_j)
     {
-        V->next_array[VRPH_ABS(route_before_i)]=route_after_i;
-        V->pred_array[VRPH_ABS(route_after_i)]=route_before_i;
-        V->next_array[VRPH_ABS(end_i)]=route_after_j;
-        V->pred_array[VRPH_ABS(route_after_j)]=-end_i;
+        V->set_next(VRPH_ABS(route_before_i),route_after_i);
+        V->set_pred(VRPH_ABS(route_after_i),route_before_i);
+        V->set_next(VRPH_ABS(end_i),route_after_j);
+        V->set_pred(VRPH_ABS(route_after_j),-end_i);
     }
     else
     {
         // Must have i in first position of its route
         // j is the very next route with j in last position
-        V->next_array[VRPH_ABS(route_before_i)]=-start_j;
-        V->pred_array[VRPH_ABS(start_j)]=route_before_i;
-        V->next_array[VRPH_ABS(end_i)]=post_j;
+        V->set_next(VRPH_ABS(route_before_i),-start_j);
+        V->set_pred(VRPH_ABS(start_j),route_before_i);
+        V->set_next(VRPH_ABS(end_i),post_j);
         // changed!
-        V->pred_array[VRPH_ABS(post_j)]=-end_i;
+        V->set_pred(VRPH_ABS(post_j),-end_i);
     }
 
     // So new start is start(j) and new end is end(i)
@@ -185,16 +188,17 @@ bool Concatenate::move(VRP *V, int i_route, int j_route)
     current_node=start_j;
     while( (next_node= V->next_array[current_node]) > 0)
     {
-        V->route_num[current_node]=i_route;
+        V->set_route_num(current_node,i_route);
         current_node=next_node;
     }
 
-    V->route_num[current_node]=i_route;
+    V->set_route_num(current_node,i_route);
     // Update route information
     V->route[i_route].end=end_i;
     V->route[i_route].start=start_j;
-    
 
+    // j_route is now empty - recycle its id
+    V->reclaim_routes();
     
 #if CONCATENATE_VERIFY
     V->verify_routes("CWConcatenate 2\n");
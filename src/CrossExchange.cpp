@@ -14,11 +14,27 @@
 
 
 bool CrossExchange::route_search(class VRP *V, int r1, int r2, int rules)
+{
+    ///
+    /// Attempts to find a cross exchange move between routes r1 and r2
+    /// with no limit on the length of the exchanged segments.
+    ///
+
+    return route_search(V,r1,r2,V->num_original_nodes,rules);
+
+}
+
+bool CrossExchange::route_search(class VRP *V, int r1, int r2, int max_len, int rules)
 {
     ///
     /// Attempts to find a cross exchange move between routes r1 and r2.
     /// Edges i1-i2 and k1-k2 in route r1, 
-    /// and edges j1-j2 and l1-l2 in route r2.
+    /// and edges j1-j2 and l1-l2 in route r2.  The exchanged segments
+    /// i2...k1 and j2...l1 have at most max_len customers, and a pair of
+    /// segments is only evaluated if the new loads of both routes are
+    /// feasible.  With VRPH_USE_NEIGHBOR_LIST, on routes long enough for it
+    /// to pay off, each of the new edge pairs i1-j2, j1-i2 and k1-l2, l1-k2
+    /// must contain a neighbor list edge.
     ///
 
     // Make sure we have two diff. routes!
@@ -29,10 +45,10 @@ bool CrossExchange::route_search(class VRP *V, int r1, int r2, int rules)
     printf("Evaluating CE move b/w routes %d and %d\n",r1,r2);
 #endif
 
-
-    int start_1, end_1, start_2, end_2;
-    int i1, i2, k1, k2; // Route r1 nodes
-    int j1, j2, l1, l2;    // Route r2 nodes
+    int L1, L2, pi, pk, pj, pl, p, q, x, y, h, new_load;
+    int *seq1, *seq2, *load1, *load2, *pos;
+    bool *close;
+    bool nlist, found;
 
     VRPMove M, BestM;
 
@@ -50,191 +66,193 @@ bool CrossExchange::route_search(class VRP *V, int r1, int r2, int rules)
     if( (rules & VRPH_BEST_ACCEPT) == VRPH_BEST_ACCEPT)
         accept_type = VRPH_BEST_ACCEPT;
 
-    // Use current_1a/b and next_1a/b for route r1 and current_2a/b and next_2a/b for route r2
     if(V->route[r1].num_customers < 4 || V->route[r2].num_customers < 4)
         // Not possible to find a CE move
         return false;
 
-    int *old_sol=NULL;
-    if(rules & VRPH_TABU)
-    {
-        // Remember the original solution 
-        old_sol=new int[V->num_original_nodes+2];
-        V->export_solution_buff(old_sol);
-    }
-
-    // Get route starts and ends
-
-    start_1= V->route[r1].start;
-    end_1= V->route[r1].end;
-
-    int end_i=V->pred_array[end_1];
-
+    // Skip the search if it failed before and neither route has changed
+    if(V->pair_searched(r1,r2,CROSS_EXCHANGE+max_len,rules))
+        return false;
 
-    start_2= V->route[r2].start;
-    end_2= V->route[r2].end;
+    L1=V->route[r1].num_customers;
+    L2=V->route[r2].num_customers;
 
-    int end_j=V->pred_array[end_2];
+    // Building the neighbor list filter costs about 2*neighbor_list_size*(L1+L2),
+    // so it is only used when there are more segment pairs than that
+    nlist=false;
+    if(rules & VRPH_USE_NEIGHBOR_LIST)
+    {
+        x=L1*VRPH_MIN(L1,max_len);
+        y=L2*VRPH_MIN(L2,max_len);
+        if((double)x*y > 2.0*V->neighbor_list_size*(L1+L2))
+            nlist=true;
+    }
 
-    i1 = start_1; // don't allow VRPH_DEPOT edges for now...
-    i2 = V->next_array[i1];
+    // seq1[p] is the customer in position p of route r1, starting at 1, and 
+    // load1[p] is the load of the first p customers.  Likewise for route r2.
+    seq1=new int[2*(L1+2)+2*(L2+2)+V->num_original_nodes+2];
+    seq2=seq1+(L1+2);
+    load1=seq2+(L2+2);
+    load2=load1+(L1+2);
+    pos=load2+(L2+2);
+    close=NULL;
+
+    seq1[0]=seq1[L1+1]=VRPH_DEPOT;
+    load1[0]=0;
+    x=V->route[r1].start;
+    for(p=1;p<=L1;p++)
+    {
+        seq1[p]=x;
+        pos[x]=p;
+        load1[p]=load1[p-1]+V->demand_array[x];
+        x=VRPH_MAX(V->next_array[x],0);
+    }
 
-    while(i2 != end_i)
+    seq2[0]=seq2[L2+1]=VRPH_DEPOT;
+    load2[0]=0;
+    x=V->route[r2].start;
+    for(q=1;q<=L2;q++)
     {
-        // First edge in route 1 is i1-i2
+        seq2[q]=x;
+        pos[x]=q;
+        load2[q]=load2[q-1]+V->demand_array[x];
+        x=VRPH_MAX(V->next_array[x],0);
+    }
 
-        // Now find the second edge in route r1
-        k1 = V->next_array[i2];
+    if(nlist)
+    {
+        // close[p*(L2+1)+q] is true if replacing edges p in r1 and q in r2 
+        // (edge p joins positions p and p+1) adds a neighbor list edge
+        close=new bool[(L1+1)*(L2+1)];
+        memset(close,0,(L1+1)*(L2+1)*sizeof(bool));
+        for(p=1;p<=L1;p++)
+        {
+            x=seq1[p];
+            for(h=0;h<V->neighbor_list_size;h++)
+            {
+                y=V->nodes[x].neighbor_list[h].position;
+                if(y==VRPH_DEPOT || !V->routed[y] || V->route_num[y]!=r2)
+                    continue;
+                // x-y is either i1-j2 or i2-j1
+                close[p*(L2+1)+pos[y]-1]=true;
+                close[(p-1)*(L2+1)+pos[y]]=true;
+            }
+        }
+        for(q=1;q<=L2;q++)
+        {
+            y=seq2[q];
+            for(h=0;h<V->neighbor_list_size;h++)
+            {
+                x=V->nodes[y].neighbor_list[h].position;
+                if(x==VRPH_DEPOT || !V->routed[x] || V->route_num[x]!=r1)
+                    continue;
+                // y-x is either j1-i2 or j2-i1
+                close[(pos[x]-1)*(L2+1)+q]=true;
+                close[pos[x]*(L2+1)+q-1]=true;
+            }
+        }
+    }
 
+    if(rules & VRPH_TABU)
+    {
+        // Record the changes made from here on so that a tabu move
+        // can be undone
+        V->start_journal();
+    }
 
-        if(k1==end_1)
-            break;    // VRPH_DEPOT edge not allowed
+    found=false;
 
-        k2 = V->next_array[k1];
-        while(k2 != end_1)
+    // VRPH_DEPOT edges are not allowed, and each segment has at least two customers
+    for(pi=1;pi<=L1-3;pi++)
+    {
+        for(pj=1;pj<=L2-3;pj++)
         {
-            // Second edge in route 1 is k1-k2
-
-            // Now find edges in the second route
+            if(nlist && !close[pi*(L2+1)+pj])
+                continue;
 
-            j1 = start_2; 
-            j2 = V->next_array[j1];
-
-            while(j2 != end_j)
+            for(pk=pi+2;pk<=L1-2 && pk-pi<=max_len;pk++)
             {
+                for(pl=pj+2;pl<=L2-2 && pl-pj<=max_len;pl++)
+                {
+                    if(nlist && !close[pk*(L2+1)+pl])
+                        continue;
 
-                // First edge in route 2 is j1-j2
-
-                // Now find the second edge in route r2: l1-l2
-                l1 = V->next_array[j2];
-
-                if(l1==end_2)
-                    break;
-
-                l2 = V->next_array[l1];
+                    // Reject on load before anything else
+                    new_load=V->route[r1].load-(load1[pk]-load1[pi])+(load2[pl]-load2[pj]);
+                    if(new_load>V->max_veh_capacity)
+                        continue;
+                    new_load=V->route[r1].load+V->route[r2].load-new_load;
+                    if(new_load>V->max_veh_capacity)
+                        continue;
 
-                while(l2 != end_2)
-                {
                     // Now evaluate the cross exchange move involving
                     // i1-i2, k1-k2, and
                     // j1-j2, l1-l2
 
-                    if(this->evaluate(V,i1,i2,k1,k2,j1,j2,l1,l2,rules,&M) == true)
-                    {
+                    if(this->evaluate(V,seq1[pi],seq1[pi+1],seq1[pk],seq1[pk+1],
+                        seq2[pj],seq2[pj+1],seq2[pl],seq2[pl+1],rules,&M) == false)
+                        continue;
 
-                        // We have found a valid move.
-                        if(accept_type == VRPH_FIRST_ACCEPT || (accept_type==VRPH_LI_ACCEPT && M.savings<-VRPH_EPSILON) )
-                        {
-                            // Make the move
-
-                            if(move(V, &M)==false)
-                                report_error("%s: move error 1\n");
-                            else
-                            {
-                                if(!(rules & VRPH_TABU))
-                                    return true;
-                                else
-                                {
-                                    // Check VRPH_TABU status of move - return true if its ok
-                                    // or revert to old_sol if not and continue to search.
-                                    if(V->check_tabu_status(&M, old_sol))
-                                    {
-                                        delete [] old_sol;
-                                        return true; // The move was ok
-                                    }
-                                    // else we reverted back - continue the search for a move
-                                }
-                            }
-                        }
+                    // We have found a valid move.
+                    if(accept_type == VRPH_FIRST_ACCEPT || (accept_type==VRPH_LI_ACCEPT && M.savings<-VRPH_EPSILON) )
+                    {
+                        // Make the move
 
+                        if(move(V, &M)==false)
+                            report_error("%s: move error 1\n",__FUNCTION__);
 
-                        if(accept_type == VRPH_LI_ACCEPT || accept_type == VRPH_BEST_ACCEPT)
+                        // Check VRPH_TABU status of move - if it is not ok then
+                        // we reverted back - continue the search for a move
+                        if(!(rules & VRPH_TABU) || V->check_tabu_status(&M))
                         {
-                            // Check for new best move
-                            if(M.is_better(V, &BestM, rules))
-                                BestM=M;
-
+                            found=true;
+                            goto done;
                         }
-
                     }
 
-                    // Now advance the second edge in route r2
-
-                    l1 = l2;
-                    l2 = V->next_array[l1];
+                    if(accept_type == VRPH_LI_ACCEPT || accept_type == VRPH_BEST_ACCEPT)
+                    {
+                        // Check for new best move
+                        if(M.is_better(V, &BestM, rules))
+                            BestM=M;
 
+                    }
                 }
-                // end route r2 edge 2 loop
-
-                // Now advance the first edge in route r2
-
-                j1 = j2;
-                j2= V->next_array[j1];
-
             }
-            // end route r2 edge 1 loop
-
-            // Now advance the second edge in route r1
-            k1 = k2;
-            k2 = V->next_array[k1];
-
         }
-        // end route r1 edge 2 loop
-
-        // Now advance the first edge in route r1
-
-        i1 = i2;
-        i2 = V->next_array[i1];
-
     }
 
 #if CROSS_EXCHANGE_DEBUG > 1
     printf("END OF LOOP: %f\n",BestM.savings);
 #endif
-    if(BestM.savings == VRP_INFINITY || accept_type == VRPH_FIRST_ACCEPT)
-        return false;
 
     if(accept_type==VRPH_FIRST_ACCEPT || BestM.savings==VRP_INFINITY)
     {
-        if(rules&VRPH_TABU)
-            delete [] old_sol;
-        return false;        // No moves found
-    }    
+        // No moves found
+        V->pair_search_failed(r1,r2,CROSS_EXCHANGE+max_len,rules);
+        goto done;
+    }
 
-    if(accept_type==VRPH_BEST_ACCEPT || accept_type==VRPH_LI_ACCEPT)
-    {
-        if(move(V,&BestM)==false)
-        {
-            report_error("%s: best move evaluates to false\n");
-        }
-        else
-        {
-            if(!(rules & VRPH_TABU))
-                return true;
-            else
-            {
-                // Check VRPH_TABU status of move - return true if its ok
-                // or revert to old_sol if not and continue to search.
-                if(V->check_tabu_status(&BestM, old_sol))
-                {
-                    delete [] old_sol;
-                    return true; // The move was ok
-                }
-                // else we reverted back - search over
-                delete [] old_sol;
-                return false;
+    if(move(V,&BestM)==false)
+        report_error("%s: best move evaluates to false\n",__FUNCTION__);
 
-            }
-        }
-    }
+    // Check VRPH_TABU status of move - if it is not ok
+    // then we reverted back - search over
+    if(!(rules & VRPH_TABU) || V->check_tabu_status(&BestM))
+        found=true;
 
-    report_error("%s: should have returned already...\n",__FUNCTION__);
-    return false;
-}
+done:
+    if(rules & VRPH_TABU)
+        V->stop_journal();
 
+    // The other arrays share this allocation
+    delete [] seq1;
+    if(close)
+        delete [] close;
 
+    return found;
+}
 
-// EVALUATE
 bool CrossExchange::evaluate(class VRP *V, int i1, int i2, int k1, int k2, int j1, int j2, int l1, int l2,
                              int rules, VRPMove *M)
 {
@@ -352,6 +370,7 @@ bool CrossExchange::evaluate(class VRP *V, int i1, int i2, int k1, int k2, int j
     M->route_loads[1]=new_j_load;
     M->savings=savings;
     M->new_total_route_length= V->total_route_length+savings;
+    M->move_type=CROSS_EXCHANGE;
     M->num_arguments=9;
     M->move_arguments[0]=i1; M->move_arguments[1]=i2; M->move_arguments[2]=k1; M->move_arguments[3]=k2;
     M->move_arguments[4]=j1; M->move_arguments[5]=j2; M->move_arguments[6]=l1; M->move_arguments[7]=l2;
@@ -391,17 +410,21 @@ bool CrossExchange::move(class VRP *V, VRPMove *M)
     V->show_route(V->route_num[j1]);
 #endif
 
-    V->next_array[j1]=i2;
-    V->pred_array[i2]=j1;
+    // The route ends are modified before V->update() is called
+    V->journal_route_info(M->route_nums[0]);
+    V->journal_route_info(M->route_nums[1]);
+
+    V->set_next(j1,i2);
+    V->set_pred(i2,j1);
 
-    V->next_array[k1]=l2;
-    V->pred_array[l2]=k1;
+    V->set_next(k1,l2);
+    V->set_pred(l2,k1);
 
-    V->next_array[i1]=j2;
-    V->pred_array[j2]=i1;
+    V->set_next(i1,j2);
+    V->set_pred(j2,i1);
 
-    V->next_array[l1]=k2;
-    V->pred_array[k2]=l1;
+    V->set_next(l1,k2);
+    V->set_pred(k2,l1);
 
 
 
@@ -413,7 +436,7 @@ bool CrossExchange::move(class VRP *V, VRPMove *M)
     while(current_node!=VRPH_DEPOT)
     {
         V->route[M->route_nums[0]].end=current_node;        
-        V->route_num[current_node] = M->route_nums[0];
+        V->set_route_num(current_node,M->route_nums[0]);
         current_node= VRPH_MAX(VRPH_DEPOT,V->next_array[current_node]);
     }
 
@@ -422,7 +445,7 @@ bool CrossExchange::move(class VRP *V, VRPMove *M)
     while(current_node!=VRPH_DEPOT)
     {
         V->route[M->route_nums[1]].end=current_node;        
-        V->route_num[current_node] = M->route_nums[1];
+        V->set_route_num(current_node,M->route_nums[1]);
         current_node= VRPH_MAX(VRPH_DEPOT, V->next_array[current_node]);
     }
 
@@ -55,10 +55,10 @@ bool Flip::evaluate(class VRP *V, int start_point, int end_point, VRPMove *M)
 
     // Need to compute the old costs and the new cost - 
 
-    old_cost=(V->d[start_point][post_start]-1*V->nodes[post_start].service_time) + 
-        (V->d[pre_end][end_point] -  1*V->nodes[end_point].service_time) ;
-    new_cost=(V->d[start_point][pre_end]-1*V->nodes[pre_end].service_time) + 
-        (V->d[post_start][end_point] - 1*V->nodes[end_point].service_time);
+    old_cost=(V->d[start_point][post_start]-1*V->service_time_array[post_start]) + 
+        (V->d[pre_end][end_point] -  1*V->service_time_array[end_point]) ;
+    new_cost=(V->d[start_point][pre_end]-1*V->service_time_array[pre_end]) + 
+        (V->d[post_start][end_point] - 1*V->service_time_array[end_point]);
 
     savings=new_cost - old_cost;
     
@@ -138,14 +138,14 @@ bool Flip::move(VRP *V, int start_point, int end_point)
 
         old_next= V->next_array[end];
 
-        V->next_array[end]=start;
-        V->pred_array[start]=end;
+        V->set_next(end,start);
+        V->set_pred(start,end);
 
-        V->next_array[start]=old_next;
-        V->pred_array[old_next]=start;
+        V->set_next(start,old_next);
+        V->set_pred(old_next,start);
 
-        V->next_array[pre_start]=end;
-        V->pred_array[end]=pre_start;
+        V->set_next(pre_start,end);
+        V->set_pred(end,pre_start);
 
 #if FLIP_VERIFY
         V->verify_routes("flip 1\n");
@@ -160,9 +160,9 @@ bool Flip::move(VRP *V, int start_point, int end_point)
     old_next= V->next_array[current];    //n2
 
 
-    V->next_array[current]=end;        //next[n1]=end
-    V->pred_array[end]=current;        //pred[end]=n1;
-    V->pred_array[current]=old_next;    //pred[n1]=n2;
+    V->set_next(current,end);        //next[n1]=end
+    V->set_pred(end,current);        //pred[end]=n1;
+    V->set_pred(current,old_next);    //pred[n1]=n2;
     current=old_next;                            //current=n2
     old_next= V->next_array[current];    //old_next=n3
 
@@ -171,8 +171,8 @@ bool Flip::move(VRP *V, int start_point, int end_point)
     while(old_next != end)
     {
 
-        V->next_array[current] = V->pred_array[current];
-        V->pred_array[current]=old_next;
+        V->set_next(current,V->pred_array[current]);
+        V->set_pred(current,old_next);
         current = old_next;
         old_next = V->next_array[current];
         cnt++;
@@ -180,9 +180,9 @@ bool Flip::move(VRP *V, int start_point, int end_point)
             report_error("%s: flip::Impossible loop encountered\n");
 
     }
-    V->next_array[current]= V->pred_array[current];
-    V->pred_array[current]=start;
-    V->next_array[start]=current;
+    V->set_next(current,V->pred_array[current]);
+    V->set_pred(current,start);
+    V->set_next(start,current);
 
     return true;
 }
@@ -0,0 +1,380 @@
+////////////////////////////////////////////////////////////
+//                                                        //
+// This file is part of the VRPH software package for     //
+// generating solutions to vehicle routing problems.      //
+// VRPH was developed by Chris Groer (cgroer@gmail.com).  //
+//                                                        //
+// (c) Copyright 2010 Chris Groer.                        //
+// All Rights Reserved.  VRPH is licensed under the       //
+// Common Public License.  See LICENSE file for details.  //
+//                                                        //
+////////////////////////////////////////////////////////////
+
+#include "VRPH.h"
+
+HeldKarp::HeldKarp()
+{
+    ///
+    /// Default constructor for HeldKarp.  The table is allocated when
+    /// the first route is solved.
+    ///
+
+    this->cost=NULL;
+    this->parent=NULL;
+    this->table_size=0;
+    this->m=0;
+    this->num_customers=0;
+
+}
+
+HeldKarp::~HeldKarp()
+{
+    ///
+    /// Destructor for HeldKarp.
+    ///
+
+    if(this->cost)
+        delete [] this->cost;
+    if(this->parent)
+        delete [] this->parent;
+
+}
+
+bool HeldKarp::route_search(class VRP *V, int r, int rules)
+{
+    ///
+    /// Reorders route r optimally if it has at most V->held_karp_size
+    /// customers, keeping the edges that are fixed when VRPH_FIXED_EDGES is
+    /// set.  Longer routes and routes with time windows are searched with
+    /// ThreeOpt instead.  Returns true if the route was improved.
+    ///
+
+    ThreeOpt ThreeO;
+    int max_size;
+    bool improved;
+
+    if(V->route[r].num_customers==0)
+        return false;
+
+    max_size=VRPH_MIN(V->held_karp_size,HELD_KARP_MAX_SIZE);
+    if(V->has_time_windows || V->route[r].num_customers>max_size)
+        return ThreeO.route_search(V,r,rules);
+
+    V->num_evaluations[HELD_KARP_INDEX]++;
+
+    improved=false;
+    if(this->solve(V,r,rules))
+    {
+        this->move(V,r);
+        improved=true;
+    }
+
+    // The route is now a local minimum for every intra-route heuristic
+    if(!(rules & VRPH_FIXED_EDGES))
+        V->route_found_optimal(r,ONE_POINT_MOVE|TWO_POINT_MOVE|TWO_OPT|OR_OPT|
+            THREE_OPT|THREE_POINT_MOVE);
+
+    return improved;
+
+}
+
+bool HeldKarp::search_routes(class VRP *V, int rules)
+{
+    ///
+    /// Searches every route of V as route_search does, skipping the
+    /// routes the route memo knows to be optimal, except that the longer
+    /// routes and those with time windows are brought to a local minimum
+    /// with ThreeOpt::search_routes.  The short routes only read the
+    /// solution while they are solved, so they are solved in parallel when
+    /// VRPH is built with OpenMP, each thread with its own table.  The new
+    /// orders are then applied one route at a time in route order, so the
+    /// result does not depend on the number of threads.  Returns true if
+    /// any route was improved.
+    ///
+
+    ThreeOpt ThreeO;
+    int i,k,r,R,num_routes,num_long_routes,max_size,memo_heuristics;
+    int *routes, *long_routes, *offset, *orders;
+    bool *found;
+    bool fixed, improved;
+
+    R=V->total_number_of_routes;
+    fixed=((rules & VRPH_FIXED_EDGES)!=0);
+    memo_heuristics=THREE_OPT+(rules & VRPH_USE_NEIGHBOR_LIST);
+    max_size=VRPH_MIN(V->held_karp_size,HELD_KARP_MAX_SIZE);
+
+    routes=new int[R+1];
+    long_routes=new int[R+1];
+    offset=new int[R+1];
+    found=new bool[R+1];
+    orders=new int[V->num_nodes+1];
+
+    // Collect the long routes and the short ones
+    num_routes=0;
+    num_long_routes=0;
+    k=0;
+    for(r=1;r<=R;r++)
+    {
+        if(V->route[r].num_customers==0)
+            continue;
+        if(!fixed && V->route_is_optimal(r,memo_heuristics))
+            continue;
+
+        if(V->has_time_windows || V->route[r].num_customers>max_size)
+        {
+            long_routes[num_long_routes++]=r;
+            continue;
+        }
+
+        routes[num_routes]=r;
+        offset[num_routes]=k;
+        k+=V->route[r].num_customers;
+        num_routes++;
+    }
+
+    improved=ThreeO.search_routes(V,num_long_routes,long_routes,rules);
+
+#ifdef _OPENMP
+#pragma omp parallel if(num_routes>1)
+#endif
+    {
+        HeldKarp HK;
+        int j;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for(j=0;j<num_routes;j++)
+        {
+            found[j]=HK.solve(V,routes[j],rules);
+            if(found[j])
+                memcpy(orders+offset[j],HK.order,HK.num_customers*sizeof(int));
+        }
+    }
+
+    // Apply the new orders
+    for(i=0;i<num_routes;i++)
+    {
+        r=routes[i];
+        V->num_evaluations[HELD_KARP_INDEX]++;
+        if(found[i])
+        {
+            this->num_customers=V->route[r].num_customers;
+            memcpy(this->order,orders+offset[i],this->num_customers*sizeof(int));
+            this->move(V,r);
+            improved=true;
+        }
+
+        if(!fixed)
+            V->route_found_optimal(r,ONE_POINT_MOVE|TWO_POINT_MOVE|TWO_OPT|OR_OPT|
+                THREE_OPT|THREE_POINT_MOVE);
+    }
+
+    delete [] routes;
+    delete [] long_routes;
+    delete [] offset;
+    delete [] found;
+    delete [] orders;
+
+    return improved;
+
+}
+
+bool HeldKarp::solve(class VRP *V, int r, int rules)
+{
+    ///
+    /// Finds the shortest order of the customers of route r by dynamic
+    /// programming over the subsets of the units of the route.  Returns
+    /// true and leaves the order in order[] if it is shorter than the
+    /// route.
+    ///
+
+    int i,j,k,u,w,mask,full,best_u,size;
+    int units[HELD_KARP_MAX_SIZE];
+    double c,best,route_len;
+    bool fixed, fix_start, fix_end;
+
+    fixed=((rules & VRPH_FIXED_EDGES)!=0);
+
+    // Split the route into strings joined by fixed edges
+    this->m=0;
+    this->num_customers=V->route[r].num_customers;
+    j=V->route[r].start;
+    this->first[0]=j;
+    this->inner[0]=0;
+    route_len=V->d[VRPH_DEPOT][j];
+    while(j!=VRPH_DEPOT)
+    {
+        k=VRPH_MAX(V->next_array[j],VRPH_DEPOT);
+        route_len+=V->d[j][k];
+        if(k!=VRPH_DEPOT && fixed && V->is_fixed(j,k))
+            this->inner[this->m]+=V->d[j][k];
+        else
+        {
+            this->last[this->m]=j;
+            this->m++;
+            if(k!=VRPH_DEPOT)
+            {
+                this->first[this->m]=k;
+                this->inner[this->m]=0;
+            }
+        }
+        j=k;
+    }
+
+    if(this->m<=1)
+        return false;
+
+    // The first and last units stay in place if their VRPH_DEPOT edges are fixed
+    fix_start=fixed && V->is_fixed(VRPH_DEPOT,this->first[0]);
+    fix_end=fixed && V->is_fixed(this->last[this->m-1],VRPH_DEPOT);
+
+    size=(1<<this->m)*this->m;
+    if(size>this->table_size)
+    {
+        if(this->cost)
+            delete [] this->cost;
+        if(this->parent)
+            delete [] this->parent;
+        this->cost=new double[size];
+        this->parent=new int[size];
+        this->table_size=size;
+    }
+
+    for(i=0;i<size;i++)
+        this->cost[i]=VRP_INFINITY;
+
+    for(u=0;u<this->m;u++)
+    {
+        if( (fix_start && u!=0) || (fix_end && u==this->m-1) )
+            continue;
+        this->cost[(1<<u)*this->m+u]=V->d[VRPH_DEPOT][this->first[u]]+this->inner[u];
+        this->parent[(1<<u)*this->m+u]=-1;
+    }
+
+    full=(1<<this->m)-1;
+    for(mask=1;mask<full;mask++)
+    {
+        for(u=0;u<this->m;u++)
+        {
+            if(!(mask & (1<<u)) || this->cost[mask*this->m+u]>=VRP_INFINITY)
+                continue;
+
+            for(w=0;w<this->m;w++)
+            {
+                if(mask & (1<<w))
+                    continue;
+                if( (fix_start && w==0) || (fix_end && w==this->m-1 && (mask|(1<<w))!=full) )
+                    continue;
+
+                c=this->cost[mask*this->m+u]+V->d[this->last[u]][this->first[w]]+this->inner[w];
+                k=(mask|(1<<w))*this->m+w;
+                if(c<this->cost[k])
+                {
+                    this->cost[k]=c;
+                    this->parent[k]=u;
+                }
+            }
+        }
+    }
+
+    best=VRP_INFINITY;
+    best_u=-1;
+    for(u=0;u<this->m;u++)
+    {
+        if(fix_end && u!=this->m-1)
+            continue;
+        c=this->cost[full*this->m+u]+V->d[this->last[u]][VRPH_DEPOT];
+        if(c<best)
+        {
+            best=c;
+            best_u=u;
+        }
+    }
+
+#if HELD_KARP_DEBUG
+    printf("HELD_KARP: route %d with %d units: %f -> %f\n",r,this->m,route_len,best);
+#endif
+
+    if(best_u==-1 || best>=route_len-VRPH_EPSILON)
+        return false;
+
+    // Follow the parents back to the first unit
+    mask=full;
+    u=best_u;
+    for(i=this->m-1;i>=0;i--)
+    {
+        units[i]=u;
+        w=this->parent[mask*this->m+u];
+        mask&=~(1<<u);
+        u=w;
+    }
+
+    // Expand the units into customers
+    k=0;
+    for(i=0;i<this->m;i++)
+    {
+        j=this->first[units[i]];
+        this->order[k++]=j;
+        while(j!=this->last[units[i]])
+        {
+            j=V->next_array[j];
+            this->order[k++]=j;
+        }
+    }
+
+    if(k!=this->num_customers)
+        report_error("%s: wrong number of customers in new order\n",__FUNCTION__);
+
+    return true;
+
+}
+
+bool HeldKarp::move(class VRP *V, int r)
+{
+    ///
+    /// Rearranges route r into the order found by solve().
+    ///
+
+    Postsert postsert;
+    Presert presert;
+    int i;
+
+    // The route passes through infeasible states along the way, so
+    // artificially inflate the constraints
+    double real_max_len= V->max_route_length;
+    int real_veh_max= V->max_veh_capacity;
+
+    V->max_route_length=VRP_INFINITY;
+    V->max_veh_capacity=VRP_INFINITY;
+
+    if(V->route[r].start!=this->order[0])
+    {
+        if(presert.move(V,this->order[0],V->route[r].start)==false)
+            report_error("%s: presert error\n",__FUNCTION__);
+    }
+
+    for(i=1;i<this->num_customers;i++)
+    {
+        if(VRPH_MAX(V->next_array[this->order[i-1]],VRPH_DEPOT)!=this->order[i])
+        {
+            if(postsert.move(V,this->order[i],this->order[i-1])==false)
+                report_error("%s: postsert error\n",__FUNCTION__);
+        }
+    }
+
+    V->max_route_length=real_max_len;
+    V->max_veh_capacity=real_veh_max;
+
+#if HELD_KARP_VERIFY
+    V->verify_routes("After HELD_KARP move\n");
+#endif
+
+    V->num_moves[HELD_KARP_INDEX]++;
+
+    V->capture_best_solution();
+
+    return true;
+
+}
+
@@ -21,12 +21,23 @@ bool OnePointMove::search(class VRP *V, int j, int rules)
     /// true.  Returns false if no move is found.
     ///
     
+    VRPH_DISPATCH_RULES(rules,search_rules,(V,j,rules))
+}
+
+template<int R> bool OnePointMove::search_rules(class VRP *V, int j, int rules)
+{
+    ///
+    /// The search for the rules R, or for any rules if R is VRPH_DYNAMIC_RULES.
+    ///
+
+    rules=VRPH_STATIC_RULES(R,rules);
+
     VRPMove M;
     VRPMove BestM;
-    M.savings=M.new_total_route_length=BestM.savings=BestM.new_total_route_length=VRP_INFINITY;
+    VRPCompactMove Best;
+    M.savings=M.new_total_route_length=VRP_INFINITY;
 
     int i,k;
-    int best_k=0;
     int accept_type;
 
     i=VRPH_MAX(V->pred_array[j],VRPH_DEPOT);
@@ -39,7 +50,7 @@ bool OnePointMove::search(class VRP *V, int j, int rules)
     if( (rules & VRPH_FIXED_EDGES)  )
     {
         // Make sure we aren't disturbing fixed edges
-        if( (V->fixed[i][j]) || (V->fixed[j][k]) )
+        if( (V->is_fixed(i,j)) || (V->is_fixed(j,k)) )
             return false;
 
     }    
@@ -58,18 +69,23 @@ bool OnePointMove::search(class VRP *V, int j, int rules)
     // Create the search_space
     V->create_search_neighborhood(j, rules);    
 
-    int *old_sol=NULL;
+    // Drop the candidates that cannot give an acceptable move.  Undoing a
+    // tabu move can leave the routes reversed, so the screen is only done
+    // when the solution is not changed during the search.
+    if(!(rules & VRPH_TABU))
+        screen(V,j,V->savings_limit(rules));
+
     if(rules & VRPH_TABU)
     {
-        // Remember the original solution 
-        old_sol=new int[V->num_original_nodes+2];
-        V->export_solution_buff(old_sol);
+        // Record the changes made from here on so that a tabu move
+        // can be undone
+        V->start_journal();
     }
         
     for(i=0;i<V->search_size;i++)
     {            
         k=V->search_space[i];
-        if(evaluate(V,j,k,rules,&M)==true)
+        if(evaluate_rules<R>(V,j,k,rules,&M)==true)
         {
             // Feasible move found
             if(accept_type==VRPH_FIRST_ACCEPT || (accept_type==VRPH_LI_ACCEPT && M.savings<-VRPH_EPSILON) )
@@ -83,10 +99,10 @@ bool OnePointMove::search(class VRP *V, int j, int rules)
                     else
                     {
                         // Check VRPH_TABU status of move - return true if its ok
-                        // or revert to old_sol if not and continue to search.
-                        if(V->check_tabu_status(&M, old_sol))
+                        // or undo it if not and continue to search.
+                        if(V->check_tabu_status(&M))
                         {
-                            delete [] old_sol;
+                            V->stop_journal();
                             return true; // The move was ok
                         }
                         // else we reverted back - continue the search for a move
@@ -98,10 +114,9 @@ bool OnePointMove::search(class VRP *V, int j, int rules)
             {
                 // store the move
 
-                if(M.is_better(V, &BestM, rules))
+                if(M.is_better(V, &Best, rules))
                 {
-                    best_k=k;
-                    BestM=M;
+                    Best=M;
                 }
             }                
         }
@@ -109,17 +124,23 @@ bool OnePointMove::search(class VRP *V, int j, int rules)
 
 
     // We've considered all the possibilities now...
-    if(accept_type==VRPH_FIRST_ACCEPT || BestM.savings==VRP_INFINITY)
+    if(accept_type==VRPH_FIRST_ACCEPT || Best.savings==VRP_INFINITY)
     {
         // No moves found
-        if(old_sol)
-            delete [] old_sol;
+        V->stop_journal();
         return false;
     }
 
     // else we found a move - try to make it
 
+    if(rules & VRPH_EVALUATE_ONLY)
+    {
+        // Report the best move without making it
+        V->best_savings=Best.savings;
+        return true;
+    }
 
+    Best.expand(&BestM);
     if(move(V,&BestM)==true)
     {
         if(!(rules & VRPH_TABU))
@@ -129,15 +150,15 @@ bool OnePointMove::search(class VRP *V, int j, int rules)
     if(rules & VRPH_TABU)
     {    
         // Check VRPH_TABU status of move - return true if its ok
-        // or revert to old_sol if not and return
-        if(V->check_tabu_status(&BestM, old_sol))// was &M??
+        // or undo it if not and return
+        if(V->check_tabu_status(&BestM))// was &M??
         {
-            delete [] old_sol;
+            V->stop_journal();
             return true; // The move was ok
         }
         else
         {
-            delete [] old_sol;
+            V->stop_journal();
             return false;
         }
     }
@@ -165,6 +186,7 @@ bool OnePointMove::route_search(class VRP *V, int r1, int r2, int rules)
 
     VRPMove M;
     VRPMove BestM;
+    VRPCompactMove Best;
     int k;
     double best_savings=VRP_INFINITY;
     int best_k=0;
@@ -213,7 +235,7 @@ bool OnePointMove::route_search(class VRP *V, int r1, int r2, int rules)
                     {
                         best_savings=M.savings;
                         best_k=k;
-                        BestM=M;
+                        Best=M;
                     }
                 }
 
@@ -234,7 +256,7 @@ bool OnePointMove::route_search(class VRP *V, int r1, int r2, int rules)
                     {
                         best_savings=M.savings;
                         best_k=k;
-                        BestM=M;
+                        Best=M;
                     }
                 }
             }
@@ -254,6 +276,7 @@ bool OnePointMove::route_search(class VRP *V, int r1, int r2, int rules)
         return false;
 
     // else we found a move - make it
+    Best.expand(&BestM);
     if(move(V,&BestM)==true)
         return true;
     else
@@ -264,6 +287,49 @@ bool OnePointMove::route_search(class VRP *V, int r1, int r2, int rules)
 
 }
 
+void OnePointMove::screen(class VRP *V, int j, double limit)
+{
+    ///
+    /// Removes from V->search_space the nodes b for which neither inserting
+    /// j before b nor after b can have savings below limit.  Only distances
+    /// are used, so this is much cheaper than calling evaluate for every
+    /// candidate.  The VRPH_DEPOT is always kept since it stands for the
+    /// ends of every route.
+    ///
+
+    int a,b,c,i,k,m,cnt;
+    double removal, s1, s2;
+
+    if(limit>=VRP_INFINITY)
+        return;
+
+    i=VRPH_MAX(V->pred_array[j],VRPH_DEPOT);
+    k=VRPH_MAX(V->next_array[j],VRPH_DEPOT);
+
+    // The change from removing j is the same for every candidate
+    removal=V->d[i][k]-V->d[i][j]-V->d[j][k];
+
+    cnt=0;
+    for(m=0;m<V->search_size;m++)
+    {
+        b=V->search_space[m];
+        if(b!=VRPH_DEPOT && b!=j && V->routed[b])
+        {
+            a=VRPH_MAX(V->pred_array[b],VRPH_DEPOT);
+            c=VRPH_MAX(V->next_array[b],VRPH_DEPOT);
+
+            // Savings of inserting j between a and b and between b and c
+            s1=V->d[a][j]+V->d[j][b]-V->d[a][b];
+            s2=V->d[b][j]+V->d[j][c]-V->d[b][c];
+            if(removal+VRPH_MIN(s1,s2)>limit)
+                continue;
+        }
+        V->search_space[cnt++]=b;
+    }
+    V->search_size=cnt;
+
+}
+
 // EVALUATE
 bool OnePointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
 {
@@ -273,6 +339,18 @@ bool OnePointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
     /// and returns false if no feasible move is found, true otherwise.
     ///
 
+    VRPH_DISPATCH_RULES(rules,evaluate_rules,(V,j,b,rules,M))
+}
+
+template<int R> bool OnePointMove::evaluate_rules(class VRP *V, int j, int b, int rules, VRPMove *M)
+{
+    ///
+    /// The evaluation for the rules R, or for any rules if R is
+    /// VRPH_DYNAMIC_RULES.
+    ///
+
+    rules=VRPH_STATIC_RULES(R,rules);
+
     V->num_evaluations[ONE_POINT_MOVE_INDEX]++;
 
     int a,c,i,k;
@@ -287,10 +365,10 @@ bool OnePointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
     {        
         // Make sure we aren't disturbing fixed edges
 
-        if( V->fixed[i][j]|| V->fixed[j][k] )
+        if( V->is_fixed(i,j)|| V->is_fixed(j,k) )
             return false;
 
-        if(b!=VRPH_DEPOT &&  (V->fixed[b][c] && V->fixed[a][b]) )
+        if(b!=VRPH_DEPOT &&  (V->is_fixed(b,c) && V->is_fixed(a,b)) )
             return false;
     }
 
@@ -310,17 +388,16 @@ bool OnePointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
         // Can quickly check veh capacity: j added to V->route_num[b]
         if(V->route_num[j] != V->route_num[b])
         {
-            if( V->nodes[j].demand + V->route[V->route_num[b]].load > V->max_veh_capacity)
+            if( V->demand_array[j] + V->route[V->route_num[b]].load > V->max_veh_capacity)
                 return false;
         }
 
 
     }
     
-    double savings1, savings2, best_savings;
+    double savings1, savings2;
     Postsert postsert;
     Presert presert;
-    best_savings=VRP_INFINITY;
     savings1=VRP_INFINITY;
     savings2=VRP_INFINITY;
 
@@ -334,6 +411,10 @@ bool OnePointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
         bool allowed, found_move;
         VRPMove CurrentM;
         found_move=false;
+
+        // M may still hold a move from an earlier call, so make sure that
+        // the best insertion is not compared against it
+        M->savings=VRP_INFINITY;
         
         for(;;)
         {
@@ -344,7 +425,7 @@ bool OnePointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
             if(j!=t)
             {
                 // Check for fixed edges
-                if((rules & VRPH_FIXED_EDGES) && V->fixed[VRPH_DEPOT][t])
+                if((rules & VRPH_FIXED_EDGES) && V->is_fixed(VRPH_DEPOT,t))
                     allowed=false;
 
                 if( (presert.evaluate(V,j,t,&CurrentM)==true)&&(V->check_move(&CurrentM,rules)==true) && allowed )
@@ -366,7 +447,7 @@ bool OnePointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
             if(j!=t)
             {
                 // Check for fixed edges
-                if((rules & VRPH_FIXED_EDGES) && V->fixed[t][VRPH_DEPOT])
+                if((rules & VRPH_FIXED_EDGES) && V->is_fixed(t,VRPH_DEPOT))
                     allowed=false;
 
                 if( (postsert.evaluate(V,j,t,&CurrentM)==true)&&(V->check_move(&CurrentM,rules)==true) && allowed )
@@ -400,7 +481,7 @@ bool OnePointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
         {
             // Make sure we aren't disturbing fixed edges
 
-            if( V->fixed[a][b] )//|| V->fixed[b][c])
+            if( V->is_fixed(a,b) )//|| V->is_fixed(b,c))
                 return false;
         }
         
@@ -420,7 +501,7 @@ bool OnePointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
         {
             // Make sure we aren't disturbing fixed edges
 
-            if( V->fixed[b][c] )//|| V->fixed[a][b] ) 
+            if( V->is_fixed(b,c) )//|| V->is_fixed(a,b) ) 
                 return false;
         }
 
@@ -438,8 +519,6 @@ bool OnePointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
     savings1 = (V->d[a][j]+V->d[j][b]+V->d[i][k]) - (V->d[a][b]+V->d[i][j]+V->d[j][k])  ;
     savings2 = (V->d[i][k]+V->d[b][j]+V->d[j][c]) - (V->d[b][c]+V->d[i][j]+V->d[j][k])  ;
 
-    best_savings = VRPH_MIN(savings1, savings2);
-
     
     if( savings1 <= savings2 &&  (presert.evaluate(V,j,b,M)==true)
         &&(V->check_move(M,rules)==true) )
@@ -449,7 +528,7 @@ bool OnePointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
         {
             // Make sure we aren't disturbing fixed edges
 
-            if( V->fixed[a][b] )//|| V->fixed[b][c] ) 
+            if( V->is_fixed(a,b) )//|| V->is_fixed(b,c) ) 
                 return false;
         }
         return true;
@@ -464,7 +543,7 @@ bool OnePointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
         {
             // Make sure we aren't disturbing fixed edges
 
-            if( V->fixed[b][c] )//|| V->fixed[a][b] ) 
+            if( V->is_fixed(b,c) )//|| V->is_fixed(a,b) ) 
                 return false;
         }
 
@@ -480,7 +559,7 @@ bool OnePointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
         {
             // Make sure we aren't disturbing fixed edges
 
-            if( V->fixed[a][b] )//|| V->fixed[b][c]) 
+            if( V->is_fixed(a,b) )//|| V->is_fixed(b,c)) 
                 return false;
         }
 
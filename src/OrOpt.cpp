@@ -52,11 +52,11 @@ bool OrOpt::search(class VRP *V, int a, int len, int rules)
         // Make sure we aren't disturbing fixed edges
         i=VRPH_MAX(V->pred_array[a],VRPH_DEPOT);
 
-        if( V->fixed[i][a] ) 
+        if( V->is_fixed(i,a) ) 
             return false;
 
         i=VRPH_MAX(V->next_array[string_end],VRPH_DEPOT);
-        if( V->fixed[string_end][i])
+        if( V->is_fixed(string_end,i))
             return false;
     }
 
@@ -72,12 +72,11 @@ bool OrOpt::search(class VRP *V, int a, int len, int rules)
 
     V->create_search_neighborhood(a, rules);
 
-    int *old_sol=NULL;
     if(rules & VRPH_TABU)
     {
-        // Remember the original solution 
-        old_sol=new int[V->num_original_nodes+2];
-        V->export_solution_buff(old_sol);
+        // Record the changes made from here on so that a tabu move
+        // can be undone
+        V->start_journal();
     }
         
     for(i=0;i<V->search_size;i++)
@@ -106,7 +105,7 @@ bool OrOpt::search(class VRP *V, int a, int len, int rules)
             {
 
                 // Try the move
-                if(evaluate(V,a,len,c,d,rules, &M)==true)
+                if(evaluate(V,a,len,c,d,false,rules,&M)==true)
                 {
                     // The move is good--make it
                     if(accept_type == VRPH_FIRST_ACCEPT || (accept_type==VRPH_LI_ACCEPT && M.savings<-VRPH_EPSILON))
@@ -120,10 +119,10 @@ bool OrOpt::search(class VRP *V, int a, int len, int rules)
                             else
                             {
                                 // Check VRPH_TABU status of move - return true if its ok
-                                // or revert to old_sol if not and continue to search.
-                                if(V->check_tabu_status(&M, old_sol))
+                                // or undo it if not and continue to search.
+                                if(V->check_tabu_status(&M))
                                 {
-                                    delete [] old_sol;
+                                    V->stop_journal();
                                     return true; // The move was ok
                                 }
                                 // else we reverted back - continue the search for a move
@@ -152,10 +151,10 @@ bool OrOpt::search(class VRP *V, int a, int len, int rules)
                                 else
                                 {
                                     // Check VRPH_TABU status of move - return true if its ok
-                                    // or revert to old_sol if not and continue to search.
-                                    if(V->check_tabu_status(&M, old_sol))
+                                    // or undo it if not and continue to search.
+                                    if(V->check_tabu_status(&M))
                                     {
-                                        delete [] old_sol;
+                                        V->stop_journal();
                                         return true; // The move was ok
                                     }
                                     // else we reverted back - continue the search for a move
@@ -176,8 +175,7 @@ bool OrOpt::search(class VRP *V, int a, int len, int rules)
 
     if(accept_type == VRPH_FIRST_ACCEPT || BestM.savings==VRP_INFINITY)
     {
-        if(old_sol)
-            delete [] old_sol;
+        V->stop_journal();
         return false ; // No moves found
     }
 
@@ -190,15 +188,15 @@ bool OrOpt::search(class VRP *V, int a, int len, int rules)
     if(rules & VRPH_TABU)
     {    
         // Check VRPH_TABU status of move - return true if its ok
-        // or revert to old_sol if not and return
-        if(V->check_tabu_status(&BestM, old_sol))// was &M??
+        // or undo it if not and return
+        if(V->check_tabu_status(&BestM))// was &M??
         {
-            delete [] old_sol;
+            V->stop_journal();
             return true; // The move was ok
         }
         else
         {
-            delete [] old_sol;
+            V->stop_journal();
             return false;
         }
     }
@@ -210,6 +208,156 @@ bool OrOpt::search(class VRP *V, int a, int len, int rules)
 
 }
 
+bool OrOpt::search(class VRP *V, int a, int min_len, int max_len, int rules)
+{
+    ///
+    /// Looks for insertions of the strings of length min_len,...,max_len
+    /// beginning at a that meet the provided rules, in both orientations
+    /// on symmetric problems.  The neighborhood of a is built once and the
+    /// strings are grown one node at a time, so the savings of every
+    /// length and orientation come from the same few distances.  Makes the
+    /// move if one is found.
+    ///
+
+    VRPMove M, BestM;
+    int i,c,d,t,len,num_lens,c_pos,orient,num_orients;
+    int str[OR_MAX_STRING_LENGTH+1];
+    double removal[OR_MAX_STRING_LENGTH+1], cd, savings, limit;
+    bool found;
+
+    int accept_type;
+
+    BestM.savings=VRP_INFINITY;
+
+    //default setting
+    accept_type=VRPH_FIRST_ACCEPT;
+
+    if( (rules & VRPH_FIRST_ACCEPT) > 0)
+        accept_type=VRPH_FIRST_ACCEPT;
+    if( (rules & VRPH_BEST_ACCEPT) > 0)
+        accept_type=VRPH_BEST_ACCEPT;
+    if( (rules & VRPH_LI_ACCEPT) > 0)
+        accept_type=VRPH_LI_ACCEPT;
+
+    if(max_len>OR_MAX_STRING_LENGTH)
+        report_error("%s: max_len is too large\n",__FUNCTION__);
+
+    if(a==VRPH_DEPOT || !V->routed[a])
+        return false;
+
+    t=VRPH_MAX(V->pred_array[a],VRPH_DEPOT);
+    if((rules & VRPH_FIXED_EDGES) && V->is_fixed(t,a))
+        return false;
+
+    // str[0],...,str[len-1] is the string of length len and str[len] follows
+    // it.  removal[len] is the cost saved by taking the string out.
+    str[0]=a;
+    num_lens=0;
+    for(len=1;len<=max_len;len++)
+    {
+        str[len]=VRPH_MAX(V->next_array[str[len-1]],VRPH_DEPOT);
+        removal[len]=V->d[t][a]+V->d[str[len-1]][str[len]]-V->d[t][str[len]];
+        if(len>=min_len)
+            num_lens=len;
+        if(str[len]==VRPH_DEPOT)
+            break;
+    }
+    if(num_lens<min_len)
+        // The route is too short
+        return false;
+
+    num_orients=1;
+    if(V->symmetric)
+        num_orients=2;
+
+    V->create_search_neighborhood(a, rules);
+    limit=V->savings_limit(rules);
+
+    if(rules & VRPH_TABU)
+    {
+        // Record the changes made from here on so that a tabu move
+        // can be undone
+        V->start_journal();
+    }
+
+    found=false;
+
+    for(i=0;i<V->search_size;i++)
+    {
+        c=V->search_space[i];
+        if(c==VRPH_DEPOT || c==t)
+            continue;
+
+        d=VRPH_MAX(V->next_array[c],0);
+        if(d==VRPH_DEPOT)
+            continue;
+
+        // Only the strings that end before c can go between c and d
+        for(c_pos=0;c_pos<num_lens && str[c_pos]!=c;c_pos++);
+
+        cd=V->d[c][d];
+        for(len=min_len;len<=num_lens && len<=c_pos;len++)
+        {
+            if((rules & VRPH_FIXED_EDGES) && V->is_fixed(str[len-1],str[len]))
+                continue;
+
+            for(orient=0;orient<num_orients;orient++)
+            {
+                // Reject on savings before anything else
+                if(orient==0)
+                    savings=(V->d[c][a]+V->d[str[len-1]][d]-cd)-removal[len];
+                else
+                    savings=(V->d[c][str[len-1]]+V->d[a][d]-cd)-removal[len];
+                if(savings>limit)
+                    continue;
+
+                if(evaluate(V,a,len,c,d,(orient==1),rules,&M)==false)
+                    continue;
+
+                // We have found a valid move.
+                if(accept_type == VRPH_FIRST_ACCEPT || (accept_type==VRPH_LI_ACCEPT && M.savings<-VRPH_EPSILON))
+                {
+                    if(move(V, &M)==false)
+                        report_error("%s: move error 1\n",__FUNCTION__);
+
+                    // Check VRPH_TABU status of move - if it is not ok then
+                    // we reverted back - continue the search for a move
+                    if(!(rules & VRPH_TABU) || V->check_tabu_status(&M))
+                    {
+                        found=true;
+                        goto done;
+                    }
+                }
+
+                if(accept_type == VRPH_BEST_ACCEPT || accept_type==VRPH_LI_ACCEPT)
+                {
+                    if(M.is_better(V, &BestM, rules))
+                        BestM=M;
+                }
+            }
+        }
+    }
+
+    if(accept_type == VRPH_FIRST_ACCEPT || BestM.savings==VRP_INFINITY)
+        // No moves found
+        goto done;
+
+    if(move(V,&BestM)==false)
+        report_error("%s: best move evaluates to false\n",__FUNCTION__);
+
+    // Check VRPH_TABU status of move - if it is not ok
+    // then we reverted back - search over
+    if(!(rules & VRPH_TABU) || V->check_tabu_status(&BestM))
+        found=true;
+
+done:
+    if(rules & VRPH_TABU)
+        V->stop_journal();
+
+    return found;
+
+}
+
 bool OrOpt::route_search(VRP *V, int r1, int r2, int len, int rules)
 {
     ///
@@ -233,6 +381,10 @@ bool OrOpt::route_search(VRP *V, int r1, int r2, int len, int rules)
     if( (rules & VRPH_LI_ACCEPT) > 0)
         accept_type=VRPH_LI_ACCEPT;
 
+    // Skip the search if it failed before and neither route has changed
+    if(V->pair_searched(r1,r2,OR_OPT+len,rules))
+        return false;
+
     int j;
     j= V->route[r1].start;
     while(j!=VRPH_DEPOT)
@@ -242,7 +394,7 @@ bool OrOpt::route_search(VRP *V, int r1, int r2, int len, int rules)
         while(c!=VRPH_DEPOT)
         {
             d=VRPH_MAX(V->next_array[c],0);
-            if(evaluate(V,j,len,c,d,rules, &M)==true)
+            if(evaluate(V,j,len,c,d,false,rules,&M)==true)
             {
                 if(accept_type==VRPH_FIRST_ACCEPT || (accept_type==VRPH_LI_ACCEPT && M.savings<-VRPH_EPSILON) )
                 {    
@@ -271,11 +423,12 @@ bool OrOpt::route_search(VRP *V, int r1, int r2, int len, int rules)
         j=VRPH_MAX(V->next_array[j],0);
     }
 
-    if(accept_type==VRPH_FIRST_ACCEPT)
-        return false; // No moves found
-
-    if(BestM.savings==VRP_INFINITY)
+    if(accept_type==VRPH_FIRST_ACCEPT || BestM.savings==VRP_INFINITY)
+    {
+        // No moves found
+        V->pair_search_failed(r1,r2,OR_OPT+len,rules);
         return false;
+    }
 
     if(accept_type==VRPH_BEST_ACCEPT || accept_type==VRPH_LI_ACCEPT)
     {
@@ -294,11 +447,14 @@ bool OrOpt::route_search(VRP *V, int r1, int r2, int len, int rules)
 
 }
 
-bool OrOpt::evaluate(class VRP *V, int a, int len, int c, int d, int rules, VRPMove *M)
+bool OrOpt::evaluate(class VRP *V, int a, int len, int c, int d, bool reversed, int rules, 
+                     VRPMove *M)
 {
     ///
     /// Evaluates the move of taking the string of length len beginning at a and 
-    /// inserting it between c and d subject to the provided rules
+    /// inserting it between c and d subject to the provided rules.  If reversed
+    /// is true the string is inserted back to front, which is only allowed on
+    /// symmetric problems.
     ///
 
     V->num_evaluations[OR_OPT_INDEX]++;
@@ -308,7 +464,7 @@ bool OrOpt::evaluate(class VRP *V, int a, int len, int c, int d, int rules, VRPM
     if(rules & VRPH_FIXED_EDGES)
     {
         // Make sure we aren't disturbing fixed edges
-        if( V->fixed[c][d] ) 
+        if( V->is_fixed(c,d) ) 
             return false;
     }    
 
@@ -320,6 +476,7 @@ bool OrOpt::evaluate(class VRP *V, int a, int len, int c, int d, int rules, VRPM
 
     M->eval_arguments[0]=a;M->eval_arguments[1]=len;
     M->eval_arguments[2]=c;M->eval_arguments[3]=d;
+    M->eval_arguments[4]=reversed;
 
     // First make sure the edge c-d exists
     if(c!=VRPH_DEPOT && VRPH_MAX(V->next_array[c],0)!=d )
@@ -358,7 +515,7 @@ bool OrOpt::evaluate(class VRP *V, int a, int len, int c, int d, int rules, VRPM
         z=VRPH_MAX(V->pred_array[a],VRPH_DEPOT);
         b=VRPH_MAX(V->next_array[string_end],VRPH_DEPOT);
 
-        if( V->fixed[z][a] || V->fixed[string_end][b] ) 
+        if( V->is_fixed(z,a) || V->is_fixed(string_end,b) ) 
             return false;
         
         
@@ -370,6 +527,22 @@ bool OrOpt::evaluate(class VRP *V, int a, int len, int c, int d, int rules, VRPM
 
     if(MS.evaluate(V,c,d,a,string_end, M)==true) 
     {
+        if(reversed)
+        {
+            if(!V->symmetric)
+                report_error("%s: strings can only be reversed on symmetric problems\n",__FUNCTION__);
+
+            // c-string_end...a-d instead of c-a...string_end-d
+            double delta=(V->d[c][string_end]+V->d[a][d])-(V->d[c][a]+V->d[string_end][d]);
+            M->savings+=delta;
+            M->route_lens[0]+=delta;
+            M->new_total_route_length+=delta;
+            if(M->route_lens[0]>V->max_route_length)
+                return false;
+            M->num_arguments=5;
+            M->move_arguments[4]=1;
+        }
+
         if(V->check_move(M,rules)==true)
             return true;
         else
@@ -392,12 +565,14 @@ bool OrOpt::move(class VRP *V, VRPMove *M)
     /// len at and inserting between c and d if it meets the rules
     ///
 
-    int a,len,c,d;
+    int a,len,c,d,i;
+    bool reversed;
 
     a=M->eval_arguments[0];
     len=M->eval_arguments[1];
     c=M->eval_arguments[2];
     d=M->eval_arguments[3];
+    reversed=(M->eval_arguments[4]!=0);
 
     int string_end = V->get_string_end(a, len);
     if(string_end==-1)
@@ -406,12 +581,59 @@ bool OrOpt::move(class VRP *V, VRPMove *M)
         
     }
 
-    MoveString MS;
+    if(reversed)
+    {
+        // Place the nodes one at a time as MoveString does, but from
+        // string_end back to a
+        Postsert postsert;
+        Presert presert;
+        int str[OR_MAX_STRING_LENGTH];
+
+        if(len>OR_MAX_STRING_LENGTH)
+            report_error("%s: string is too long\n",__FUNCTION__);
+
+        str[0]=a;
+        for(i=1;i<len;i++)
+            str[i]=VRPH_MAX(V->next_array[str[i-1]],0);
+
+        // Artificially inflate the constraints!
+        double real_max_len= V->max_route_length;
+        int real_veh_max= V->max_veh_capacity;
+
+        V->max_route_length=VRP_INFINITY;
+        V->max_veh_capacity=VRP_INFINITY;
+
+        if(c!=VRPH_DEPOT)
+        {
+            // c-string_end-...-a-d
+            postsert.move(V,str[len-1],c);
+            for(i=len-2;i>=0;i--)
+                postsert.move(V,str[i],str[i+1]);
+        }
+        else
+        {
+            // VRPH_DEPOT-string_end-...-a-d
+            presert.move(V,str[0],d);
+            for(i=1;i<len;i++)
+                presert.move(V,str[i],str[i-1]);
+        }
+
+        V->max_route_length=real_max_len;
+        V->max_veh_capacity=real_veh_max;
 
-    if(    MS.move(V,c,d,a,string_end)==false)
+#if OR_VERIFY
+        V->verify_routes("After reversed OrOpt move\n");
+#endif
+    }
+    else
     {
-        report_error("%s: MS.move is false!\n",__FUNCTION__);
-        
+        MoveString MS;
+
+        if(    MS.move(V,c,d,a,string_end)==false)
+        {
+            report_error("%s: MS.move is false!\n",__FUNCTION__);
+
+        }
     }
 
     V->num_moves[OR_OPT_INDEX]++;
@@ -44,7 +44,7 @@ bool Postsert::evaluate(class VRP *V, int u, int i, VRPMove *M)
     // Can check load feasibility easily
     if(u_route != i_route)
     {
-        if(V->route[i_route].load+V->nodes[u].demand>V->max_veh_capacity)
+        if(V->route[i_route].load+V->demand_array[u]>V->max_veh_capacity)
             return false;
     }
 
@@ -106,7 +106,7 @@ bool Postsert::evaluate(class VRP *V, int u, int i, VRPMove *M)
     {
         // Different routes
         i_change = i_gain;
-        load_change = V->nodes[u].demand; 
+        load_change = V->demand_array[u]; 
 
         i_length = V->route[i_route].length + i_change;
         i_load = V->route[i_route].load + load_change;
@@ -293,22 +293,26 @@ bool Postsert::move(VRP *V, int u, int i)
         // i and u cannot be in the same original route in this case
 
         //new_i_end=u;
-        V->next_array[i]=u;
-        V->pred_array[u]=i;
+        V->set_next(i,u);
+        V->set_pred(u,i);
 
         // VRPH_ADDED
-        V->next_array[u]=-VRPH_ABS(post_u);  
+        V->set_next(u,-VRPH_ABS(post_u));  
         // post_u is now the beginning of u's old route
-        V->pred_array[VRPH_ABS(post_u)]=-u;
+        V->set_pred(VRPH_ABS(post_u),-u);
 
         // Update i_route information
-        V->route_num[u]=i_route;
+        V->set_route_num(u,i_route);
         V->route[i_route].end=new_i_end;
         V->route[i_route].start=new_i_start;
 
         // Now for the updates to u's former route
         if(start_u==u && end_u ==u)
+        {
+            // u's old route is gone - recycle its id
+            V->reclaim_routes();
             return true;
+        }
 
         if(start_u==u)
             // New start to u's old route since u used to be first
@@ -326,23 +330,23 @@ bool Postsert::move(VRP *V, int u, int i)
         return true;
     }
 
-    V->next_array[i] = u;
-    V->next_array[u] = post_i;
-    V->pred_array[u]=i;
+    V->set_next(i,u);
+    V->set_next(u,post_i);
+    V->set_pred(u,i);
 
     // We now need to make u's old predecessor pre_u point to post_u since
     // u is no longer there
 
     if(pre_u>0&&post_u>0)
     {
-        V->next_array[VRPH_ABS(pre_u)]=post_u;
-        V->pred_array[VRPH_ABS(post_u)]=pre_u;
+        V->set_next(VRPH_ABS(pre_u),post_u);
+        V->set_pred(VRPH_ABS(post_u),pre_u);
     }
     else
     {
         // u was the first or last node in its route
-        V->next_array[VRPH_ABS(pre_u)]=-VRPH_ABS(post_u);
-        V->pred_array[VRPH_ABS(post_u)]=-VRPH_ABS(pre_u);
+        V->set_next(VRPH_ABS(pre_u),-VRPH_ABS(post_u));
+        V->set_pred(VRPH_ABS(post_u),-VRPH_ABS(pre_u));
 
     }    
 
@@ -352,19 +356,23 @@ bool Postsert::move(VRP *V, int u, int i)
     // The element who used to be after i is now preceded by u 
     //if(post_i>=0)// CHANGED 8/11/2008
     if(post_i>0)
-        V->pred_array[post_i]=u;
+        V->set_pred(post_i,u);
     else
-        V->pred_array[-post_i]=-u;
+        V->set_pred(-post_i,-u);
 
     // Update i_route information
-    V->route_num[u]=i_route;
+    V->set_route_num(u,i_route);
     V->route[i_route].end = new_i_end;
     V->route[i_route].start=new_i_start;
 
     // Now update u's former route
 
     if(start_u==u && end_u ==u)
-        return true;        
+    {
+        // u's old route is gone - recycle its id
+        V->reclaim_routes();
+        return true;
+    }
     
 
     if(u_route==i_route)
@@ -44,7 +44,7 @@ bool Presert::evaluate(class VRP *V, int u, int i, VRPMove *M)
     // Can check load feasibility easily
     if(u_route != i_route)
     {
-        if(V->route[i_route].load+V->nodes[u].demand>V->max_veh_capacity)
+        if(V->route[i_route].load+V->demand_array[u]>V->max_veh_capacity)
             return false;
     }
 
@@ -92,7 +92,7 @@ bool Presert::evaluate(class VRP *V, int u, int i, VRPMove *M)
     {
         // Different routes
         i_change = i_gain;
-        demand_change = V->nodes[u].demand; 
+        demand_change = V->demand_array[u]; 
         i_length = V->route[i_route].length + i_change;
         i_load = V->route[i_route].load + demand_change;
         u_length = V->route[u_route].length - u_loss;
@@ -262,14 +262,14 @@ bool Presert::move(VRP *V, int u, int i)
         //            1-...-t-v-1
         //            1-u-i-a-...
 
-        V->next_array[u]=i;
-        V->pred_array[i]=u;
+        V->set_next(u,i);
+        V->set_pred(i,u);
 
-        V->next_array[VRPH_ABS(pre_u)]=-u;
-        V->pred_array[u]=-VRPH_ABS(pre_u);
+        V->set_next(VRPH_ABS(pre_u),-u);
+        V->set_pred(u,-VRPH_ABS(pre_u));
 
         // Update i_route information
-        V->route_num[u]=i_route;
+        V->set_route_num(u,i_route);
         V->route[i_route].end=new_i_end;
         V->route[i_route].start=new_i_start;
 
@@ -277,7 +277,11 @@ bool Presert::move(VRP *V, int u, int i)
 
         // Make sure we didn't have VRPH_DEPOT-u-VRPH_DEPOT route
         if(start_u==end_u)
-            return true;//??
+        {
+            // u's old route is gone - recycle its id
+            V->reclaim_routes();
+            return true;
+        }
         
 
         // Update u_route information
@@ -290,27 +294,31 @@ bool Presert::move(VRP *V, int u, int i)
     // Added Special case - u is the first node in the route following i's route
     if(V->next_array[end_i] == -u)
     {
-        V->next_array[end_i] = -VRPH_ABS(post_u);//temp1;
-        V->pred_array[VRPH_ABS(post_u)] = -end_i;
-        V->next_array[u]=i;
-        V->pred_array[i]=u;
-        V->pred_array[u]=pre_i;
+        V->set_next(end_i,-VRPH_ABS(post_u));//temp1;
+        V->set_pred(VRPH_ABS(post_u),-end_i);
+        V->set_next(u,i);
+        V->set_pred(i,u);
+        V->set_pred(u,pre_i);
 
         if(pre_i>0)    // was >=!!
-            V->next_array[pre_i]=u;
+            V->set_next(pre_i,u);
         else
             // post_i 
-            V->next_array[VRPH_ABS(pre_i)]=-u;
+            V->set_next(VRPH_ABS(pre_i),-u);
 
         // Update i_route information
-        V->route_num[u]=i_route;
+        V->set_route_num(u,i_route);
         V->route[i_route].end=new_i_end;
         V->route[i_route].start=new_i_start;
 
         
         // Check for VRPH_DEPOT-u-VRPH_DEPOT route
         if(start_u==end_u)
+        {
+            // u's old route is gone - recycle its id
+            V->reclaim_routes();
             return true;
+        }
         
 
         // start_u is now next[u] since u used to be at the start
@@ -325,9 +333,9 @@ bool Presert::move(VRP *V, int u, int i)
     }
 
     // u is now followed by i
-    V->next_array[u]=i;
-    V->pred_array[i]=u;
-    V->pred_array[u]=pre_i;
+    V->set_next(u,i);
+    V->set_pred(i,u);
+    V->set_pred(u,pre_i);
     // We now need to make u's old predecessor pre_u point to post_u since
     // u is no longer there
     
@@ -336,32 +344,36 @@ bool Presert::move(VRP *V, int u, int i)
     if(pre_u<=0 || post_u<=0)
     {
         // u is first or last in its route
-        V->next_array[VRPH_ABS(pre_u)]=-VRPH_ABS(post_u);
-        V->pred_array[VRPH_ABS(post_u)]=-VRPH_ABS(pre_u);
+        V->set_next(VRPH_ABS(pre_u),-VRPH_ABS(post_u));
+        V->set_pred(VRPH_ABS(post_u),-VRPH_ABS(pre_u));
     }
     else
     {
-        V->next_array[pre_u]=post_u;
-        V->pred_array[VRPH_ABS(post_u)]=pre_u;
+        V->set_next(pre_u,post_u);
+        V->set_pred(VRPH_ABS(post_u),pre_u);
     }
     // The element who used to be after u is now preceded by the element
     // that was before u
     
     // The element who used to be after i is now preceded by u 
     if(pre_i>0)// was >=!!
-        V->next_array[pre_i]=u;
+        V->set_next(pre_i,u);
     else
         // post_i 
-        V->next_array[VRPH_ABS(pre_i)]=-u;
+        V->set_next(VRPH_ABS(pre_i),-u);
 
     // Update i_route information
-    V->route_num[u]=i_route;
+    V->set_route_num(u,i_route);
     V->route[i_route].end=new_i_end;
     V->route[i_route].start=new_i_start;
 
     // Check for VRPH_DEPOT-u-VRPH_DEPOT route
     if(start_u==end_u)
+    {
+        // u's old route is gone - recycle its id
+        V->reclaim_routes();
         return true;
+    }
     
 
     // Update u_route information
@@ -136,4 +136,35 @@ void random_permutation(int *perm, int n)
     return;
 }
 
+#if VRPH_SMALL_INDEX
+void random_permutation(VRPIndex *perm, int n)
+{
+    ///
+    /// The same permutation for the 16-bit node indices of the
+    /// search_space.
+    ///
+
+    int r, len;
+    VRPIndex temp;
+
+    len = n-1;
+
+    while(len >= 0)
+    {
+        r= (int)( lcgrand(9) * n);//between 0 and n-1 inclusive
+        if(r<0)
+            r=0;
+        if(r>n-1)
+            r=n-1;
+        temp=perm[len];
+        perm[len]=perm[r];
+        perm[r]=temp;
+        len--;
+    }
+
+    
+    return;
+}
+#endif
+
 
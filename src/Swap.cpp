@@ -182,12 +182,12 @@ bool Swap::evaluate(class VRP *V, int u, int i, VRPMove *M)
 
         // Now check capacity constraints
 
-        if( (M->route_loads[1] = V->route[i_route].load+V->nodes[u].demand-
-            V->nodes[i].demand ) >  V->max_veh_capacity)
+        if( (M->route_loads[1] = V->route[i_route].load+V->demand_array[u]-
+            V->demand_array[i] ) >  V->max_veh_capacity)
             return false;    // route that used to contain i is infeasible
 
-        if( ( M->route_loads[0]= V->route[u_route].load+V->nodes[i].demand-
-            V->nodes[u].demand ) >  V->max_veh_capacity)
+        if( ( M->route_loads[0]= V->route[u_route].load+V->demand_array[i]-
+            V->demand_array[u] ) >  V->max_veh_capacity)
             return false;    // route that used to contain u is infeasible
 
     }
@@ -410,24 +410,24 @@ bool Swap::move(VRP *V, int u, int i)
 
     if(h>0)
     {
-        V->next_array[h]=u;
-        V->pred_array[u]=h;
+        V->set_next(h,u);
+        V->set_pred(u,h);
     }
     else
     {
-        V->pred_array[u]=h;
-        V->next_array[VRPH_ABS(h)]=-u;
+        V->set_pred(u,h);
+        V->set_next(VRPH_ABS(h),-u);
     }
 
     if(j>0)
     {
-        V->next_array[u]=j;
-        V->pred_array[j]=u;
+        V->set_next(u,j);
+        V->set_pred(j,u);
     }
     else
     {
-        V->next_array[u]=j;
-        V->pred_array[VRPH_ABS(j)]=-u;
+        V->set_next(u,j);
+        V->set_pred(VRPH_ABS(j),-u);
     }
 
 
@@ -435,24 +435,24 @@ bool Swap::move(VRP *V, int u, int i)
 
     if(t>0)
     {
-        V->next_array[t]=i;
-        V->pred_array[i]=t;
+        V->set_next(t,i);
+        V->set_pred(i,t);
     }
     else
     {
-        V->pred_array[i]=t;
-        V->next_array[VRPH_ABS(t)]=-i;
+        V->set_pred(i,t);
+        V->set_next(VRPH_ABS(t),-i);
     }
 
     if(v>0)
     {
-        V->next_array[i]=v;
-        V->pred_array[v]=i;
+        V->set_next(i,v);
+        V->set_pred(v,i);
     }
     else
     {
-        V->next_array[i]=v;
-        V->pred_array[VRPH_ABS(v)]=-i;
+        V->set_next(i,v);
+        V->set_pred(VRPH_ABS(v),-i);
     }
 
     // Now adjust the start and end routes 
@@ -478,8 +478,8 @@ bool Swap::move(VRP *V, int u, int i)
             // i is the new end
             V->route[i_route].end=u;
 
-        V->route_num[u]=i_route;
-        V->route_num[i]=u_route;
+        V->set_route_num(u,i_route);
+        V->set_route_num(i,u_route);
 
 
 #if SWAP_VERIFY
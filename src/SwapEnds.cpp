@@ -162,29 +162,29 @@ bool SwapEnds::move(VRP *V, int a, int v)
 
     if(u>0 && b>0)
     {
-        V->next_array[a]=u;
-        V->pred_array[u]=a;
-        V->next_array[v]=b;
-        V->pred_array[b]=v;
+        V->set_next(a,u);
+        V->set_pred(u,a);
+        V->set_next(v,b);
+        V->set_pred(b,v);
     }
     else
     {
         if(u>0 && b<0)
         {
-            V->next_array[a]=u;
-            V->pred_array[u]=a;
-            V->next_array[v]=b;
-            V->pred_array[-b]=-v;
+            V->set_next(a,u);
+            V->set_pred(u,a);
+            V->set_next(v,b);
+            V->set_pred(-b,-v);
         }
         else
         {
 
             if(u<0 && b>0)
             {
-                V->next_array[a]=u;
-                V->pred_array[-u]=-a;
-                V->next_array[v]=-b;
-                V->pred_array[b]=v;
+                V->set_next(a,u);
+                V->set_pred(-u,-a);
+                V->set_next(v,-b);
+                V->set_pred(b,v);
             }
             else
                 report_error("%s: Reached strange place...\n",__FUNCTION__);
@@ -208,7 +208,7 @@ bool SwapEnds::move(VRP *V, int a, int v)
     current_node = a;
     while(current_node > 0)
     {
-        V->route_num[current_node] = V->route_num[a];
+        V->set_route_num(current_node,V->route_num[a]);
         current_node = V->next_array[current_node];
         
     }
@@ -216,7 +216,7 @@ bool SwapEnds::move(VRP *V, int a, int v)
     current_node = v;
     while(current_node > 0)
     {
-        V->route_num[current_node] = V->route_num[v];
+        V->set_route_num(current_node,V->route_num[v]);
         current_node = V->next_array[current_node];
 
     }
@@ -238,22 +238,22 @@ bool SwapEnds::move(VRP *V, int a, int v)
         if(route_after_a != 0 && route_after_v!=0)
         {
             
-            V->next_array[a_end] = -V->route[route_after_a].start;
-            V->pred_array[V->route[route_after_a].start] = -a_end;
+            V->set_next(a_end,-V->route[route_after_a].start);
+            V->set_pred(V->route[route_after_a].start,-a_end);
 
-            V->next_array[v_end] = -V->route[route_after_v].start;
-            V->pred_array[V->route[route_after_v].start] = -v_end;
+            V->set_next(v_end,-V->route[route_after_v].start);
+            V->set_pred(V->route[route_after_v].start,-v_end);
 
             return true;
         }
 
         if(route_after_a == 0)
         {
-            V->next_array[a_end] = VRPH_DEPOT;
-            V->pred_array[VRPH_DEPOT] = -a_end;
+            V->set_next(a_end,VRPH_DEPOT);
+            V->set_pred(VRPH_DEPOT,-a_end);
 
-            V->next_array[v_end] = -V->route[route_after_v].start;
-            V->pred_array[V->route[route_after_v].start] = -v_end;
+            V->set_next(v_end,-V->route[route_after_v].start);
+            V->set_pred(V->route[route_after_v].start,-v_end);
 
 
             return true;
@@ -262,12 +262,12 @@ bool SwapEnds::move(VRP *V, int a, int v)
         if(route_after_v == 0)
         {
             
-            V->next_array[v_end] = VRPH_DEPOT;
-            V->pred_array[VRPH_DEPOT] = -v_end;
+            V->set_next(v_end,VRPH_DEPOT);
+            V->set_pred(VRPH_DEPOT,-v_end);
 
-            V->next_array[a_end] = -V->route[route_after_a].start;
+            V->set_next(a_end,-V->route[route_after_a].start);
         
-            V->pred_array[V->route[route_after_a].start] = -a_end;
+            V->set_pred(V->route[route_after_a].start,-a_end);
 
             return true;
         }
@@ -279,11 +279,11 @@ bool SwapEnds::move(VRP *V, int a, int v)
         // If we don't change anything here, then the new V->route_num[v] will point to itself!
         // To fix this, make the new_v_route point 
         
-        V->next_array[a_end] = -v_start;
-        V->pred_array[v_start] = -a_end;
+        V->set_next(a_end,-v_start);
+        V->set_pred(v_start,-a_end);
 
-        V->next_array[v_end] = -a_start;
-        V->pred_array[a_start] = -v_end;
+        V->set_next(v_end,-a_start);
+        V->set_pred(a_start,-v_end);
 
         return true;
 
@@ -296,18 +296,18 @@ bool SwapEnds::move(VRP *V, int a, int v)
         
         // If we don't change anything here, then the new V->route_num[v] will point to itself!
         
-        V->next_array[a_end] = -v_start;
-        V->pred_array[v_start] = -a_end;
+        V->set_next(a_end,-v_start);
+        V->set_pred(v_start,-a_end);
 
         if(route_after_v != VRPH_DEPOT)
         {
-            V->next_array[v_end] = -V->route[route_after_v].start;
-            V->pred_array[V->route[route_after_v].start] = -v_end;
+            V->set_next(v_end,-V->route[route_after_v].start);
+            V->set_pred(V->route[route_after_v].start,-v_end);
         }
         else
         {
-            V->next_array[v_end] = VRPH_DEPOT;
-            V->pred_array[VRPH_DEPOT] = -v_end;
+            V->set_next(v_end,VRPH_DEPOT);
+            V->set_pred(VRPH_DEPOT,-v_end);
         }
 
 #if SWAP_ENDS_VERIFY
@@ -324,18 +324,18 @@ bool SwapEnds::move(VRP *V, int a, int v)
             
         // If we don't change anything here, then the new V->route_num[a] will point to itself!
         
-        V->next_array[v_end] = -a_start;
-        V->pred_array[a_start] = -v_end;
+        V->set_next(v_end,-a_start);
+        V->set_pred(a_start,-v_end);
 
         if(route_after_a!=VRPH_DEPOT)
         {
-            V->next_array[a_end] = -V->route[route_after_a].start;
-            V->pred_array[V->route[route_after_a].start] = -a_end;
+            V->set_next(a_end,-V->route[route_after_a].start);
+            V->set_pred(V->route[route_after_a].start,-a_end);
         }
         else
         {
-            V->next_array[a_end] = VRPH_DEPOT;
-            V->pred_array[VRPH_DEPOT] = -a_end;
+            V->set_next(a_end,VRPH_DEPOT);
+            V->set_pred(VRPH_DEPOT,-a_end);
         }
 
 
@@ -0,0 +1,427 @@
+////////////////////////////////////////////////////////////
+//                                                        //
+// This file is part of the VRPH software package for     //
+// generating solutions to vehicle routing problems.      //
+// VRPH was developed by Chris Groer (cgroer@gmail.com).  //
+//                                                        //
+// (c) Copyright 2010 Chris Groer.                        //
+// All Rights Reserved.  VRPH is licensed under the       //
+// Common Public License.  See LICENSE file for details.  //
+//                                                        //
+////////////////////////////////////////////////////////////
+
+#include "VRPH.h"
+
+
+bool SwapStar::route_search(class VRP *V, int r1, int r2, int rules)
+{
+    ///
+    /// Attempts to find a SWAP* move between routes r1 and r2: customer u
+    /// of r1 and customer v of r2 trade routes, but each goes to its best
+    /// position in the other route rather than to the place of the other.
+    /// The three cheapest insertion positions of every customer in the other
+    /// route are found first, from the insertion cache of V unless edges are
+    /// fixed, so each of the L1*L2 pairs is evaluated in constant time.  If
+    /// the nodes have polar coordinates about the depot, routes whose angular
+    /// sectors do not overlap are skipped.
+    ///
+
+    // Make sure we have two diff. routes!
+    if(r1==r2)
+        return false;
+
+#if SWAP_STAR_DEBUG > 1
+    printf("Evaluating SWAP* move b/w routes %d and %d\n",r1,r2);
+#endif
+
+    int L1, L2, p, q, u, v, x, y, new_load1, new_load2;
+    int *seq1, *seq2;
+    double *rem1, *rem2, ins_u, ins_v, savings, limit;
+    VRPBestInsertions *best1, *best2;
+    bool found;
+
+    VRPMove M;
+    VRPCompactMove Best;
+
+    int accept_type;
+
+    // Default
+    accept_type = VRPH_FIRST_ACCEPT;
+
+    if( (rules & VRPH_LI_ACCEPT) == VRPH_LI_ACCEPT)
+        accept_type = VRPH_LI_ACCEPT;
+
+    if( (rules & VRPH_BEST_ACCEPT) == VRPH_BEST_ACCEPT)
+        accept_type = VRPH_BEST_ACCEPT;
+
+    L1=V->route[r1].num_customers;
+    L2=V->route[r2].num_customers;
+
+    // Neither route may be emptied, even for a moment, since eject_node
+    // would free it
+    if(L1 < 2 || L2 < 2)
+        return false;
+
+    // Skip the search if it failed before and neither route has changed
+    if(V->pair_searched(r1,r2,SWAP_STAR,rules))
+        return false;
+
+    if(V->depot_normalized && !this->sectors_overlap(V,r1,r2))
+    {
+        V->pair_search_failed(r1,r2,SWAP_STAR,rules);
+        return false;
+    }
+
+    // seq1[p] is the customer in position p of route r1, starting at 1,
+    // rem1[p] is the cost saved by removing it, and best1[p] holds its
+    // cheapest insertions into r2.  Likewise for route r2.
+    seq1=new int[(L1+2)+(L2+2)];
+    seq2=seq1+(L1+2);
+    rem1=new double[(L1+2)+(L2+2)];
+    rem2=rem1+(L1+2);
+    best1=new VRPBestInsertions[(L1+2)+(L2+2)];
+    best2=best1+(L1+2);
+
+    seq1[0]=seq1[L1+1]=VRPH_DEPOT;
+    x=V->route[r1].start;
+    for(p=1;p<=L1;p++)
+    {
+        seq1[p]=x;
+        x=VRPH_MAX(V->next_array[x],0);
+    }
+
+    seq2[0]=seq2[L2+1]=VRPH_DEPOT;
+    x=V->route[r2].start;
+    for(q=1;q<=L2;q++)
+    {
+        seq2[q]=x;
+        x=VRPH_MAX(V->next_array[x],0);
+    }
+
+    for(p=1;p<=L1;p++)
+    {
+        u=seq1[p];
+        rem1[p]=V->d[seq1[p-1]][u]+V->d[u][seq1[p+1]]-V->d[seq1[p-1]][seq1[p+1]];
+        if(rules & VRPH_FIXED_EDGES)
+            this->find_best_insertions(V,u,seq2,L2,rules,&best1[p]);
+        else
+            best1[p]=*(V->best_insertions(u,r2));
+    }
+
+    for(q=1;q<=L2;q++)
+    {
+        v=seq2[q];
+        rem2[q]=V->d[seq2[q-1]][v]+V->d[v][seq2[q+1]]-V->d[seq2[q-1]][seq2[q+1]];
+        if(rules & VRPH_FIXED_EDGES)
+            this->find_best_insertions(V,v,seq1,L1,rules,&best2[q]);
+        else
+            best2[q]=*(V->best_insertions(v,r1));
+    }
+
+    limit=V->savings_limit(rules);
+
+    if(rules & VRPH_TABU)
+    {
+        // Record the changes made from here on so that a tabu move
+        // can be undone
+        V->start_journal();
+    }
+
+    found=false;
+
+    for(p=1;p<=L1;p++)
+    {
+        u=seq1[p];
+        if((rules & VRPH_FIXED_EDGES) && (V->is_fixed(seq1[p-1],u) || V->is_fixed(u,seq1[p+1])))
+            continue;
+
+        for(q=1;q<=L2;q++)
+        {
+            v=seq2[q];
+            if((rules & VRPH_FIXED_EDGES) && (V->is_fixed(seq2[q-1],v) || V->is_fixed(v,seq2[q+1])))
+                continue;
+
+            // Reject on load before anything else
+            new_load1=V->route[r1].load-V->demand_array[u]+V->demand_array[v];
+            if(new_load1>V->max_veh_capacity)
+                continue;
+            new_load2=V->route[r2].load-V->demand_array[v]+V->demand_array[u];
+            if(new_load2>V->max_veh_capacity)
+                continue;
+
+            V->num_evaluations[SWAP_STAR_INDEX]++;
+
+            // u goes into r2 once v is gone, and v into r1 once u is gone
+            ins_u=this->best_insertion(V,u,&best1[p],seq2[q-1],v,seq2[q+1],&x);
+            ins_v=this->best_insertion(V,v,&best2[q],seq1[p-1],u,seq1[p+1],&y);
+
+            savings=(ins_v-rem1[p])+(ins_u-rem2[q]);
+            if(savings>limit)
+                continue;
+            if(accept_type!=VRPH_FIRST_ACCEPT && savings>Best.savings)
+                continue;
+
+            M.route_lens[0]=V->route[r1].length+ins_v-rem1[p];
+            M.route_lens[1]=V->route[r2].length+ins_u-rem2[q];
+            if(M.route_lens[0]>V->max_route_length || M.route_lens[1]>V->max_route_length)
+                continue;
+
+            M.evaluated_savings=false;
+            M.savings=savings;
+            M.num_affected_routes=2;
+            M.route_nums[0]=r1;
+            M.route_nums[1]=r2;
+            M.route_custs[0]=L1;
+            M.route_custs[1]=L2;
+            M.route_loads[0]=new_load1;
+            M.route_loads[1]=new_load2;
+            M.new_total_route_length=V->total_route_length+savings;
+            M.total_number_of_routes=V->total_number_of_routes;
+            M.move_type=SWAP_STAR;
+            M.num_arguments=4;
+            M.move_arguments[0]=u; M.move_arguments[1]=x;
+            M.move_arguments[2]=v; M.move_arguments[3]=y;
+
+            if(V->check_move(&M,rules)==false)
+                continue;
+
+            // We have found a valid move.
+            if(accept_type == VRPH_FIRST_ACCEPT || (accept_type==VRPH_LI_ACCEPT && savings<-VRPH_EPSILON) )
+            {
+                // Make the move
+
+                if(this->move(V, &M)==false)
+                    report_error("%s: move error 1\n",__FUNCTION__);
+
+                // Check VRPH_TABU status of move - if it is not ok then
+                // we reverted back - continue the search for a move
+                if(!(rules & VRPH_TABU) || V->check_tabu_status(&M))
+                {
+                    found=true;
+                    goto done;
+                }
+            }
+
+            if(accept_type == VRPH_LI_ACCEPT || accept_type == VRPH_BEST_ACCEPT)
+            {
+                // Check for new best move
+                if(M.is_better(V, &Best, rules))
+                    Best=M;
+            }
+        }
+    }
+
+    if(accept_type==VRPH_FIRST_ACCEPT || Best.savings==VRP_INFINITY)
+    {
+        // No moves found
+        V->pair_search_failed(r1,r2,SWAP_STAR,rules);
+        goto done;
+    }
+
+    Best.expand(&M);
+    if(this->move(V,&M)==false)
+        report_error("%s: best move evaluates to false\n",__FUNCTION__);
+
+    // Check VRPH_TABU status of move - if it is not ok
+    // then we reverted back - search over
+    if(!(rules & VRPH_TABU) || V->check_tabu_status(&M))
+        found=true;
+
+done:
+    if(rules & VRPH_TABU)
+        V->stop_journal();
+
+    // The other arrays share these allocations
+    delete [] seq1;
+    delete [] rem1;
+    delete [] best1;
+
+    return found;
+}
+
+void SwapStar::find_best_insertions(class VRP *V, int u, int *seq, int L, int rules,
+                                    VRPBestInsertions *B)
+{
+    ///
+    /// Finds the VRPH_NUM_BEST_INSERTIONS cheapest places to insert u into
+    /// the route seq[1],...,seq[L], where seq[0] and seq[L+1] are the depot,
+    /// without breaking a fixed edge.
+    ///
+
+    int i, q, x, y;
+    double cost;
+
+    for(i=0;i<VRPH_NUM_BEST_INSERTIONS;i++)
+    {
+        B->cost[i]=VRP_INFINITY;
+        B->after[i]=-1;
+    }
+
+    for(q=0;q<=L;q++)
+    {
+        x=seq[q];
+        y=seq[q+1];
+        if((rules & VRPH_FIXED_EDGES) && V->is_fixed(x,y))
+            continue;
+
+        cost=V->d[x][u]+V->d[u][y]-V->d[x][y];
+        if(cost>=B->cost[VRPH_NUM_BEST_INSERTIONS-1])
+            continue;
+
+        // Insertion sort
+        i=VRPH_NUM_BEST_INSERTIONS-1;
+        while(i>0 && B->cost[i-1]>cost)
+        {
+            B->cost[i]=B->cost[i-1];
+            B->after[i]=B->after[i-1];
+            i--;
+        }
+        B->cost[i]=cost;
+        B->after[i]=x;
+    }
+
+}
+
+double SwapStar::best_insertion(class VRP *V, int u, VRPBestInsertions *B, int t, int v, int w,
+                                int *after)
+{
+    ///
+    /// Returns the cost of inserting u into the route t-v-w once v is
+    /// removed, and sets *after to the node u should follow.  Only the first
+    /// entry of B that does not use the edges t-v or v-w can beat putting u
+    /// in the place of v.
+    ///
+
+    int i;
+    double cost;
+
+    cost=V->d[t][u]+V->d[u][w]-V->d[t][w];
+    *after=t;
+
+    for(i=0;i<VRPH_NUM_BEST_INSERTIONS;i++)
+    {
+        if(B->after[i]!=t && B->after[i]!=v)
+        {
+            if(B->cost[i]<cost)
+            {
+                cost=B->cost[i];
+                *after=B->after[i];
+            }
+            break;
+        }
+    }
+
+    return cost;
+
+}
+
+void SwapStar::find_sector(class VRP *V, int r, double *start, double *width)
+{
+    ///
+    /// Finds a short arc [start, start+width] of polar angles about the
+    /// depot that holds every customer in route r.  The arc is grown
+    /// greedily towards each customer outside it.
+    ///
+
+    int j;
+    double a;
+
+    j=V->route[r].start;
+    *start=V->nodes[j].theta;
+    *width=0;
+
+    j=VRPH_MAX(V->next_array[j],0);
+    while(j!=VRPH_DEPOT)
+    {
+        a=fmod(V->nodes[j].theta-*start+2*VRPH_PI,2*VRPH_PI);
+        if(a>*width)
+        {
+            // Extend the end of the arc or move back its start,
+            // whichever adds less
+            if(a-*width <= 2*VRPH_PI-a)
+                *width=a;
+            else
+            {
+                *width+=2*VRPH_PI-a;
+                *start=V->nodes[j].theta;
+            }
+        }
+        j=VRPH_MAX(V->next_array[j],0);
+    }
+
+}
+
+bool SwapStar::sectors_overlap(class VRP *V, int r1, int r2)
+{
+    ///
+    /// Returns true if the polar sectors of routes r1 and r2 intersect.
+    ///
+
+    double s1, w1, s2, w2;
+
+    this->find_sector(V,r1,&s1,&w1);
+    this->find_sector(V,r2,&s2,&w2);
+
+    if(fmod(s2-s1+2*VRPH_PI,2*VRPH_PI)<=w1+VRPH_EPSILON)
+        return true;
+    if(fmod(s1-s2+2*VRPH_PI,2*VRPH_PI)<=w2+VRPH_EPSILON)
+        return true;
+
+    return false;
+
+}
+
+bool SwapStar::move(class VRP *V, VRPMove *M)
+{
+    ///
+    /// Makes the SWAP* move M: u=M->move_arguments[0] is placed after
+    /// M->move_arguments[1] in the route of v=M->move_arguments[2], and v
+    /// after M->move_arguments[3] in the route of u.  An argument of
+    /// VRPH_DEPOT means the start of the route.
+    ///
+
+    int u, x, v, y, ru, rv;
+
+    u=M->move_arguments[0]; x=M->move_arguments[1];
+    v=M->move_arguments[2]; y=M->move_arguments[3];
+
+#if SWAP_STAR_DEBUG
+    printf("SWAP* move: %d after %d, %d after %d\n",u,x,v,y);
+    V->show_route(V->route_num[u]);
+    V->show_route(V->route_num[v]);
+#endif
+
+    ru=V->route_num[u];
+    rv=V->route_num[v];
+
+    V->eject_node(u);
+    V->eject_node(v);
+
+    if(x==VRPH_DEPOT)
+        V->insert_node(u,VRPH_DEPOT,V->route[rv].start);
+    else
+        V->insert_node(u,x,VRPH_MAX(V->next_array[x],VRPH_DEPOT));
+
+    if(y==VRPH_DEPOT)
+        V->insert_node(v,VRPH_DEPOT,V->route[ru].start);
+    else
+        V->insert_node(v,y,VRPH_MAX(V->next_array[y],VRPH_DEPOT));
+
+#if SWAP_STAR_DEBUG
+    printf("Routes after SWAP* move\n");
+    V->show_route(ru);
+    V->show_route(rv);
+#endif
+
+#if SWAP_STAR_VERIFY
+    V->verify_routes("After SWAP* move\n");
+#endif
+
+    V->num_moves[SWAP_STAR_INDEX]++;
+
+    V->capture_best_solution();
+
+    return true;
+
+}
+
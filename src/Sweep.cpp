@@ -75,8 +75,8 @@ bool Sweep::Construct(class VRP *V)
             pos%n, T[(pos+1)%n].k, T[pos%n].k);
 #endif
  
-        post=postsert.evaluate(V,T[(pos+1)%n].k, T[pos%n].k, &M1);
-        pre=presert.evaluate(V,T[(pos+1)%n].k, T[pos%n].k, &M2);
+        post=postsert.evaluate(V,T[(pos+1)%n].k, T[pos%n].k, &M1) && V->is_feasible(&M1,0);
+        pre=presert.evaluate(V,T[(pos+1)%n].k, T[pos%n].k, &M2) && V->is_feasible(&M2,0);
         
         if(post || pre)
         {
@@ -12,6 +12,56 @@
 
 #include "VRPH.h"
 
+ThreeOpt::ThreeOpt()
+{
+    ///
+    /// Default constructor for ThreeOpt.  The arrays for searching copies
+    /// of routes are allocated when the first copy is made.
+    ///
+
+    this->L=0;
+    this->len=0;
+    this->seq=NULL;
+    this->pos=NULL;
+    this->arrival=NULL;
+    this->wait=NULL;
+    this->slack=NULL;
+    this->seq_size=0;
+    this->pos_size=0;
+    this->best_type=0;
+    this->best_savings=VRP_INFINITY;
+    this->have_best=false;
+    this->path=NULL;
+    this->path_savings=NULL;
+    this->path_size=0;
+    this->num_path_moves=0;
+    this->num_copy_evaluations=0;
+
+}
+
+ThreeOpt::~ThreeOpt()
+{
+    ///
+    /// Destructor for ThreeOpt.
+    ///
+
+    if(this->seq)
+        delete [] this->seq;
+    if(this->pos)
+        delete [] this->pos;
+    if(this->arrival)
+        delete [] this->arrival;
+    if(this->wait)
+        delete [] this->wait;
+    if(this->slack)
+        delete [] this->slack;
+    if(this->path)
+        delete [] this->path;
+    if(this->path_savings)
+        delete [] this->path_savings;
+
+}
+
 // SEARCH
 bool ThreeOpt::route_search(class VRP *V, int r, int rules)
 {
@@ -19,6 +69,8 @@ bool ThreeOpt::route_search(class VRP *V, int r, int rules)
     /// Searches for a Three-Opt move in route r.
     /// If a satisfactory move is found,
     /// then the move is made.  If no move is found, false is returned.
+    /// With VRPH_USE_NEIGHBOR_LIST only moves built from neighbor list
+    /// edges are considered.
     ///
 
     VRPMove M, BestM;
@@ -36,7 +88,7 @@ bool ThreeOpt::route_search(class VRP *V, int r, int rules)
     e11=e12=e21=e22=e31=e32=0;    
 
     if( (rules & VRPH_USE_NEIGHBOR_LIST) > 0)
-        report_error("%s: neighbor_list not used in 3OPT search--searches all nodes in route\n",__FUNCTION__);
+        return neighbor_search(V,r,rules);
 
     accept_type = VRPH_FIRST_ACCEPT;    //default
 
@@ -72,12 +124,11 @@ bool ThreeOpt::route_search(class VRP *V, int r, int rules)
     c_end = VRPH_MAX(VRPH_DEPOT, V->pred_array[V->route[r].end]);
     e_end = V->route[r].end;
 
-    int *old_sol=NULL;
     if(rules & VRPH_TABU)
     {
-        // Remember the original solution 
-        old_sol=new int[V->num_original_nodes+2];
-        V->export_solution_buff(old_sol);
+        // Record the changes made from here on so that a tabu move
+        // can be undone
+        V->start_journal();
     }
 
 
@@ -98,10 +149,10 @@ bool ThreeOpt::route_search(class VRP *V, int r, int rules)
                 else
                 {
                     // Check VRPH_TABU status of move - return true if its ok
-                    // or revert to old_sol if not and continue to search.
-                    if(V->check_tabu_status(&M, old_sol))
+                    // or undo it if not and continue to search.
+                    if(V->check_tabu_status(&M))
                     {
-                        delete [] old_sol;
+                        V->stop_journal();
                         return true; // The move was ok
                     }
                     // else we reverted back - continue the search for a move
@@ -146,10 +197,10 @@ bool ThreeOpt::route_search(class VRP *V, int r, int rules)
                             else
                             {
                                 // Check VRPH_TABU status of move - return true if its ok
-                                // or revert to old_sol if not and continue to search.
-                                if(V->check_tabu_status(&M, old_sol))
+                                // or undo it if not and continue to search.
+                                if(V->check_tabu_status(&M))
                                 {
-                                    delete [] old_sol;
+                                    V->stop_journal();
                                     return true; // The move was ok
                                 }
                                 // else we reverted back - continue the search for a move
@@ -188,14 +239,14 @@ bool ThreeOpt::route_search(class VRP *V, int r, int rules)
             else
             {
                 // Check VRPH_TABU status of move - return true if its ok
-                // or revert to old_sol if not and continue to search.
-                if(V->check_tabu_status(&BestM, old_sol))
+                // or undo it if not and continue to search.
+                if(V->check_tabu_status(&BestM))
                 {
-                    delete [] old_sol;
+                    V->stop_journal();
                     return true; // The move was ok
                 }
                 // else we reverted back - search over
-                delete [] old_sol;
+                V->stop_journal();
                 return false;
 
             }
@@ -211,6 +262,402 @@ bool ThreeOpt::route_search(class VRP *V, int r, int rules)
     return false;
 }
 
+bool ThreeOpt::neighbor_search(class VRP *V, int r, int rules)
+{
+    ///
+    /// Searches for a Three-Opt move in route r whose new edges include
+    /// t2-t3 and t4-t5 where t3 is in the neighbor list of t2 and t5 is in
+    /// the neighbor list of t4.  The removed edges are t1-t2, t3-t4 and
+    /// t5-t6.  In a downhill search the partial gains must remain positive,
+    /// so each sorted neighbor list is cut off at the first candidate that
+    /// fails.  Every reconnection of the three edges is tried by evaluate(),
+    /// including the segment insertion (or-3opt) one.
+    ///
+
+    VRPMove M, BestM;
+    int i,j,k,L,p,x,q1,q2,n1,n2,accept_type;
+    int p1,p2,p3,p4,p5,p6,t2,t3,t4,t5;
+    int e[3],p3s[2],p5s[2];
+    int *seq, *pos;
+    double g1,g2;
+    bool gain_rule, found;
+
+    BestM.savings=VRP_INFINITY;
+
+    accept_type = VRPH_FIRST_ACCEPT;    //default
+
+    if( (rules & VRPH_LI_ACCEPT) == VRPH_LI_ACCEPT)
+        accept_type=VRPH_LI_ACCEPT;
+
+    if( (rules & VRPH_BEST_ACCEPT) == VRPH_BEST_ACCEPT)
+        accept_type=VRPH_BEST_ACCEPT;
+
+    // Same minimum route size as the full search
+    L=V->route[r].num_customers;
+    if(L<4)
+        return false;
+
+    gain_rule=false;
+    if( (rules & VRPH_DOWNHILL) && !(rules & (VRPH_RECORD_TO_RECORD | 
+        VRPH_SIMULATED_ANNEALING | VRPH_MINIMIZE_NUM_ROUTES)) )
+        gain_rule=true;
+
+    // seq[p] is the node in position p of the route, with the VRPH_DEPOT at
+    // both 0 and L+1, and pos[] is the inverse for the customers.
+    // Edge p is seq[p]-seq[p+1].
+    seq=new int[L+2];
+    pos=new int[V->num_original_nodes+2];
+    seq[0]=VRPH_DEPOT;
+    seq[L+1]=VRPH_DEPOT;
+    x=V->route[r].start;
+    for(p=1;p<=L;p++)
+    {
+        seq[p]=x;
+        pos[x]=p;
+        x=VRPH_MAX(V->next_array[x],0);
+    }
+
+    if(rules & VRPH_TABU)
+    {
+        // Record the changes made from here on so that a tabu move
+        // can be undone
+        V->start_journal();
+    }
+
+    found=false;
+    for(p2=0;p2<=L+1;p2++)
+    {
+        t2=seq[p2];
+        for(i=0;i<2;i++)
+        {
+            // t1 is the predecessor or the successor of t2
+            p1=(i==0 ? p2-1 : p2+1);
+            if(p1<0 || p1>L+1)
+                continue;
+
+            for(j=0;j<V->neighbor_list_size;j++)
+            {
+                t3=V->nodes[t2].neighbor_list[j].position;
+                g1=V->d[seq[p1]][t2]-V->d[t2][t3];
+                if(gain_rule && g1<=VRPH_EPSILON)
+                    break;
+
+                n1=route_positions(V,r,t3,pos,p3s);
+                for(q1=0;q1<n1;q1++)
+                {
+                    p3=p3s[q1];
+                    for(p4=p3-1;p4<=p3+1;p4+=2)
+                    {
+                        if(p4<0 || p4>L+1)
+                            continue;
+
+                        t4=seq[p4];
+                        g2=g1+V->d[t3][t4];
+                        for(k=0;k<V->neighbor_list_size;k++)
+                        {
+                            t5=V->nodes[t4].neighbor_list[k].position;
+                            if(gain_rule && g2-V->d[t4][t5]<=VRPH_EPSILON)
+                                break;
+
+                            n2=route_positions(V,r,t5,pos,p5s);
+                            for(q2=0;q2<n2;q2++)
+                            {
+                                p5=p5s[q2];
+                                for(p6=p5-1;p6<=p5+1;p6+=2)
+                                {
+                                    if(p6<0 || p6>L+1)
+                                        continue;
+
+                                    // Put the three removed edges in route order
+                                    e[0]=VRPH_MIN(p1,p2);
+                                    e[1]=VRPH_MIN(p3,p4);
+                                    e[2]=VRPH_MIN(p5,p6);
+                                    if(e[0]>e[1]) { x=e[0]; e[0]=e[1]; e[1]=x; }
+                                    if(e[1]>e[2]) { x=e[1]; e[1]=e[2]; e[2]=x; }
+                                    if(e[0]>e[1]) { x=e[0]; e[0]=e[1]; e[1]=x; }
+
+                                    // Each segment between the edges needs two nodes and,
+                                    // as in the full search, the last edge may not end
+                                    // at the VRPH_DEPOT
+                                    if(e[1]<e[0]+2 || e[2]<e[1]+2 || e[2]>L-1)
+                                        continue;
+
+                                    if(evaluate(V,seq[e[0]],seq[e[0]+1],seq[e[1]],seq[e[1]+1],
+                                        seq[e[2]],seq[e[2]+1],rules,&M)==false)
+                                        continue;
+
+                                    if(accept_type==VRPH_FIRST_ACCEPT || 
+                                        ((accept_type==VRPH_LI_ACCEPT)&&M.savings<-VRPH_EPSILON))
+                                    {
+                                        // Make the move
+                                        if(move(V, &M)==false)
+                                            report_error("%s: move error 1\n",__FUNCTION__);
+
+                                        if(!(rules & VRPH_TABU) || V->check_tabu_status(&M))
+                                        {
+                                            found=true;
+                                            goto done;
+                                        }
+                                        // else we reverted back - continue the search for a move
+                                    }
+
+                                    if(accept_type==VRPH_BEST_ACCEPT || accept_type==VRPH_LI_ACCEPT)
+                                    {
+                                        if(M.is_better(V, &BestM, rules))
+                                            BestM=M;
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if(accept_type!=VRPH_FIRST_ACCEPT && BestM.savings!=VRP_INFINITY)
+    {
+        if(move(V,&BestM)==false)
+            report_error("%s: best move evaluates to false\n",__FUNCTION__);
+
+        // Check VRPH_TABU status of move - if it is not ok
+        // then we reverted back and the search is over
+        if(!(rules & VRPH_TABU) || V->check_tabu_status(&BestM))
+            found=true;
+    }
+
+done:
+    if(rules & VRPH_TABU)
+        V->stop_journal();
+
+    delete [] seq;
+    delete [] pos;
+
+    return found;
+
+}
+
+bool ThreeOpt::search_routes(class VRP *V, int rules)
+{
+    ///
+    /// Searches every route of V that the route memo does not know to be
+    /// THREE_OPT optimal with search_routes() below.  Returns true if any
+    /// route was improved.
+    ///
+
+    int r,R,num_routes,memo_heuristics;
+    int *routes;
+    bool fixed, improved;
+
+    R=V->total_number_of_routes;
+    fixed=((rules & VRPH_FIXED_EDGES)!=0);
+    memo_heuristics=THREE_OPT+(rules & VRPH_USE_NEIGHBOR_LIST);
+
+    routes=new int[R+1];
+    num_routes=0;
+    for(r=1;r<=R;r++)
+    {
+        if(V->route[r].num_customers==0)
+            continue;
+        if(!fixed && V->route_is_optimal(r,memo_heuristics))
+            continue;
+        routes[num_routes++]=r;
+    }
+
+    improved=this->search_routes(V,num_routes,routes,rules);
+
+    delete [] routes;
+
+    return improved;
+
+}
+
+bool ThreeOpt::search_routes(class VRP *V, int num_routes, int *routes, int rules)
+{
+    ///
+    /// Brings each of the given routes to a local minimum by repeating
+    /// route_search() with the VRPH_DOWNHILL rules.  Each route is copied
+    /// into a sequence and searched there, so the routes are searched in
+    /// parallel when VRPH is built with OpenMP, each thread with its own
+    /// copy.  The moves found are then made in rounds, the k-th move of
+    /// every route in route order in round k, which is the order in which
+    /// calling route_search() on each route in turn until the total length
+    /// stops changing makes them.  capture_best_solution() may reverse
+    /// other routes when it stores a solution, so a route that is not
+    /// found as its copy expects is searched with route_search() from then
+    /// on.  The result is therefore the same as that of the serial search
+    /// and does not depend on the number of threads.  Returns true if any
+    /// route was improved.
+    ///
+
+    VRPMove M;
+    int i,j,k,r,memo_heuristics;
+    int *num_moves, *num_evals, *first, *state;
+    int **paths;
+    double **savings;
+    bool *optimal;
+    bool fixed, improved;
+    double start_val;
+    int *q;
+
+    fixed=((rules & VRPH_FIXED_EDGES)!=0);
+    memo_heuristics=THREE_OPT+(rules & VRPH_USE_NEIGHBOR_LIST);
+
+    if( !(rules & VRPH_DOWNHILL) || (rules & VRPH_TABU) )
+    {
+        // The copies are searched with the VRPH_DOWNHILL rules only
+        improved=false;
+        for(i=0;i<num_routes;i++)
+        {
+            while(this->route_search(V,routes[i],rules))
+                improved=true;
+        }
+        return improved;
+    }
+
+    num_moves=new int[num_routes+1];
+    num_evals=new int[num_routes+1];
+    first=new int[num_routes+1];
+    state=new int[num_routes+1];
+    paths=new int *[num_routes+1];
+    savings=new double *[num_routes+1];
+    optimal=new bool[num_routes+1];
+
+#ifdef _OPENMP
+#pragma omp parallel if(num_routes>1)
+#endif
+    {
+        ThreeOpt ThreeO;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for(j=0;j<num_routes;j++)
+        {
+            optimal[j]=ThreeO.copy_search(V,routes[j],rules);
+            num_moves[j]=ThreeO.num_path_moves;
+            num_evals[j]=ThreeO.num_copy_evaluations;
+            first[j]=ThreeO.seq[1];
+            paths[j]=NULL;
+            savings[j]=NULL;
+            if(num_moves[j]>0)
+            {
+                paths[j]=new int[8*num_moves[j]];
+                savings[j]=new double[num_moves[j]];
+                memcpy(paths[j],ThreeO.path,8*num_moves[j]*sizeof(int));
+                memcpy(savings[j],ThreeO.path_savings,num_moves[j]*sizeof(double));
+            }
+        }
+    }
+
+    // Make the moves.  state[i] is 0 while the moves of the copy are made,
+    // 1 once the route is searched with route_search() and 2 when it is done.
+    improved=false;
+    for(i=0;i<num_routes;i++)
+        state[i]=0;
+
+    k=0;
+    do
+    {
+        start_val=V->total_route_length;
+        for(i=0;i<num_routes;i++)
+        {
+            r=routes[i];
+            if(state[i]==0 && k<num_moves[i])
+            {
+                // The route must still be as the copy was before the move
+                q=paths[i]+8*k;
+                if( (q[0]==VRPH_DEPOT ? V->route[r].start : V->next_array[q[0]])==q[1] &&
+                    V->next_array[q[2]]==q[3] && V->next_array[q[4]]==q[5] )
+                {
+                    for(j=0;j<6;j++)
+                        M.eval_arguments[j]=q[j];
+                    M.move_arguments[0]=q[6];
+                    M.savings=savings[i][k];
+                    V->num_evaluations[THREE_OPT_INDEX]+=q[7];
+                    if(this->move(V,&M)==false)
+                        report_error("%s: move error\n",__FUNCTION__);
+                    improved=true;
+                    continue;
+                }
+                state[i]=1;
+            }
+            else if(state[i]==0)
+            {
+                // The search of the copy ended here
+                if(V->route[r].start==first[i] || !optimal[i])
+                {
+                    V->num_evaluations[THREE_OPT_INDEX]+=num_evals[i];
+                    if(optimal[i] && !fixed)
+                        V->route_found_optimal(r,memo_heuristics);
+                    state[i]=2;
+                    continue;
+                }
+                state[i]=1;
+            }
+
+            if(state[i]==1)
+            {
+                if(this->route_search(V,r,rules))
+                    improved=true;
+                else
+                {
+                    if(!fixed)
+                        V->route_found_optimal(r,memo_heuristics);
+                    state[i]=2;
+                }
+            }
+        }
+        k++;
+    }
+    while(VRPH_ABS(V->total_route_length-start_val)>=VRPH_EPSILON);
+
+#if THREE_OPT_VERIFY
+    V->verify_routes("After THREE_OPT search_routes\n");
+#endif
+
+    for(i=0;i<num_routes;i++)
+    {
+        if(paths[i])
+            delete [] paths[i];
+        if(savings[i])
+            delete [] savings[i];
+    }
+    delete [] num_moves;
+    delete [] num_evals;
+    delete [] first;
+    delete [] state;
+    delete [] paths;
+    delete [] savings;
+    delete [] optimal;
+
+    return improved;
+
+}
+
+int ThreeOpt::route_positions(class VRP *V, int r, int t, int *pos, int *p)
+{
+    ///
+    /// Stores the positions of node t in route r in p[] using the position
+    /// array pos[] and returns how many there are.  The VRPH_DEPOT is at
+    /// both ends of the route.
+    ///
+
+    if(t==VRPH_DEPOT)
+    {
+        p[0]=0;
+        p[1]=V->route[r].num_customers+1;
+        return 2;
+    }
+
+    if(t>V->num_original_nodes || V->routed[t]==false || V->route_num[t]!=r)
+        return 0;
+
+    p[0]=pos[t];
+    return 1;
+
+}
+
 bool ThreeOpt::evaluate(class VRP *V, int a, int b, int c, int d, int e, int f,
                         int rules, VRPMove *M)
 {
@@ -232,7 +679,7 @@ bool ThreeOpt::evaluate(class VRP *V, int a, int b, int c, int d, int e, int f,
     if(rules & VRPH_FIXED_EDGES)
     {
         // Make sure we aren't disturbing fixed edges
-        if( V->fixed[a][b] || V->fixed[c][d] || V->fixed[e][f]) 
+        if( V->is_fixed(a,b) || V->is_fixed(c,d) || V->is_fixed(e,f)) 
             return false;
 
     }
@@ -290,7 +737,9 @@ bool ThreeOpt::evaluate(class VRP *V, int a, int b, int c, int d, int e, int f,
     M->new_total_route_length=V->total_route_length+M->savings;
     M->eval_arguments[0]=a;M->eval_arguments[1]=b;M->eval_arguments[2]=c;
     M->eval_arguments[3]=d;M->eval_arguments[4]=e;M->eval_arguments[5]=f;
-    M->move_type=type;
+    M->move_type=THREE_OPT;
+    M->num_arguments=1;
+    M->move_arguments[0]=type;
 
     // Now check the move
     if(V->check_move(M,rules)==true)
@@ -337,7 +786,10 @@ bool ThreeOpt::move(class VRP *V, VRPMove *M)// int a, int b, int c, int d, int
     // INTRAROUTE CASE:
     if(a_route==c_route && c_route==e_route)
     {
-        int type = M->move_type;
+        // Some cases modify the route directly
+        V->journal_route_info(a_route);
+
+        int type = M->move_arguments[0];
 
 
         //// Now find the best of these - no need to check load here since it's INTRA only
@@ -355,6 +807,9 @@ bool ThreeOpt::move(class VRP *V, VRPMove *M)// int a, int b, int c, int d, int
 
         a_route= V->route_num[b];// b is not VRPH_DEPOT
 
+        // Some of the cases below relink the route directly
+        V->route_changed(a_route);
+
         oldlen= V->route[a_route].length;
         oldobj= V->total_route_length;
 
@@ -437,27 +892,27 @@ bool ThreeOpt::move(class VRP *V, VRPMove *M)// int a, int b, int c, int d, int
 
             if(a!=VRPH_DEPOT && f!=VRPH_DEPOT)
             {
-                V->next_array[a]=d;
-                V->pred_array[d]=a;
+                V->set_next(a,d);
+                V->set_pred(d,a);
 
-                V->next_array[e]=b;
-                V->pred_array[b]=e;
+                V->set_next(e,b);
+                V->set_pred(b,e);
 
-                V->next_array[c]=f;
-                V->pred_array[f]=c;
+                V->set_next(c,f);
+                V->set_pred(f,c);
             }
 
             if(a==VRPH_DEPOT && f!=VRPH_DEPOT)
             {
                 int prev_end=VRPH_ABS(V->pred_array[b]);
-                V->next_array[prev_end] = -d;
-                V->pred_array[d] = -prev_end;
+                V->set_next(prev_end,-d);
+                V->set_pred(d,-prev_end);
 
-                V->next_array[e]=b;
-                V->pred_array[b]=e;
+                V->set_next(e,b);
+                V->set_pred(b,e);
 
-                V->next_array[c]=f;
-                V->pred_array[f]=c;
+                V->set_next(c,f);
+                V->set_pred(f,c);
 
                 V->route[a_route].start=d;///!!!!
             }
@@ -465,14 +920,14 @@ bool ThreeOpt::move(class VRP *V, VRPMove *M)// int a, int b, int c, int d, int
             if(a!=VRPH_DEPOT && f==VRPH_DEPOT)
             {
                 int prev_start=VRPH_ABS(V->next_array[e]);
-                V->pred_array[prev_start] = -c;
-                V->next_array[c] = -prev_start;
+                V->set_pred(prev_start,-c);
+                V->set_next(c,-prev_start);
 
-                V->next_array[e]=b;
-                V->pred_array[b]=e;
+                V->set_next(e,b);
+                V->set_pred(b,e);
 
-                V->next_array[a]=d;
-                V->pred_array[d]=a;
+                V->set_next(a,d);
+                V->set_pred(d,a);
             }
 
             if(a==VRPH_DEPOT && f==VRPH_DEPOT)
@@ -481,14 +936,14 @@ bool ThreeOpt::move(class VRP *V, VRPMove *M)// int a, int b, int c, int d, int
                 int prev_start=VRPH_ABS(V->next_array[e]);
 
 
-                V->next_array[prev_end]=-b;
-                V->pred_array[b]=-prev_end;
+                V->set_next(prev_end,-b);
+                V->set_pred(b,-prev_end);
 
-                V->next_array[e]=b;
-                V->pred_array[b]=e;
+                V->set_next(e,b);
+                V->set_pred(b,e);
 
-                V->next_array[c]=-prev_start;
-                V->pred_array[prev_start]=-c;
+                V->set_next(c,-prev_start);
+                V->set_pred(prev_start,-c);
 
                 V->route[a_route].start=d;///!!!!
 
@@ -530,31 +985,31 @@ bool ThreeOpt::move(class VRP *V, VRPMove *M)// int a, int b, int c, int d, int
             if(a==VRPH_DEPOT)
             {
 
-                V->next_array[prev_end]=-d;
-                V->pred_array[d]=-prev_end;
+                V->set_next(prev_end,-d);
+                V->set_pred(d,-prev_end);
                 V->route[a_route].start=d; //!!!
             }
             else
             {
-                V->next_array[a]=d;
-                V->pred_array[d]=a;
+                V->set_next(a,d);
+                V->set_pred(d,a);
             }
 
             if(f==VRPH_DEPOT)
             {
                 int prev_start=VRPH_ABS(V->next_array[e]);
-                V->next_array[b]=-prev_start;
-                V->pred_array[prev_start]=-b;
+                V->set_next(b,-prev_start);
+                V->set_pred(prev_start,-b);
 
             }
             else
             {
-                V->next_array[b]=f;
-                V->pred_array[f]=b;
+                V->set_next(b,f);
+                V->set_pred(f,b);
             }
 
-            V->next_array[e]=c;
-            V->pred_array[c]=e;
+            V->set_next(e,c);
+            V->set_pred(c,e);
 
 
 
@@ -594,30 +1049,30 @@ bool ThreeOpt::move(class VRP *V, VRPMove *M)// int a, int b, int c, int d, int
             if(a==VRPH_DEPOT)
             {
 
-                V->next_array[prev_end]=-e;
-                V->pred_array[e]=-prev_end;
+                V->set_next(prev_end,-e);
+                V->set_pred(e,-prev_end);
                 V->route[V->route_num[b]].start=e;
             }
             else
             {
-                V->next_array[a]=e;
-                V->pred_array[e]=a;
+                V->set_next(a,e);
+                V->set_pred(e,a);
             }
 
-            V->next_array[d]=b;
-            V->pred_array[b]=d;
+            V->set_next(d,b);
+            V->set_pred(b,d);
 
             if(f==VRPH_DEPOT)
             {
                 int prev_start=VRPH_ABS(V->next_array[e]);
-                V->next_array[c]=-prev_start;
-                V->pred_array[prev_start]=-c;
+                V->set_next(c,-prev_start);
+                V->set_pred(prev_start,-c);
 
             }
             else
             {
-                V->next_array[c]=f;
-                V->pred_array[f]=c;
+                V->set_next(c,f);
+                V->set_pred(f,c);
             }
 
             //Now manually adjust the route_len and obj. value
@@ -678,4 +1133,572 @@ bool ThreeOpt::move(class VRP *V, VRPMove *M)// int a, int b, int c, int d, int
 
 }
 
+bool ThreeOpt::copy_search(class VRP *V, int r, int rules)
+{
+    ///
+    /// Copies route r into seq[] and repeats the search route_search()
+    /// would make on it, making each move found on the copy, until no
+    /// move is found.  Only V's instance data and the nodes' route numbers
+    /// are read, so different routes can be searched at the same time.  The
+    /// moves are left in path[], each with the number of evaluations of the
+    /// search that found it, and the evaluations of the last search, which
+    /// found no move, in num_copy_evaluations.  Returns false if the search
+    /// stopped before a local minimum because a move would not be made in
+    /// full by move() (a reversal in it then exceeds the maximum route
+    /// length).
+    ///
+
+    int p,x,evals;
+
+    this->L=V->route[r].num_customers;
+    this->len=V->route[r].length;
+    this->num_path_moves=0;
+    this->num_copy_evaluations=0;
+
+    if(this->L+2>this->seq_size)
+    {
+        if(this->seq)
+            delete [] this->seq;
+        if(this->arrival)
+            delete [] this->arrival;
+        if(this->wait)
+            delete [] this->wait;
+        if(this->slack)
+            delete [] this->slack;
+        this->seq_size=this->L+2;
+        this->seq=new int[this->seq_size];
+        this->arrival=new double[this->seq_size];
+        this->wait=new double[this->seq_size];
+        this->slack=new double[this->seq_size];
+    }
+    if(V->num_original_nodes+2>this->pos_size)
+    {
+        if(this->pos)
+            delete [] this->pos;
+        this->pos_size=V->num_original_nodes+2;
+        this->pos=new int[this->pos_size];
+    }
+
+    this->seq[0]=VRPH_DEPOT;
+    this->seq[this->L+1]=VRPH_DEPOT;
+    x=V->route[r].start;
+    for(p=1;p<=this->L;p++)
+    {
+        this->seq[p]=x;
+        this->pos[x]=p;
+        x=VRPH_MAX(V->next_array[x],0);
+    }
+
+    if(V->has_time_windows)
+        this->copy_times(V);
+
+    evals=0;
+    while(this->copy_step(V,r,rules))
+    {
+        if(this->num_path_moves==this->path_size)
+        {
+            int *new_path;
+            double *new_savings;
+
+            this->path_size=VRPH_MAX(2*this->path_size,16);
+            new_path=new int[8*this->path_size];
+            new_savings=new double[this->path_size];
+            if(this->path)
+            {
+                memcpy(new_path,this->path,8*this->num_path_moves*sizeof(int));
+                memcpy(new_savings,this->path_savings,this->num_path_moves*sizeof(double));
+                delete [] this->path;
+                delete [] this->path_savings;
+            }
+            this->path=new_path;
+            this->path_savings=new_savings;
+        }
+
+        for(p=0;p<6;p++)
+            this->path[8*this->num_path_moves+p]=this->seq[this->best_p[p]];
+        this->path[8*this->num_path_moves+6]=this->best_type;
+        this->path[8*this->num_path_moves+7]=this->num_copy_evaluations-evals;
+        this->path_savings[this->num_path_moves]=this->best_savings;
+        evals=this->num_copy_evaluations;
+
+        if(this->copy_move(V)==false)
+        {
+            this->num_copy_evaluations=0;
+            return false;
+        }
+
+        this->num_path_moves++;
+    }
+
+    // Leave the evaluations of the last search
+    this->num_copy_evaluations-=evals;
+
+    return true;
+
+}
+
+bool ThreeOpt::copy_step(class VRP *V, int r, int rules)
+{
+    ///
+    /// Finds the move that route_search() would make on the copy of
+    /// route r, with or without VRPH_USE_NEIGHBOR_LIST, and leaves it in
+    /// best_p[], best_type and best_savings.  Returns false if there is
+    /// none.
+    ///
+
+    int i,j,k,x,q1,q2,n1,n2,accept_type;
+    int p1,p2,p3,p4,p5,p6,t2,t3,t4,t5;
+    int p[6],p3s[2],p5s[2];
+    double g1,g2;
+    bool gain_rule;
+
+    this->have_best=false;
+
+    accept_type = VRPH_FIRST_ACCEPT;    //default
+
+    if( (rules & VRPH_LI_ACCEPT) == VRPH_LI_ACCEPT)
+        accept_type=VRPH_LI_ACCEPT;
+
+    if( (rules & VRPH_BEST_ACCEPT) == VRPH_BEST_ACCEPT)
+        accept_type=VRPH_BEST_ACCEPT;
+
+    if( !(rules & VRPH_USE_NEIGHBOR_LIST) )
+    {
+        // The edges of route_search() in order, starting with a at the
+        // VRPH_DEPOT and then with a from the first customer on
+        if(this->L<5)
+            return false;
+
+        for(i=0;i<6;i++)
+            p[i]=i;
+        if(this->copy_try(V,p,rules,accept_type))
+            return true;
+
+        for(p[0]=1;p[0]!=this->L-3;p[0]++)
+        {
+            p[1]=p[0]+1;
+            for(p[2]=p[1]+1;p[2]!=this->L-1;p[2]++)
+            {
+                p[3]=p[2]+1;
+                for(p[4]=p[3]+1;p[4]!=this->L;p[4]++)
+                {
+                    p[5]=p[4]+1;
+                    if(this->copy_try(V,p,rules,accept_type))
+                        return true;
+                }
+            }
+        }
+
+        return this->have_best;
+    }
+
+    // The neighbor list search of neighbor_search()
+    if(this->L<4)
+        return false;
+
+    gain_rule=false;
+    if( (rules & VRPH_DOWNHILL) && !(rules & (VRPH_RECORD_TO_RECORD | 
+        VRPH_SIMULATED_ANNEALING | VRPH_MINIMIZE_NUM_ROUTES)) )
+        gain_rule=true;
+
+    for(p2=0;p2<=this->L+1;p2++)
+    {
+        t2=this->seq[p2];
+        for(i=0;i<2;i++)
+        {
+            p1=(i==0 ? p2-1 : p2+1);
+            if(p1<0 || p1>this->L+1)
+                continue;
+
+            for(j=0;j<V->neighbor_list_size;j++)
+            {
+                t3=V->nodes[t2].neighbor_list[j].position;
+                g1=V->d[this->seq[p1]][t2]-V->d[t2][t3];
+                if(gain_rule && g1<=VRPH_EPSILON)
+                    break;
+
+                n1=this->route_positions(V,r,t3,this->pos,p3s);
+                for(q1=0;q1<n1;q1++)
+                {
+                    p3=p3s[q1];
+                    for(p4=p3-1;p4<=p3+1;p4+=2)
+                    {
+                        if(p4<0 || p4>this->L+1)
+                            continue;
+
+                        t4=this->seq[p4];
+                        g2=g1+V->d[t3][t4];
+                        for(k=0;k<V->neighbor_list_size;k++)
+                        {
+                            t5=V->nodes[t4].neighbor_list[k].position;
+                            if(gain_rule && g2-V->d[t4][t5]<=VRPH_EPSILON)
+                                break;
+
+                            n2=this->route_positions(V,r,t5,this->pos,p5s);
+                            for(q2=0;q2<n2;q2++)
+                            {
+                                p5=p5s[q2];
+                                for(p6=p5-1;p6<=p5+1;p6+=2)
+                                {
+                                    if(p6<0 || p6>this->L+1)
+                                        continue;
+
+                                    p[0]=VRPH_MIN(p1,p2);
+                                    p[2]=VRPH_MIN(p3,p4);
+                                    p[4]=VRPH_MIN(p5,p6);
+                                    if(p[0]>p[2]) { x=p[0]; p[0]=p[2]; p[2]=x; }
+                                    if(p[2]>p[4]) { x=p[2]; p[2]=p[4]; p[4]=x; }
+                                    if(p[0]>p[2]) { x=p[0]; p[0]=p[2]; p[2]=x; }
+
+                                    if(p[2]<p[0]+2 || p[4]<p[2]+2 || p[4]>this->L-1)
+                                        continue;
+
+                                    p[1]=p[0]+1;
+                                    p[3]=p[2]+1;
+                                    p[5]=p[4]+1;
+                                    if(this->copy_try(V,p,rules,accept_type))
+                                        return true;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return this->have_best;
+
+}
+
+bool ThreeOpt::copy_try(class VRP *V, int *p, int rules, int accept_type)
+{
+    ///
+    /// Evaluates the move with the edges at positions p[] of the copy and
+    /// keeps it as route_search() would.  Returns true if the search ends
+    /// with this move.
+    ///
+
+    int i,type;
+    double savings;
+
+    if(this->copy_evaluate(V,p,rules,&type,&savings)==false)
+        return false;
+
+    if(accept_type==VRPH_FIRST_ACCEPT || ((accept_type==VRPH_LI_ACCEPT)&&savings<-VRPH_EPSILON))
+    {
+        for(i=0;i<6;i++)
+            this->best_p[i]=p[i];
+        this->best_type=type;
+        this->best_savings=savings;
+        this->have_best=true;
+        return true;
+    }
+
+    // Same as VRPMove::is_better() for moves within one route
+    if(!this->have_best || savings<=this->best_savings)
+    {
+        for(i=0;i<6;i++)
+            this->best_p[i]=p[i];
+        this->best_type=type;
+        this->best_savings=savings;
+        this->have_best=true;
+    }
+
+    return false;
+
+}
+
+bool ThreeOpt::copy_evaluate(class VRP *V, int *p, int rules, int *type, double *savings)
+{
+    ///
+    /// Does what evaluate() does for the edges at positions p[] of the
+    /// copy, with the VRPH_DOWNHILL rules of check_move().
+    ///
+
+    int a,b,c,d,e,f;
+
+    this->num_copy_evaluations++;
+
+    a=this->seq[p[0]]; b=this->seq[p[1]]; c=this->seq[p[2]];
+    d=this->seq[p[3]]; e=this->seq[p[4]]; f=this->seq[p[5]];
+
+    if(V->routed[a]==false || V->routed[b]==false || V->routed[c]==false
+        || V->routed[d]==false|| V->routed[e]==false|| V->routed[f]==false)
+        return false;
+
+    if(rules & VRPH_FIXED_EDGES)
+    {
+        // Make sure we aren't disturbing fixed edges
+        if( V->is_fixed(a,b) || V->is_fixed(c,d) || V->is_fixed(e,f)) 
+            return false;
+    }
+
+    double s2, s3, s4, s5, s6, s7, old, minval;
+
+    old= V->d[a][b]+V->d[c][d]+V->d[e][f];
+    minval=(V->d[a][b]+V->d[c][e]+V->d[d][f])-old; *type=1;
+    s2=(V->d[a][c]+V->d[b][d]+V->d[e][f])-old;
+    if(s2<minval){ minval=s2; *type=2;}
+    s3=(V->d[a][c]+V->d[b][e]+V->d[d][f])-old;
+    if(s3<minval){ minval=s3; *type=3;}
+    s4=(V->d[a][d]+V->d[b][e]+V->d[c][f])-old;
+    if(s4<minval){ minval=s4; *type=4;}
+    s5=(V->d[a][d]+V->d[c][e]+V->d[b][f])-old;
+    if(s5<minval){ minval=s5; *type=5;}
+    s6=(V->d[a][e]+V->d[b][d]+V->d[c][f])-old;
+    if(s6<minval){ minval=s6; *type=6;}
+    s7=(V->d[a][e]+V->d[c][d]+V->d[b][f])-old;
+    if(s7<minval){ minval=s7; *type=7;}
+
+    if(minval + this->len > V->max_route_length )
+        return false;
+
+    *savings=minval;
+
+    if(V->forbid_tiny_moves && minval>-VRPH_EPSILON && minval<VRPH_EPSILON)
+        return false;
+
+    if(V->has_time_windows && this->copy_time_windows(V,p,*type)==false)
+        return false;
+
+    return (minval<-VRPH_EPSILON);
+
+}
+
+bool ThreeOpt::copy_time_windows(class VRP *V, int *p, int type)
+{
+    ///
+    /// Checks the time windows of the move as check_time_windows() does,
+    /// with the times of the copy.
+    ///
+
+    double t, push, arr;
+    int prev, f;
+
+    if(p[0]==0)
+        t=VRPH_MAX(V->nodes[VRPH_DEPOT].start_tw,0);
+    else
+        t=this->arrival[p[0]]+this->wait[p[0]]+V->service_time_array[this->seq[p[0]]];
+    prev=this->seq[p[0]];
+
+    // The segments are p[1]..p[2] and p[3]..p[4]
+    switch(type)
+    {
+    case 1:
+        if(!this->copy_visit(V,&t,&prev,p[1],p[2]) || !this->copy_visit(V,&t,&prev,p[4],p[3]))
+            return false;
+        break;
+    case 2:
+        if(!this->copy_visit(V,&t,&prev,p[2],p[1]) || !this->copy_visit(V,&t,&prev,p[3],p[4]))
+            return false;
+        break;
+    case 3:
+        if(!this->copy_visit(V,&t,&prev,p[2],p[1]) || !this->copy_visit(V,&t,&prev,p[4],p[3]))
+            return false;
+        break;
+    case 4:
+        if(!this->copy_visit(V,&t,&prev,p[3],p[4]) || !this->copy_visit(V,&t,&prev,p[1],p[2]))
+            return false;
+        break;
+    case 5:
+        if(!this->copy_visit(V,&t,&prev,p[3],p[4]) || !this->copy_visit(V,&t,&prev,p[2],p[1]))
+            return false;
+        break;
+    case 6:
+        if(!this->copy_visit(V,&t,&prev,p[4],p[3]) || !this->copy_visit(V,&t,&prev,p[1],p[2]))
+            return false;
+        break;
+    case 7:
+        if(!this->copy_visit(V,&t,&prev,p[4],p[3]) || !this->copy_visit(V,&t,&prev,p[2],p[1]))
+            return false;
+        break;
+    }
+
+    // As tw_push() at f
+    f=this->seq[p[5]];
+    arr=t+V->travel_time(prev,f);
+    if(f==VRPH_DEPOT)
+        return (arr<=V->nodes[VRPH_DEPOT].end_tw+VRPH_EPSILON);
+
+    push=VRPH_MAX(arr,V->nodes[f].start_tw)-(this->arrival[p[5]]+this->wait[p[5]]);
+    if(push<=VRPH_EPSILON)
+        return true;
+
+    return (push<=this->slack[p[5]]+VRPH_EPSILON);
+
+}
+
+bool ThreeOpt::copy_visit(class VRP *V, double *t, int *prev, int from, int to)
+{
+    ///
+    /// Visits the nodes in positions from..to of the copy, backwards if
+    /// to<from, with tw_visit().
+    ///
+
+    int q, step;
+
+    step=(to<from ? -1 : 1);
+    for(q=from;;q+=step)
+    {
+        if(V->tw_visit(t,prev,this->seq[q])==false)
+            return false;
+        if(q==to)
+            return true;
+    }
+
+}
+
+void ThreeOpt::copy_times(class VRP *V)
+{
+    ///
+    /// Computes the times of the copy as update_route_times() does.
+    ///
+
+    int p, current, prev;
+    double t, s;
+
+    t=VRPH_MAX(V->nodes[VRPH_DEPOT].start_tw,0);
+    prev=VRPH_DEPOT;
+    for(p=1;p<=this->L;p++)
+    {
+        current=this->seq[p];
+        t+=V->travel_time(prev,current);
+        this->arrival[p]=t;
+        this->wait[p]=VRPH_MAX(0,V->nodes[current].start_tw-t);
+        t+=this->wait[p]+V->service_time_array[current];
+        prev=current;
+    }
+
+    s=V->nodes[VRPH_DEPOT].end_tw-(t+V->travel_time(prev,VRPH_DEPOT));
+    for(p=this->L;p>=1;p--)
+    {
+        current=this->seq[p];
+        s=VRPH_MIN(s,V->nodes[current].end_tw-(this->arrival[p]+this->wait[p]));
+        this->slack[p]=s;
+        s+=this->wait[p];
+    }
+
+}
+
+bool ThreeOpt::copy_move(class VRP *V)
+{
+    ///
+    /// Makes the move found by copy_step() on the copy.  The length of the
+    /// route is updated as move() updates it in V, which for the types made
+    /// with Flip adds the savings of each reversal.  Returns false, leaving
+    /// the copy unchanged, if move() would not make the move in full.
+    ///
+
+    int a,b,c,d,e,f,s,q,n1,n2;
+    double fs;
+    int *p;
+
+    p=this->best_p;
+    a=this->seq[p[0]]; b=this->seq[p[1]]; c=this->seq[p[2]];
+    d=this->seq[p[3]]; e=this->seq[p[4]]; f=this->seq[p[5]];
+
+    // Flip uses the dummy node in place of the VRPH_DEPOT
+    s=(a==VRPH_DEPOT ? V->dummy_index : a);
+
+    switch(this->best_type)
+    {
+    case 1:
+        fs=this->flip_savings(V,c,d,e,f);
+        if(this->len+fs>V->max_route_length)
+            return false;
+        this->len=this->len+fs;
+        break;
+    case 2:
+        fs=this->flip_savings(V,s,b,c,d);
+        if(this->len+fs>V->max_route_length)
+            return false;
+        this->len=this->len+fs;
+        break;
+    case 3:
+        // Both reversals are made with the constraints inflated
+        this->len=this->len+this->flip_savings(V,s,b,c,d);
+        this->len=this->len+this->flip_savings(V,b,d,e,f);
+        break;
+    case 7:
+        fs=this->flip_savings(V,s,b,e,f);
+        if(this->len+fs>V->max_route_length)
+            return false;
+        this->len=this->len+fs;
+        break;
+    default:
+        this->len=this->len+this->best_savings;
+        break;
+    }
+
+    // Reorder the segments p[1]..p[2] and p[3]..p[4]
+    n1=p[2]-p[1]+1;
+    n2=p[4]-p[3]+1;
+    switch(this->best_type)
+    {
+    case 1:
+        this->reverse(p[3],p[4]);
+        break;
+    case 2:
+        this->reverse(p[1],p[2]);
+        break;
+    case 3:
+        this->reverse(p[1],p[2]);
+        this->reverse(p[3],p[4]);
+        break;
+    default:
+        // Reversing both leaves rev(S2) rev(S1)
+        this->reverse(p[1],p[4]);
+        if(this->best_type==4 || this->best_type==5)
+            this->reverse(p[1],p[1]+n2-1);
+        if(this->best_type==4 || this->best_type==6)
+            this->reverse(p[1]+n2,p[1]+n2+n1-1);
+        break;
+    }
+
+    for(q=p[1];q<=p[4];q++)
+        this->pos[this->seq[q]]=q;
+
+    if(V->has_time_windows)
+        this->copy_times(V);
+
+    return true;
+
+}
+
+void ThreeOpt::reverse(int from, int to)
+{
+    ///
+    /// Reverses positions from..to of the copy.
+    ///
 
+    int x;
+
+    while(from<to)
+    {
+        x=this->seq[from];
+        this->seq[from]=this->seq[to];
+        this->seq[to]=x;
+        from++;
+        to--;
+    }
+
+}
+
+double ThreeOpt::flip_savings(class VRP *V, int s, int ps, int pe, int e)
+{
+    ///
+    /// Returns the savings Flip::evaluate() computes for reversing ps..pe
+    /// between s and e.
+    ///
+
+    double old_cost, new_cost;
+
+    old_cost=(V->d[s][ps]-1*V->service_time_array[ps]) + 
+        (V->d[pe][e] -  1*V->service_time_array[e]) ;
+    new_cost=(V->d[s][pe]-1*V->service_time_array[pe]) + 
+        (V->d[ps][e] - 1*V->service_time_array[e]);
+
+    return new_cost - old_cost;
+
+}
@@ -36,7 +36,7 @@ bool ThreePointMove::search(VRP *V, int b, int rules)
 
         // Make sure we aren't disturbing fixed edges
 
-        if( V->fixed[i][b] || V->fixed[b][j] ) 
+        if( V->is_fixed(i,b) || V->is_fixed(b,j) ) 
             return false;
     }
 
@@ -53,12 +53,11 @@ bool ThreePointMove::search(VRP *V, int b, int rules)
     // Create the search_space
     V->create_search_neighborhood(b, rules);
 
-    int *old_sol=NULL;
     if(rules & VRPH_TABU)
     {
-        // Remember the original solution 
-        old_sol=new int[V->num_original_nodes+2];
-        V->export_solution_buff(old_sol);
+        // Record the changes made from here on so that a tabu move
+        // can be undone
+        V->start_journal();
     }
         
     for(ii=0;ii<V->search_size;ii++)
@@ -88,10 +87,10 @@ bool ThreePointMove::search(VRP *V, int b, int rules)
                         else
                         {
                             // Check VRPH_TABU status of move - return true if its ok
-                            // or revert to old_sol if not and continue to search.
-                            if(V->check_tabu_status(&M, old_sol))
+                            // or undo it if not and continue to search.
+                            if(V->check_tabu_status(&M))
                             {
-                                delete [] old_sol;
+                                V->stop_journal();
                                 return true; // The move was ok
                             }
                             // else we reverted back - continue the search for a move
@@ -125,10 +124,10 @@ bool ThreePointMove::search(VRP *V, int b, int rules)
                         else
                         {
                             // Check VRPH_TABU status of move - return true if its ok
-                            // or revert to old_sol if not and continue to search.
-                            if(V->check_tabu_status(&M, old_sol))
+                            // or undo it if not and continue to search.
+                            if(V->check_tabu_status(&M))
                             {
-                                delete [] old_sol;
+                                V->stop_journal();
                                 return true; // The move was ok
                             }
                             // else we reverted back - continue the search for a move
@@ -148,7 +147,7 @@ bool ThreePointMove::search(VRP *V, int b, int rules)
     if(accept_type==VRPH_FIRST_ACCEPT || BestM.savings==VRP_INFINITY)
     {
         if(rules&VRPH_TABU)
-            delete [] old_sol;
+            V->stop_journal();
         return false;        // No moves found
     }    
 
@@ -165,14 +164,14 @@ bool ThreePointMove::search(VRP *V, int b, int rules)
             else
             {
                 // Check VRPH_TABU status of move - return true if its ok
-                // or revert to old_sol if not and continue to search.
-                if(V->check_tabu_status(&BestM, old_sol))
+                // or undo it if not and continue to search.
+                if(V->check_tabu_status(&BestM))
                 {
-                    delete [] old_sol;
+                    V->stop_journal();
                     return true; // The move was ok
                 }
                 // else we reverted back - search over
-                delete [] old_sol;
+                V->stop_journal();
                 return false;
 
             }
@@ -347,10 +346,10 @@ bool ThreePointMove::evaluate(VRP *V, int b, int i, int j, int rules, VRPMove *M
     if(rules & VRPH_FIXED_EDGES)
     {
         // Make sure we aren't disturbing fixed edges
-        if( V->fixed[a][b] || V->fixed[b][c] ) 
+        if( V->is_fixed(a,b) || V->is_fixed(b,c) ) 
             return false;
 
-        if( V->fixed[h][i] || V->fixed[j][k] ) 
+        if( V->is_fixed(h,i) || V->is_fixed(j,k) ) 
             return false;
 
     }
@@ -421,8 +420,8 @@ bool ThreePointMove::evaluate(VRP *V, int b, int i, int j, int rules, VRPMove *M
     }
 
     // else diff. routes - can't have any overlaps in this case
-    int new_a_load = V->route[a_route].load+V->nodes[i].demand + V->nodes[j].demand - V->nodes[b].demand;
-    int new_i_load = V->route[i_route].load-V->nodes[i].demand - V->nodes[j].demand + V->nodes[b].demand;
+    int new_a_load = V->route[a_route].load+V->demand_array[i] + V->demand_array[j] - V->demand_array[b];
+    int new_i_load = V->route[i_route].load-V->demand_array[i] - V->demand_array[j] + V->demand_array[b];
 
     if(new_a_load>V->max_veh_capacity || new_i_load>V->max_veh_capacity)
         return false;
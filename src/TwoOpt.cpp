@@ -22,6 +22,17 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
     /// modifications are made.
     ///
 
+    VRPH_DISPATCH_RULES(rules,search_rules,(V,b,rules))
+}
+
+template<int R> bool TwoOpt::search_rules(class VRP *V, int b, int rules)
+{
+    ///
+    /// The search for the rules R, or for any rules if R is VRPH_DYNAMIC_RULES.
+    ///
+
+    rules=VRPH_STATIC_RULES(R,rules);
+
     VRPMove M;
     VRPMove BestM;
     int i,ii,j,k,a,c;
@@ -38,12 +49,11 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
     if( (rules & VRPH_LI_ACCEPT) == VRPH_LI_ACCEPT )
         accept_type=VRPH_LI_ACCEPT;
 
-    int *old_sol=NULL;
     if(rules & VRPH_TABU)
     {
-        // Remember the original solution 
-        old_sol=new int[V->num_original_nodes+2];
-        V->export_solution_buff(old_sol);
+        // Record the changes made from here on so that a tabu move
+        // can be undone
+        V->start_journal();
     }
 
     // Create the search_space
@@ -58,10 +68,23 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
     if(rules & VRPH_FIXED_EDGES)
     {
         // If both edges a-b and b-c are fixed, then no 2 opt moves are possible
-        if(V->fixed[a][b] && V->fixed[b][c])
+        if(V->is_fixed(a,b) && V->is_fixed(b,c))
             return false;
     }
 
+    // Lin-Kernighan gain criterion for downhill searches: the new edge b-j
+    // must be shorter than the edge a-b or b-c that it replaces, so
+    // candidates farther from b than both are skipped.  Neighbor lists are
+    // sorted by distance, so the first such neighbor ends the search.
+    bool gain_rule=false;
+    double max_gain=0;
+    if( (rules & VRPH_DOWNHILL) && !(rules & (VRPH_RECORD_TO_RECORD | 
+        VRPH_SIMULATED_ANNEALING | VRPH_MINIMIZE_NUM_ROUTES)) )
+    {
+        gain_rule=true;
+        max_gain=VRPH_MAX(V->d[a][b],V->d[b][c]);
+    }
+
     for(ii=0; ii<V->search_size; ii++)
     {
         j=V->search_space[ii];
@@ -71,6 +94,13 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
             report_error("%s: Error in routed array\n",__FUNCTION__);
         }
 
+        if(gain_rule && j!=b && V->d[b][j]>=max_gain)
+        {
+            if( (rules & VRPH_USE_NEIGHBOR_LIST) && !(rules & VRPH_RANDOMIZED) )
+                break;
+            continue;
+        }
+
         if(j!=b && j!=VRPH_DEPOT)
         {
             i=VRPH_MAX(V->pred_array[j],0);
@@ -81,7 +111,7 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
 
             M.savings=VRP_INFINITY ;
 
-            if(evaluate(V,a,b,i,j,rules, &M)==true)
+            if(evaluate_rules<R>(V,a,b,i,j,rules, &M)==true)
             {        
                 
                 if( ( (accept_type == VRPH_LI_ACCEPT) && ( M.savings<-VRPH_EPSILON )) ||
@@ -96,10 +126,10 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
                         else
                         {
                             // Check VRPH_TABU status of move - return true if its ok
-                            // or revert to old_sol if not and continue to search.
-                            if(V->check_tabu_status(&M, old_sol))
+                            // or undo it if not and continue to search.
+                            if(V->check_tabu_status(&M))
                             {
-                                delete [] old_sol;
+                                V->stop_journal();
                                 return true; // The move was ok
                             }
                             // else we reverted back - continue the search for a move
@@ -122,7 +152,7 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
             }
             
 
-            if(evaluate(V,a,b,j,k,rules, &M)==true)
+            if(evaluate_rules<R>(V,a,b,j,k,rules, &M)==true)
             {    
                 if( ( (accept_type == VRPH_LI_ACCEPT) && ( M.savings<-VRPH_EPSILON )) ||
                     accept_type==VRPH_FIRST_ACCEPT )
@@ -137,10 +167,10 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
                         else
                         {
                             // Check VRPH_TABU status of move - return true if its ok
-                            // or revert to old_sol if not and continue to search.
-                            if(V->check_tabu_status(&M, old_sol))
+                            // or undo it if not and continue to search.
+                            if(V->check_tabu_status(&M))
                             {
-                                delete [] old_sol;
+                                V->stop_journal();
                                 return true; // The move was ok
                             }
                             // else we reverted back - continue the search for a move
@@ -160,7 +190,7 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
             }
             
 
-            if(evaluate(V,b,c,i,j,rules, &M)==true)
+            if(evaluate_rules<R>(V,b,c,i,j,rules, &M)==true)
             {
                 if( ( (accept_type == VRPH_LI_ACCEPT) && ( M.savings<-VRPH_EPSILON )) ||
                     accept_type==VRPH_FIRST_ACCEPT )
@@ -175,10 +205,10 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
                         else
                         {
                             // Check VRPH_TABU status of move - return true if its ok
-                            // or revert to old_sol if not and continue to search.
-                            if(V->check_tabu_status(&M, old_sol))
+                            // or undo it if not and continue to search.
+                            if(V->check_tabu_status(&M))
                             {
-                                delete [] old_sol;
+                                V->stop_journal();
                                 return true; // The move was ok
                             }
                             // else we reverted back - continue the search for a move
@@ -199,7 +229,7 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
             }
             
 
-            if(evaluate(V,b,c,j,k,rules, &M)==true)
+            if(evaluate_rules<R>(V,b,c,j,k,rules, &M)==true)
             {
 
                 if( ( (accept_type == VRPH_LI_ACCEPT) && ( M.savings<-VRPH_EPSILON )) ||
@@ -214,10 +244,10 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
                         else
                         {
                             // Check VRPH_TABU status of move - return true if its ok
-                            // or revert to old_sol if not and continue to search.
-                            if(V->check_tabu_status(&M, old_sol))
+                            // or undo it if not and continue to search.
+                            if(V->check_tabu_status(&M))
                             {
-                                delete [] old_sol;
+                                V->stop_journal();
                                 return true; // The move was ok
                             }
                             // else we reverted back - continue the search for a move
@@ -254,7 +284,7 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
                 // Consider the edge VRPH_DEPOT-current_start
                 int t=current_start;
 
-                if(evaluate(V,a,b,VRPH_DEPOT,t,rules, &M)==true)
+                if(evaluate_rules<R>(V,a,b,VRPH_DEPOT,t,rules, &M)==true)
                 {
                     if( ( (accept_type == VRPH_LI_ACCEPT) && ( M.savings<-VRPH_EPSILON )) ||
                         accept_type==VRPH_FIRST_ACCEPT )
@@ -268,10 +298,10 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
                             else
                             {
                                 // Check VRPH_TABU status of move - return true if its ok
-                                // or revert to old_sol if not and continue to search.
-                                if(V->check_tabu_status(&M, old_sol))
+                                // or undo it if not and continue to search.
+                                if(V->check_tabu_status(&M))
                                 {
-                                    delete [] old_sol;
+                                    V->stop_journal();
                                     return true; // The move was ok
                                 }
                                 // else we reverted back - continue the search for a move
@@ -292,7 +322,7 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
                     }    
                 }
 
-                if(evaluate(V,b,c,VRPH_DEPOT,t,rules, &M)==true)
+                if(evaluate_rules<R>(V,b,c,VRPH_DEPOT,t,rules, &M)==true)
                 {
                     if( ( (accept_type == VRPH_LI_ACCEPT) && ( M.savings<-VRPH_EPSILON )) ||
                         accept_type==VRPH_FIRST_ACCEPT )
@@ -306,10 +336,10 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
                             else
                             {
                                 // Check VRPH_TABU status of move - return true if its ok
-                                // or revert to old_sol if not and continue to search.
-                                if(V->check_tabu_status(&M, old_sol))
+                                // or undo it if not and continue to search.
+                                if(V->check_tabu_status(&M))
                                 {
-                                    delete [] old_sol;
+                                    V->stop_journal();
                                     return true; // The move was ok
                                 }
                                 // else we reverted back - continue the search for a move
@@ -335,7 +365,7 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
                 current_end= V->route[current_route].end;
                 t=current_end;
 
-                if(evaluate(V,a,b,t,VRPH_DEPOT,rules, &M)==true)
+                if(evaluate_rules<R>(V,a,b,t,VRPH_DEPOT,rules, &M)==true)
                 {
                     if( ( (accept_type == VRPH_LI_ACCEPT) && ( M.savings<-VRPH_EPSILON )) ||
                         accept_type==VRPH_FIRST_ACCEPT )
@@ -349,10 +379,10 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
                             else
                             {
                                 // Check VRPH_TABU status of move - return true if its ok
-                                // or revert to old_sol if not and continue to search.
-                                if(V->check_tabu_status(&M, old_sol))
+                                // or undo it if not and continue to search.
+                                if(V->check_tabu_status(&M))
                                 {
-                                    delete [] old_sol;
+                                    V->stop_journal();
                                     return true; // The move was ok
                                 }
                                 // else we reverted back - continue the search for a move
@@ -373,7 +403,7 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
                     }
                 }
 
-                if(evaluate(V,b,c,t,VRPH_DEPOT,rules, &M)==true)
+                if(evaluate_rules<R>(V,b,c,t,VRPH_DEPOT,rules, &M)==true)
                 {
                     if( ( (accept_type == VRPH_LI_ACCEPT) && ( M.savings<-VRPH_EPSILON )) ||
                         accept_type==VRPH_FIRST_ACCEPT )
@@ -387,10 +417,10 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
                             else
                             {
                                 // Check VRPH_TABU status of move - return true if its ok
-                                // or revert to old_sol if not and continue to search.
-                                if(V->check_tabu_status(&M, old_sol))
+                                // or undo it if not and continue to search.
+                                if(V->check_tabu_status(&M))
                                 {
-                                    delete [] old_sol;
+                                    V->stop_journal();
                                     return true; // The move was ok
                                 }
                                 // else we reverted back - continue the search for a move
@@ -428,11 +458,16 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
     if(accept_type==VRPH_FIRST_ACCEPT || BestM.savings==VRP_INFINITY)
     {
         if(rules&VRPH_TABU)
-            delete [] old_sol;
+            V->stop_journal();
         return false;        // No moves found
     }
 
-    
+    if(rules & VRPH_EVALUATE_ONLY)
+    {
+        // Report the best move without making it
+        V->best_savings=BestM.savings;
+        return true;
+    }
 
     if(accept_type==VRPH_BEST_ACCEPT || accept_type==VRPH_LI_ACCEPT)
     {
@@ -455,14 +490,14 @@ bool TwoOpt::search(class VRP *V, int b, int rules)
             else
             {
                 // Check VRPH_TABU status of move - return true if its ok
-                // or revert to old_sol if not and continue to search.
-                if(V->check_tabu_status(&BestM, old_sol))
+                // or undo it if not and continue to search.
+                if(V->check_tabu_status(&BestM))
                 {
-                    delete [] old_sol;
+                    V->stop_journal();
                     return true; // The move was ok
                 }
                 // else we reverted back - search over
-                delete [] old_sol;
+                V->stop_journal();
                 return false;
 
             }
@@ -503,6 +538,10 @@ bool TwoOpt::route_search(class VRP *V, int r1, int r2, int rules)
 
     double current_savings=VRP_INFINITY;
 
+    // Skip the search if it failed before and neither route has changed
+    if(V->pair_searched(r1,r2,TWO_OPT,rules))
+        return false;
+
 
     a=VRPH_DEPOT;
     b= V->route[r1].start;
@@ -558,11 +597,12 @@ bool TwoOpt::route_search(class VRP *V, int r1, int r2, int rules)
         b=VRPH_MAX(V->next_array[b],0);
     }
 
-    if(accept_type == VRPH_FIRST_ACCEPT)
+    if(accept_type == VRPH_FIRST_ACCEPT || BestM.savings==VRP_INFINITY)
+    {
+        // No move found
+        V->pair_search_failed(r1,r2,TWO_OPT,rules);
         return false;
-
-    if(BestM.savings==VRP_INFINITY)
-            return false;    // No move found
+    }
 
     if( (accept_type == VRPH_LI_ACCEPT) || (accept_type==VRPH_BEST_ACCEPT))
     {
@@ -585,6 +625,18 @@ bool TwoOpt::evaluate(class VRP *V, int a, int b, int c, int d, int rules, VRPMo
     /// the relevant changes to the solution are stored in the VRPMove M and
     /// the function returns true.  Returns false otherwise.
     /// 
+    VRPH_DISPATCH_RULES(rules,evaluate_rules,(V,a,b,c,d,rules,M))
+}
+
+template<int R> bool TwoOpt::evaluate_rules(class VRP *V, int a, int b, int c, int d, int rules, VRPMove *M)
+{
+    ///
+    /// The evaluation for the rules R, or for any rules if R is
+    /// VRPH_DYNAMIC_RULES.
+    ///
+
+    rules=VRPH_STATIC_RULES(R,rules);
+
     ///
 
     V->num_evaluations[TWO_OPT_INDEX]++;
@@ -600,7 +652,7 @@ bool TwoOpt::evaluate(class VRP *V, int a, int b, int c, int d, int rules, VRPMo
     // Check for fixed edges
     if(rules & VRPH_FIXED_EDGES)
     {
-        if(V->fixed[a][b] || V->fixed[c][d])
+        if(V->is_fixed(a,b) || V->is_fixed(c,d))
             return false;
     }
 
@@ -643,8 +695,8 @@ bool TwoOpt::evaluate(class VRP *V, int a, int b, int c, int d, int rules, VRPMo
     if(a_route==c_route)
     {
         M->num_affected_routes=1;
-        M->savings = ( V->d[a][c]+V->d[b][d] -V->nodes[c].service_time) - 
-            ( V->d[a][b]+V->d[c][d]-V->nodes[b].service_time );
+        M->savings = ( V->d[a][c]+V->d[b][d] -V->service_time_array[c]) - 
+            ( V->d[a][b]+V->d[c][d]-V->service_time_array[b] );
 
         // Can check feasibility
         if(M->savings+V->route[a_route].length > V->max_route_length)
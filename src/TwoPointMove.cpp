@@ -23,9 +23,20 @@ bool TwoPointMove::search(class VRP *V, int j, int rules)
     /// modifications are made.
     ///
 
+    VRPH_DISPATCH_RULES(rules,search_rules,(V,j,rules))
+}
+
+template<int R> bool TwoPointMove::search_rules(class VRP *V, int j, int rules)
+{
+    ///
+    /// The search for the rules R, or for any rules if R is VRPH_DYNAMIC_RULES.
+    ///
+
+    rules=VRPH_STATIC_RULES(R,rules);
+
     VRPMove M;
     VRPMove BestM;
-    BestM.savings=VRP_INFINITY;
+    VRPCompactMove Best;
     int i,k;
     int accept_type;
 
@@ -39,7 +50,7 @@ bool TwoPointMove::search(class VRP *V, int j, int rules)
 
         // Make sure we aren't disturbing fixed edges
 
-        if( V->fixed[i][j] || V->fixed[j][k] ) 
+        if( V->is_fixed(i,j) || V->is_fixed(j,k) ) 
             return false;
     }
 
@@ -52,17 +63,22 @@ bool TwoPointMove::search(class VRP *V, int j, int rules)
     if( (rules & VRPH_LI_ACCEPT) > 0)
         accept_type=VRPH_LI_ACCEPT;
 
-    int *old_sol=NULL;
     if(rules & VRPH_TABU)
     {
-        // Remember the original solution 
-        old_sol=new int[V->num_original_nodes+2];
-        V->export_solution_buff(old_sol);
+        // Record the changes made from here on so that a tabu move
+        // can be undone
+        V->start_journal();
     }
 
     // Create the search_space
     V->create_search_neighborhood(j, rules);
 
+    // Drop the candidates that cannot give an acceptable move.  Undoing a
+    // tabu move can leave the routes reversed, so the screen is only done
+    // when the solution is not changed during the search.
+    if(!(rules & VRPH_TABU))
+        screen(V,j,V->savings_limit(rules));
+
     for(i=0;i<V->search_size;i++)
     {
         k=V->search_space[i];
@@ -71,7 +87,7 @@ bool TwoPointMove::search(class VRP *V, int j, int rules)
         {
             // VRPH_DEPOT not allowed in TwoPointMove
 
-            if(evaluate(V,j,k,rules,&M)==true)
+            if(evaluate_rules<R>(V,j,k,rules,&M)==true)
             {
                 // Feasible move found
                 if(accept_type==VRPH_FIRST_ACCEPT || (accept_type==VRPH_LI_ACCEPT && M.savings<-VRPH_EPSILON) )
@@ -87,10 +103,10 @@ bool TwoPointMove::search(class VRP *V, int j, int rules)
                         else
                         {
                             // Check VRPH_TABU status of move - return true if its ok
-                            // or revert to old_sol if not and continue to search.
-                            if(V->check_tabu_status(&M, old_sol))
+                            // or undo it if not and continue to search.
+                            if(V->check_tabu_status(&M))
                             {
-                                delete [] old_sol;
+                                V->stop_journal();
                                 return true; // The move was ok
                             }
 
@@ -103,8 +119,8 @@ bool TwoPointMove::search(class VRP *V, int j, int rules)
                 if(accept_type==VRPH_BEST_ACCEPT || accept_type==VRPH_LI_ACCEPT )
                 {
                     // compare to best move so far
-                    if(M.is_better(V, &BestM, rules))
-                        BestM=M;
+                    if(M.is_better(V, &Best, rules))
+                        Best=M;
 
                 }
 
@@ -116,19 +132,25 @@ bool TwoPointMove::search(class VRP *V, int j, int rules)
 
     if(accept_type==VRPH_FIRST_ACCEPT)
     {
-        if(old_sol)
-            delete [] old_sol;
+        V->stop_journal();
         return false;
     }
 
-    if(BestM.savings==VRP_INFINITY)
+    if(Best.savings==VRP_INFINITY)
     {
-        if(old_sol)
-            delete [] old_sol;
+        V->stop_journal();
         return false;
     }
     // else we found a move - make it
 
+    if(rules & VRPH_EVALUATE_ONLY)
+    {
+        // Report the best move without making it
+        V->best_savings=Best.savings;
+        return true;
+    }
+
+    Best.expand(&BestM);
     if(move(V,&BestM)==true)
     {
         if(!(rules & VRPH_TABU))
@@ -138,15 +160,15 @@ bool TwoPointMove::search(class VRP *V, int j, int rules)
     if(rules & VRPH_TABU)
     {    
         // Check VRPH_TABU status of move - return true if its ok
-        // or revert to old_sol if not and return
-        if(V->check_tabu_status(&M, old_sol))
+        // or undo it if not and return
+        if(V->check_tabu_status(&M))
         {
-            delete [] old_sol;
+            V->stop_journal();
             return true; // The move was ok
         }
         else
         {
-            delete [] old_sol;
+            V->stop_journal();
             return false;
         }
     }
@@ -169,10 +191,10 @@ bool TwoPointMove::route_search(class VRP *V, int r1, int r2, int rules)
 
     VRPMove M;
     VRPMove BestM;
+    VRPCompactMove Best;
     int j,k;
     int accept_type;
 
-    BestM.savings=VRP_INFINITY;
 
     if(r1==r2)
     {
@@ -217,8 +239,8 @@ bool TwoPointMove::route_search(class VRP *V, int r1, int r2, int rules)
                 {
 
                     // See if it's the best so far...
-                    if(M.is_better(V, &BestM, rules))
-                        BestM=M;
+                    if(M.is_better(V, &Best, rules))
+                        Best=M;
                 }
 
 
@@ -233,13 +255,14 @@ bool TwoPointMove::route_search(class VRP *V, int r1, int r2, int rules)
 
     if(accept_type==VRPH_FIRST_ACCEPT)
         return false;    // No moves found
-    if(BestM.savings == VRP_INFINITY)
+    if(Best.savings == VRP_INFINITY)
         return false;
 
     if( (accept_type == VRPH_LI_ACCEPT) || (accept_type == VRPH_BEST_ACCEPT))
     {
 
         // We found a move -- make it...
+        Best.expand(&BestM);
         if(move(V,&BestM)==false)
             report_error("%s: best move is false!\n",__FUNCTION__);
         else
@@ -253,6 +276,44 @@ bool TwoPointMove::route_search(class VRP *V, int r1, int r2, int rules)
 
 }
 
+void TwoPointMove::screen(class VRP *V, int j, double limit)
+{
+    ///
+    /// Removes from V->search_space the nodes b for which swapping j and b
+    /// cannot have savings below limit.  Nodes adjacent to j are kept since
+    /// the swap then shares an edge and is left to evaluate.
+    ///
+
+    int b,h,l,t,v,m,cnt;
+    double removal;
+
+    if(limit>=VRP_INFINITY)
+        return;
+
+    t=VRPH_MAX(V->pred_array[j],VRPH_DEPOT);
+    v=VRPH_MAX(V->next_array[j],VRPH_DEPOT);
+    removal=V->d[t][j]+V->d[j][v];
+
+    cnt=0;
+    for(m=0;m<V->search_size;m++)
+    {
+        b=V->search_space[m];
+        if(b!=VRPH_DEPOT && b!=j && b!=t && b!=v && V->routed[b])
+        {
+            h=VRPH_MAX(V->pred_array[b],VRPH_DEPOT);
+            l=VRPH_MAX(V->next_array[b],VRPH_DEPOT);
+
+            // t-j-v and h-b-l become t-b-v and h-j-l
+            if( (V->d[t][b]+V->d[b][v]+V->d[h][j]+V->d[j][l]) -
+                (removal+V->d[h][b]+V->d[b][l]) > limit)
+                continue;
+        }
+        V->search_space[cnt++]=b;
+    }
+    V->search_size=cnt;
+
+}
+
 bool TwoPointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
 {
     ///
@@ -262,6 +323,18 @@ bool TwoPointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
     /// in the VRPMove M and the function returns true.  Returns false otherwise.
     ///
 
+    VRPH_DISPATCH_RULES(rules,evaluate_rules,(V,j,b,rules,M))
+}
+
+template<int R> bool TwoPointMove::evaluate_rules(class VRP *V, int j, int b, int rules, VRPMove *M)
+{
+    ///
+    /// The evaluation for the rules R, or for any rules if R is
+    /// VRPH_DYNAMIC_RULES.
+    ///
+
+    rules=VRPH_STATIC_RULES(R,rules);
+
     V->num_evaluations[TWO_POINT_MOVE_INDEX]++;    
 
     if(V->routed[j]==false || V->routed[b]==false || j==b)
@@ -278,7 +351,7 @@ bool TwoPointMove::evaluate(class VRP *V, int j, int b, int rules, VRPMove *M)
         i=VRPH_MAX(V->pred_array[j],VRPH_DEPOT);
         k=VRPH_MAX(V->next_array[j],VRPH_DEPOT);
 
-        if( V->fixed[a][b] || V->fixed[b][c] || V->fixed[i][j] || V->fixed[j][k] ) 
+        if( V->is_fixed(a,b) || V->is_fixed(b,c) || V->is_fixed(i,j) || V->is_fixed(j,k) ) 
             return false;
     }
 
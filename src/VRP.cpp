@@ -27,23 +27,59 @@ VRP::VRP(int n)
     /// Constructor for an n-node problem.
     ///
 
-    int i,j;
+    int i;
 
     num_nodes=n;
     num_original_nodes=n;
     total_demand=0;
     num_days=0;
+
+    if(n+1>VRPH_MAX_INDEX)
+        report_error("%s: %d nodes do not fit in VRPIndex - build without VRPH_SMALL_INDEX\n",
+            __FUNCTION__,n);
     
-    next_array = new int[n+2];
-    pred_array = new int[n+2];
-    route_num = new int[n+2];
+    next_array = new VRPIndex[n+2];
+    pred_array = new VRPIndex[n+2];
+    route_num = new VRPIndex[n+2];
     route = new VRPRoute[n+2];
     routed = new bool[n+2];
-    best_sol_buff = new int[n+2];
-    current_sol_buff = new int[n+2];
-    search_space = new int[n+2];
+    best_sol_buff = new VRPIndex[n+2];
+    current_sol_buff = new VRPIndex[n+2];
+    search_space = new VRPIndex[n+2];
+    free_routes = new VRPIndex[n+2];
+    num_free_routes = 0;
+    arrival_time = new double[n+2];
+    wait_time = new double[n+2];
+    time_slack = new double[n+2];
+    idle_stamp = new int[VRPH_IDLE_SLOTS*(n+2)];
+    route_clock = 0;
+    pair_cache_size = 1;
+    while(pair_cache_size < 4*(n+2))
+        pair_cache_size *= 2;
+    pair_cache = new VRPPairSearch[pair_cache_size];
+    clear_pair_cache();
+    insertion_cache_size = 1;
+    while(insertion_cache_size < 8*(n+2))
+        insertion_cache_size *= 2;
+    insertion_cache = new VRPRouteInsertions[insertion_cache_size];
+    clear_insertion_cache();
+    route_memo_size = 1;
+    while(route_memo_size < 4*(n+2) && route_memo_size < HASH_TABLE_SIZE)
+        route_memo_size *= 2;
+    route_memo = new VRPOptimalRoute[route_memo_size];
+    memo_route = new VRPRoute(n+2);
+    clear_route_memo();
+    route_members = new VRPRouteMembers[n+2];
+    for(i=0;i<n+2;i++)
+    {
+        route_members[i].size=0;
+        route_members[i].members=NULL;
+    }
+    clear_route_members();
     nodes = new VRPNode[n+2];    
     // Add an extra spot for the VRPH_DEPOT and for the dummy node
+    demand_array = new int[n+2];
+    service_time_array = new double[n+2];
     
     symmetric=true;
     // Set to false only when we encounter FULL_MATRIX file
@@ -53,15 +89,17 @@ VRP::VRP(int n)
 
     d=NULL;
     // The distance matrix is allocated when the problem is loaded
-    fixed=new bool*[n+2];
-    fixed[0]=new bool[(n+2)*(n+2)];
-    for(i=1;i<n+2;i++)
-        fixed[i]=fixed[i-1]+(n+2);
+    owns_instance=true;
+    instance_owner=NULL;
+    num_instance_sharers=0;
+    fixed_neighbors=new VRPIndex[2*(n+2)];
+    fixed_edge_set=new VRPEdgeSet();
+    num_fixed_depot_edges=0;
     for(i=0;i<n+2;i++)
     {
         routed[i]=false;
-        for(j=0;j<n+2;j++)
-            fixed[i][j]=false;
+        fixed_neighbors[2*i]=-1;
+        fixed_neighbors[2*i+1]=-1;
     }
 
     // Set these to default values--they may change once
@@ -69,6 +107,7 @@ VRP::VRP(int n)
 
     min_vehicles=-1;
     has_service_times=false;
+    has_time_windows=false;
     max_route_length=VRP_INFINITY;
     orig_max_route_length=VRP_INFINITY;
     total_route_length=0.0;
@@ -79,6 +118,8 @@ VRP::VRP(int n)
     // These are for record-to-record travel
     record = 0.0;
     deviation = VRPH_DEFAULT_DEVIATION;        
+    use_held_karp = false;
+    held_karp_size = HELD_KARP_DEFAULT_SIZE;
 
     // For keeping track of the statistics
 
@@ -97,6 +138,22 @@ VRP::VRP(int n)
     this->tabu_list=new VRPTabuList(MAX_VRPH_TABU_LIST_SIZE);
     this->route_wh=NULL;
 
+    this->journal=new VRPJournal(n);
+    this->journal_on=false;
+
+    // Random keys for the edge-based solution hash
+    this->node_keys=new VRPHash[n+2];
+    this->node_keys2=new VRPHash[n+2];
+    for(i=0;i<n+2;i++)
+    {
+        this->node_keys[i]=VRPHashMix(2*i)|1;
+        this->node_keys2[i]=VRPHashMix(2*i+1)|1;
+    }
+    this->solution_hash=0;
+#if JOURNAL_VERIFY
+    this->journal_sol=new VRPIndex[n+2];
+#endif
+
     // Set this to true only if we have valid coordinates 
     // This is valid only for plotting the solution
     can_display=false;
@@ -110,38 +167,79 @@ VRP::VRP(int n, int ndays)
     /// Constructor for an n-node, ndays-day problem.
     ///
 
-    int i,j;
+    int i;
 
     num_nodes=n;
     num_original_nodes=n;
     total_demand=0;
     num_days=ndays;
+
+    if(n+1>VRPH_MAX_INDEX)
+        report_error("%s: %d nodes do not fit in VRPIndex - build without VRPH_SMALL_INDEX\n",
+            __FUNCTION__,n);
     
-    next_array = new int[n+2];
-    pred_array = new int[n+2];
-    route_num = new int[n+2];
+    next_array = new VRPIndex[n+2];
+    pred_array = new VRPIndex[n+2];
+    route_num = new VRPIndex[n+2];
     route = new VRPRoute[n+2];
     routed = new bool[n+2];
-    best_sol_buff = new int[n+2];
-    current_sol_buff = new int[n+2];
-    search_space = new int[n+2];
+    best_sol_buff = new VRPIndex[n+2];
+    current_sol_buff = new VRPIndex[n+2];
+    search_space = new VRPIndex[n+2];
+    free_routes = new VRPIndex[n+2];
+    num_free_routes = 0;
+    arrival_time = new double[n+2];
+    wait_time = new double[n+2];
+    time_slack = new double[n+2];
+    idle_stamp = new int[VRPH_IDLE_SLOTS*(n+2)];
+    route_clock = 0;
+    pair_cache_size = 1;
+    while(pair_cache_size < 4*(n+2))
+        pair_cache_size *= 2;
+    pair_cache = new VRPPairSearch[pair_cache_size];
+    clear_pair_cache();
+    insertion_cache_size = 1;
+    while(insertion_cache_size < 8*(n+2))
+        insertion_cache_size *= 2;
+    insertion_cache = new VRPRouteInsertions[insertion_cache_size];
+    clear_insertion_cache();
+    route_memo_size = 1;
+    while(route_memo_size < 4*(n+2) && route_memo_size < HASH_TABLE_SIZE)
+        route_memo_size *= 2;
+    route_memo = new VRPOptimalRoute[route_memo_size];
+    memo_route = new VRPRoute(n+2);
+    clear_route_memo();
+    route_members = new VRPRouteMembers[n+2];
+    for(i=0;i<n+2;i++)
+    {
+        route_members[i].size=0;
+        route_members[i].members=NULL;
+    }
+    clear_route_members();
     nodes = new VRPNode[n+2];    
     // Add an extra spot for the VRPH_DEPOT and for the dummy node
+    demand_array = new int[n+2];
+    service_time_array = new double[n+2];
     
+    symmetric=true;
+    // Set to false only when we encounter FULL_MATRIX file
+
     forbid_tiny_moves=true;    
     // Default is to forbid these moves
 
     d=NULL;
     // The distance matrix is allocated when the problem is loaded
-    fixed=new bool*[n+2];
-    fixed[0]=new bool[(n+2)*(n+2)];
-    for(i=1;i<n+2;i++)
-        fixed[i]=fixed[i-1]+(n+2);
+    owns_instance=true;
+    instance_owner=NULL;
+    num_instance_sharers=0;
+    fixed_neighbors=new VRPIndex[2*(n+2)];
+    fixed_edge_set=new VRPEdgeSet();
+    num_fixed_depot_edges=0;
     for(i=0;i<n+2;i++)
     {
         routed[i]=false;
-        for(j=0;j<n+2;j++)
-            fixed[i][j]=false;
+        fixed_neighbors[2*i]=-1;
+        fixed_neighbors[2*i+1]=-1;
     }
 
     // Set these to default values--they may change once
@@ -149,6 +247,7 @@ VRP::VRP(int n, int ndays)
 
     min_vehicles=-1;
     has_service_times=false;
+    has_time_windows=false;
     max_route_length=VRP_INFINITY;
     orig_max_route_length=VRP_INFINITY;
     total_route_length=0.0;
@@ -160,6 +259,8 @@ VRP::VRP(int n, int ndays)
     // These are for record-to-record travel
     record = 0.0;
     deviation = VRPH_DEFAULT_DEVIATION;        
+    use_held_karp = false;
+    held_karp_size = HELD_KARP_DEFAULT_SIZE;
 
     // For keeping track of the statistics
 
@@ -178,6 +279,22 @@ VRP::VRP(int n, int ndays)
     this->tabu_list=new VRPTabuList(MAX_VRPH_TABU_LIST_SIZE);
     this->route_wh=NULL;
 
+    this->journal=new VRPJournal(n);
+    this->journal_on=false;
+
+    // Random keys for the edge-based solution hash
+    this->node_keys=new VRPHash[n+2];
+    this->node_keys2=new VRPHash[n+2];
+    for(i=0;i<n+2;i++)
+    {
+        this->node_keys[i]=VRPHashMix(2*i)|1;
+        this->node_keys2[i]=VRPHashMix(2*i+1)|1;
+    }
+    this->solution_hash=0;
+#if JOURNAL_VERIFY
+    this->journal_sol=new VRPIndex[n+2];
+#endif
+
     // Now allocate d days worth of storage at each of the nodes
     for(i=0;i<=n+1;i++)
     {
@@ -191,6 +308,121 @@ VRP::VRP(int n, int ndays)
     
 }
 
+VRP::VRP(VRP *W)
+{
+    ///
+    /// Constructor for a search state on the problem already loaded into W.
+    /// The distance matrix, the nodes (with their neighbor lists) and the 
+    /// fixed edges are shared with W rather than copied, so only the O(n)
+    /// solution storage is allocated here.  The VRP that owns the shared
+    /// data must outlive this object, and the shared data must not be
+    /// modified while the search is running.
+    ///
+
+    int i,n;
+
+    n=W->num_original_nodes;
+    num_original_nodes=n;
+    num_days=W->num_days;
+
+    next_array = new VRPIndex[n+2];
+    pred_array = new VRPIndex[n+2];
+    route_num = new VRPIndex[n+2];
+    route = new VRPRoute[n+2];
+    routed = new bool[n+2];
+    best_sol_buff = new VRPIndex[n+2];
+    current_sol_buff = new VRPIndex[n+2];
+    search_space = new VRPIndex[n+2];
+    free_routes = new VRPIndex[n+2];
+    num_free_routes = 0;
+    arrival_time = new double[n+2];
+    wait_time = new double[n+2];
+    time_slack = new double[n+2];
+    idle_stamp = new int[VRPH_IDLE_SLOTS*(n+2)];
+    route_clock = 0;
+    pair_cache_size = 1;
+    while(pair_cache_size < 4*(n+2))
+        pair_cache_size *= 2;
+    pair_cache = new VRPPairSearch[pair_cache_size];
+    clear_pair_cache();
+    insertion_cache_size = 1;
+    while(insertion_cache_size < 8*(n+2))
+        insertion_cache_size *= 2;
+    insertion_cache = new VRPRouteInsertions[insertion_cache_size];
+    clear_insertion_cache();
+    route_memo_size = 1;
+    while(route_memo_size < 4*(n+2) && route_memo_size < HASH_TABLE_SIZE)
+        route_memo_size *= 2;
+    route_memo = new VRPOptimalRoute[route_memo_size];
+    memo_route = new VRPRoute(n+2);
+    clear_route_memo();
+    route_members = new VRPRouteMembers[n+2];
+    for(i=0;i<n+2;i++)
+    {
+        route_members[i].size=0;
+        route_members[i].members=NULL;
+    }
+    clear_route_members();
+    for(i=0;i<n+2;i++)
+        routed[i]=false;
+
+    d=NULL;
+    fixed_neighbors=NULL;
+    fixed_edge_set=NULL;
+    nodes=NULL;
+    demand_array=NULL;
+    service_time_array=NULL;
+    owns_instance=false;
+    instance_owner=NULL;
+    num_instance_sharers=0;
+    this->share_instance(W);
+
+    total_route_length=0.0;
+    best_total_route_length=VRP_INFINITY;
+    total_number_of_routes=0;
+    search_size=0;
+    
+    // These are for record-to-record travel
+    record = 0.0;
+    deviation = W->deviation;        
+    use_held_karp = W->use_held_karp;
+    held_karp_size = W->held_karp_size;
+    temperature = W->temperature;
+    cooling_ratio = W->cooling_ratio;
+
+    // For keeping track of the statistics
+
+    for(i=0;i<NUM_HEURISTICS;i++)
+    {
+        num_evaluations[i]=0;
+        num_moves[i]=0;
+
+    }
+
+    // Create the solution warehouse
+    this->solution_wh=new VRPSolutionWarehouse(NUM_ELITE_SOLUTIONS,n);
+
+    this->tabu_list=new VRPTabuList(MAX_VRPH_TABU_LIST_SIZE);
+    this->route_wh=NULL;
+
+    this->journal=new VRPJournal(n);
+    this->journal_on=false;
+
+    // Random keys for the edge-based solution hash
+    this->node_keys=new VRPHash[n+2];
+    this->node_keys2=new VRPHash[n+2];
+    for(i=0;i<n+2;i++)
+    {
+        this->node_keys[i]=VRPHashMix(2*i)|1;
+        this->node_keys2[i]=VRPHashMix(2*i+1)|1;
+    }
+    this->solution_hash=0;
+#if JOURNAL_VERIFY
+    this->journal_sol=new VRPIndex[n+2];
+#endif
+
+}
+
 VRP::~VRP()
 {
     ///
@@ -199,19 +431,51 @@ VRP::~VRP()
 
     delete [] this->best_sol_buff;
     delete [] this->current_sol_buff;
-    delete [] this->d[0];
-    delete [] this->d;
-    delete [] this->fixed[0];
-    delete [] this->fixed;
+    if(this->owns_instance)
+    {
+        if(this->num_instance_sharers>0)
+            report_error("%s: %d VRPs still share the instance data\n",__FUNCTION__,
+                this->num_instance_sharers);
+        if(this->d!=NULL)
+        {
+            delete [] this->d[0];
+            delete [] this->d;
+        }
+        delete [] this->fixed_neighbors;
+        delete this->fixed_edge_set;
+        delete [] this->nodes;
+        delete [] this->demand_array;
+        delete [] this->service_time_array;
+    }
+    else if(this->instance_owner!=NULL)
+        this->instance_owner->num_instance_sharers--;
     delete [] this->next_array;
     delete [] this->search_space;
-    delete [] this->nodes;
+    delete [] this->free_routes;
+    delete [] this->arrival_time;
+    delete [] this->wait_time;
+    delete [] this->time_slack;
+    delete [] this->idle_stamp;
+    delete [] this->pair_cache;
+    delete [] this->insertion_cache;
+    delete [] this->route_memo;
+    delete this->memo_route;
+    for(int i=0;i<this->num_original_nodes+2;i++)
+        if(this->route_members[i].members)
+            delete [] this->route_members[i].members;
+    delete [] this->route_members;
     delete [] this->pred_array;
     delete [] this->route;
     delete [] this->route_num;
     delete [] this->routed;
     delete this->solution_wh;
     delete this->tabu_list;
+    delete this->journal;
+    delete [] this->node_keys;
+    delete [] this->node_keys2;
+#if JOURNAL_VERIFY
+    delete [] this->journal_sol;
+#endif
 
 }
 
@@ -244,7 +508,7 @@ double VRP::get_total_service_time()
     return this->total_service_time;
 }
 
-double VRP::get_best_sol_buff(int *sol_buff)
+double VRP::get_best_sol_buff(VRPIndex *sol_buff)
 {
     ///
     /// Copies the best solution buffer found so far into the sol_buff[] array.
@@ -252,7 +516,7 @@ double VRP::get_best_sol_buff(int *sol_buff)
     /// of this solution.
     ///
 
-    memcpy(sol_buff,this->best_sol_buff,(this->num_nodes+1)*sizeof(int));
+    memcpy(sol_buff,this->best_sol_buff,(this->num_nodes+1)*sizeof(VRPIndex));
     return this->best_total_route_length;
 }
 
@@ -314,50 +578,117 @@ void VRP::set_best_total_route_length(double val)
     return;
 
 }
-bool VRP::clone(VRP *W)
-{ 
+void VRP::share_instance(VRP *W)
+{
     ///
-    /// Copy Constructor for VRP.
+    /// Points this VRP at the instance data of W (distance matrix, nodes,
+    /// fixed edges) and copies the scalar problem parameters.  Any instance
+    /// data previously owned by this VRP is freed.  The solution storage of
+    /// this VRP is not reallocated, so W must have the same number of nodes.
     ///
 
-    this->balance_parameter=W->balance_parameter;
-    this->best_known=W->best_known;
-    this->best_total_route_length=W->best_total_route_length;
-    // Copy the best solution buffer
-    memcpy(this->best_sol_buff, W->best_sol_buff, (sizeof(int))*(W->num_nodes+2));
+    VRP *owner;
 
-    // Copy the currnet solution buffer
-    memcpy(this->current_sol_buff, W->current_sol_buff, (sizeof(int))*(W->num_nodes+2));
+    if(this==W)
+        return;
 
-    this->coord_type=W->coord_type;
-    this->d=W->d;                // OK to just copy the pointers here
-    this->deviation=W->deviation;
-    this->display_type=W->display_type;
-    this->edge_weight_format=W->edge_weight_format;
+    if(this->num_original_nodes!=W->num_original_nodes)
+        report_error("%s: cannot share a problem with %d nodes in a VRP with %d nodes\n",
+            __FUNCTION__,W->num_original_nodes,this->num_original_nodes);
+
+    owner=(W->owns_instance ? W : W->instance_owner);
+
+    if(this->owns_instance)
+    {
+        if(this->num_instance_sharers>0)
+            report_error("%s: %d VRPs still share the instance data\n",__FUNCTION__,
+                this->num_instance_sharers);
+        if(this->d!=NULL)
+        {
+            delete [] this->d[0];
+            delete [] this->d;
+        }
+        delete [] this->fixed_neighbors;
+        delete this->fixed_edge_set;
+        delete [] this->nodes;
+        delete [] this->demand_array;
+        delete [] this->service_time_array;
+    }
+    else if(this->instance_owner!=NULL)
+        this->instance_owner->num_instance_sharers--;
+    this->owns_instance=false;
+    this->instance_owner=owner;
+    owner->num_instance_sharers++;
+
+    this->d=W->d;
+    this->fixed_neighbors=W->fixed_neighbors;
+    this->fixed_edge_set=W->fixed_edge_set;
+    this->num_fixed_depot_edges=W->num_fixed_depot_edges;
+    this->nodes=W->nodes;
+    this->demand_array=W->demand_array;
+    this->service_time_array=W->service_time_array;
+    this->clear_pair_cache();
+    this->clear_insertion_cache();
+    this->clear_route_memo();
+
+    strcpy(this->name,W->name);
+    this->num_nodes=W->num_nodes;
+    this->num_days=W->num_days;
     this->dummy_index=W->dummy_index;
+    this->problem_type=W->problem_type;
+    this->total_demand=W->total_demand;
+    this->max_veh_capacity=W->max_veh_capacity;
+    this->orig_max_veh_capacity=W->orig_max_veh_capacity;
+    this->max_route_length=W->max_route_length;
+    this->min_route_length=W->min_route_length;
+    this->orig_max_route_length=W->orig_max_route_length;
+    this->min_vehicles=W->min_vehicles;
     this->has_service_times=W->has_service_times;
+    this->has_time_windows=W->has_time_windows;
+    this->fixed_service_time=W->fixed_service_time;
+    this->total_service_time=W->total_service_time;
+    this->best_known=W->best_known;
+    this->edge_weight_type=W->edge_weight_type;
+    this->edge_weight_format=W->edge_weight_format;
+    this->coord_type=W->coord_type;
+    this->display_type=W->display_type;
     this->matrix_size=W->matrix_size;
-    this->max_route_length=W->max_route_length;
+    this->balance_parameter=W->balance_parameter;
     this->neighbor_list_size=W->neighbor_list_size;
-    this->nodes = W->nodes; // OK to just copy the pointers here?
+    this->symmetric=W->symmetric;
+    this->can_display=W->can_display;
+    this->depot_normalized=W->depot_normalized;
+    this->forbid_tiny_moves=W->forbid_tiny_moves;
+    this->min_theta=W->min_theta;
+    this->max_theta=W->max_theta;
 
-    this->num_nodes=W->num_nodes;
-    this->total_route_length=W->total_route_length;
-    this->orig_max_route_length=W->orig_max_route_length;
-    this->orig_max_veh_capacity=W->orig_max_veh_capacity;
+}
 
-    this->problem_type=W->problem_type;
-    this->record=W->record;
+bool VRP::clone(VRP *W)
+{ 
+    ///
+    /// Copy Constructor for VRP.  The instance data of W (distance matrix,
+    /// nodes, fixed edges) is shared rather than duplicated, so W must have
+    /// the same number of nodes and its owner must outlive this VRP.
+    ///
 
+    this->share_instance(W);
 
-    this->search_size=W->search_size;
+    this->best_total_route_length=W->best_total_route_length;
+    // Copy the best solution buffer
+    memcpy(this->best_sol_buff, W->best_sol_buff, (sizeof(VRPIndex))*(W->num_nodes+2));
+
+    // Copy the currnet solution buffer
+    memcpy(this->current_sol_buff, W->current_sol_buff, (sizeof(VRPIndex))*(W->num_nodes+2));
 
+    this->deviation=W->deviation;
+    this->total_route_length=W->total_route_length;
+    this->record=W->record;
+    this->search_size=W->search_size;
     this->temperature=W->temperature;
     this->total_number_of_routes=W->total_number_of_routes;
-    this->total_service_time=W->total_service_time;
-    this->max_veh_capacity=W->max_veh_capacity;
+    this->num_free_routes=0;
     this->violation=W->violation;
-    this->edge_weight_type=W->edge_weight_type;
 
     // Assume that the current_solution has been sent to W->
     W->export_solution_buff(W->current_sol_buff);
@@ -380,6 +711,9 @@ void VRP::create_distance_matrix(int type)
     int i,j,k,n;
     n=this->num_nodes;
 
+    if(!this->owns_instance)
+        report_error("%s: the instance data is shared\n",__FUNCTION__);
+
     if(type==VRPH_EXPLICIT)
     {
         // We have presumably already loaded in the distance matrix
@@ -428,6 +762,9 @@ void VRP::create_neighbor_lists(int nsize)
     /// including the VRPH_DEPOT. 
     ///
 
+    if(!this->owns_instance)
+        report_error("%s: the instance data is shared\n",__FUNCTION__);
+
     if(nsize>num_nodes )
     {
         fprintf(stderr,"Requested neighbor list size is greater than num_nodes!\n%d>%d\n",
@@ -455,6 +792,9 @@ void VRP::create_neighbor_lists(int nsize)
     // Set the neighbor_list_size value
     neighbor_list_size=nsize;
 
+    // Routes found optimal by searches of the old lists may not be any more
+    this->clear_route_memo();
+
     NList=new VRPNeighborElement[nsize];
 
     // First, do the neighbor_list for the VRPH_DEPOT
@@ -682,8 +1022,8 @@ bool VRP::check_feasibility(VRPViolation *VV)
 
     VV->capacity_violation=-VRP_INFINITY;
     VV->length_violation=-VRP_INFINITY;
+    VV->time_window_violation=-VRP_INFINITY;
 
-    this->normalize_route_numbers();
 
     for(i=1;i<=this->total_number_of_routes;i++)
     {
@@ -706,6 +1046,44 @@ bool VRP::check_feasibility(VRPViolation *VV)
 
         }
 
+        if(this->has_time_windows && this->route[i].num_customers>0)
+        {
+            // Time window violations - the lateness at each node and at
+            // the return to the VRPH_DEPOT
+            int current, last;
+            double late;
+
+            if(this->route[i].times_valid==false)
+                this->update_route_times(i);
+
+            last=VRPH_DEPOT;
+            current=this->route[i].start;
+            while(current>0)
+            {
+                if(current!=this->dummy_index)
+                {
+                    late=this->arrival_time[current]-this->nodes[current].end_tw;
+                    if(late>VRPH_EPSILON)
+                    {
+                        if(late>VV->time_window_violation)
+                            VV->time_window_violation=late;
+                        is_feasible=false;
+                    }
+                    last=current;
+                }
+                current=this->next_array[current];
+            }
+
+            late=this->departure_time(last)+this->travel_time(last,VRPH_DEPOT)-
+                this->nodes[VRPH_DEPOT].end_tw;
+            if(late>VRPH_EPSILON)
+            {
+                if(late>VV->time_window_violation)
+                    VV->time_window_violation=late;
+                is_feasible=false;
+            }
+        }
+
     }
 
     return is_feasible;
@@ -745,8 +1123,8 @@ void VRP::refresh_routes()
     current_start = route[current_route].start;
     current_end = route[current_route].end;
 
-    total_load+=nodes[current_node].demand;
-    current_load+=nodes[current_node].demand;
+    total_load+=demand_array[current_node];
+    current_load+=demand_array[current_node];
     len+=d[VRPH_DEPOT][current_node];
     rlen+=d[VRPH_DEPOT][current_node];
 
@@ -784,8 +1162,8 @@ void VRP::refresh_routes()
             len+=d[current_node][next_node];
             rlen+=d[current_node][next_node];
             current_node=next_node;
-            total_load+=nodes[current_node].demand;
-            current_load+=nodes[current_node].demand;
+            total_load+=demand_array[current_node];
+            current_load+=demand_array[current_node];
             cnt++;
         }
         else
@@ -814,9 +1192,9 @@ void VRP::refresh_routes()
             }
 
             current_node = route_start;
-            total_load+=nodes[current_node].demand;
+            total_load+=demand_array[current_node];
             // reset current_load to 0
-            current_load=nodes[current_node].demand;
+            current_load=demand_array[current_node];
             len+=d[VRPH_DEPOT][current_node];
             rlen=d[VRPH_DEPOT][current_node];
             cnt++;
@@ -890,7 +1268,7 @@ bool VRP::get_segment_info(int a, int b, struct VRPSegment *S)
         S->segment_start=b;
         S->segment_end=a;
         S->len=0;  //nodes[a].service_time??;
-        S->load=nodes[a].demand;
+        S->load=demand_array[a];
         S->num_custs=1;
         return true;
 
@@ -927,7 +1305,7 @@ bool VRP::get_segment_info(int a, int b, struct VRPSegment *S)
     int current_node = S->segment_start;
     int next_node;
 
-    S->load=nodes[current_node].demand;
+    S->load=demand_array[current_node];
     if(current_node!=dummy_index)
         S->num_custs++;;
 
@@ -936,7 +1314,7 @@ bool VRP::get_segment_info(int a, int b, struct VRPSegment *S)
         next_node = VRPH_MAX(next_array[current_node],0);
         S->len+=d[current_node][next_node];
         current_node=next_node;        
-        S->load+=nodes[next_node].demand;
+        S->load+=demand_array[next_node];
         if(current_node!= dummy_index)
             S->num_custs += 1;
     }
@@ -999,6 +1377,8 @@ void VRP::reverse_route(int i)
     orig_end = route[i].end;
     orig_start = route[i].start;
 
+    this->journal_route_info(i);
+
     start_node=orig_start;
     current_node=start_node;
 
@@ -1010,12 +1390,12 @@ void VRP::reverse_route(int i)
     // So next[prev_route] should equal start_node
     // We will change this so that next[prev_route]=-last_node
 
-    pred_array[current_node] = temp;
+    set_pred(current_node,temp);
     current_node = temp;
     while( (temp = next_array[current_node]) >0)
     {        
-        next_array[current_node] = pred_array[current_node];
-        pred_array[current_node] = temp;
+        set_next(current_node,pred_array[current_node]);
+        set_pred(current_node,temp);
         current_node = temp;
     }
 
@@ -1027,18 +1407,19 @@ void VRP::reverse_route(int i)
 
     route[i].end=orig_start;
     route[i].start=orig_end;
+    route_changed(i);
 
 #if REVERSE_DEBUG
     printf("start_node: %d; last_node: %d; prev_route: %d; next_route: %d\n",start_node,last_node, prev_route,next_route);
 #endif
 
     // Final set of updates
-    next_array[prev_route]=-last_node;
-    pred_array[next_route]=-start_node;
-    next_array[start_node]=-next_route;
-    pred_array[last_node]= -prev_route;
-    next_array[last_node]=temp;
-    next_array[prev_route]=-last_node;
+    set_next(prev_route,-last_node);
+    set_pred(next_route,-start_node);
+    set_next(start_node,-next_route);
+    set_pred(last_node,-prev_route);
+    set_next(last_node,temp);
+    set_next(prev_route,-last_node);
 
     // Need to update length if asymmetric
     if(!this->symmetric)
@@ -1071,6 +1452,13 @@ bool VRP::postsert_dummy(int i)
 
     i_route= route_num[i];
 
+    this->journal_route_info(i_route);
+    this->journal_node(dummy);
+
+    // The dummy's edges count towards the solution_hash while it is in a route
+    next_array[dummy]=VRPH_DEPOT;
+    solution_hash+=next_key(dummy,VRPH_DEPOT);
+
     start_i= route[i_route].start;
     end_i= route[i_route].end;
 
@@ -1086,26 +1474,26 @@ bool VRP::postsert_dummy(int i)
     // post_i is what used to be after i
     post_i= next_array[i];
 
-    next_array[i] = dummy;
-    next_array[dummy] = post_i;
+    set_next(i,dummy);
+    set_next(dummy,post_i);
 
     // Now need to update pred_array as well!
 
     // u's predecessor is now i
-    pred_array[dummy]=i;
+    set_pred(dummy,i);
 
     // The element who used to be after i is now preceded by u 
     if(post_i>=0)
-        pred_array[post_i]=dummy;
+        set_pred(post_i,dummy);
     else
         // post_i 
-        pred_array[-post_i]=-dummy;
+        set_pred(-post_i,-dummy);
 
     //start_array[dummy]=start;
     //end_array[dummy]=end;
 
     // Update i_route information
-    route_num[dummy]=i_route;
+    set_route_num(dummy,i_route);
     route[i_route].end=end;
     route[i_route].start=start;
 
@@ -1130,6 +1518,13 @@ bool VRP::presert_dummy(int i)
 
     i_route = route_num[i];
 
+    this->journal_route_info(i_route);
+    this->journal_node(dummy);
+
+    // The dummy's edges count towards the solution_hash while it is in a route
+    next_array[dummy]=VRPH_DEPOT;
+    solution_hash+=next_key(dummy,VRPH_DEPOT);
+
     start_i= route[i_route].start;
     end_i= route[i_route].end;
 
@@ -1149,19 +1544,19 @@ bool VRP::presert_dummy(int i)
 
 
     // dummy is now followed by i
-    next_array[dummy]=i;
-    pred_array[i]=dummy;
-    pred_array[dummy]=pre_i;    
+    set_next(dummy,i);
+    set_pred(i,dummy);
+    set_pred(dummy,pre_i);    
 
     // The element who used to be after i is now preceded by dummy
     if(pre_i>0)// was >=!!
-        next_array[pre_i]=dummy;
+        set_next(pre_i,dummy);
     else
         // post_i 
-        next_array[VRPH_ABS(pre_i)]=-dummy;
+        set_next(VRPH_ABS(pre_i),-dummy);
 
     // Update i_route information
-    route_num[dummy]=i_route;
+    set_route_num(dummy,i_route);
     route[i_route].end=end;
     route[i_route].start=start;
 
@@ -1190,6 +1585,8 @@ bool VRP::remove_dummy()
     d_start= route[d_route].start;
     d_end= route[d_route].end;
 
+    this->journal_route_info(d_route);
+
     if(d_start==dummy)
     {
         if(post_d<0)
@@ -1209,16 +1606,18 @@ bool VRP::remove_dummy()
         route[d_route].end=pre_d;
     }
 
-    next_array[VRPH_ABS(pre_d)]=post_d;
+    set_next(VRPH_ABS(pre_d),post_d);
 
     if(d_start==dummy)
-        next_array[VRPH_ABS(pre_d)]=-post_d;
+        set_next(VRPH_ABS(pre_d),-post_d);
 
 
-    pred_array[VRPH_ABS(post_d)]=pre_d;
+    set_pred(VRPH_ABS(post_d),pre_d);
 
     if(d_end==dummy)
-        pred_array[VRPH_ABS(post_d)]=-pre_d;
+        set_pred(VRPH_ABS(post_d),-pre_d);
+
+    solution_hash-=next_key(dummy,next_array[dummy]);
 
 
     return true;
@@ -1256,7 +1655,7 @@ bool VRP::create_default_routes()
         route_num[i]=i;
         route[i].start=i;
         route[i].end=i;
-        route[i].load= nodes[i].demand;
+        route[i].load= demand_array[i];
         route[i].length= d[VRPH_DEPOT][i] + d[i][VRPH_DEPOT];
 
         
@@ -1267,6 +1666,7 @@ bool VRP::create_default_routes()
             is_feasible=false;
 
         route[i].num_customers=1;
+        route_changed(i);
 
         routed[i]=true;    
 
@@ -1281,6 +1681,8 @@ bool VRP::create_default_routes()
     create_pred_array();
 
     total_number_of_routes=n;
+    num_free_routes=0;
+    solution_hash=hash_solution();
 
 
 
@@ -1381,9 +1783,10 @@ bool VRP::create_default_routes(int day)
         route_num[i]=i;
         route[i].start=i;
         route[i].end=i;
-        route[i].load= nodes[i].demand;
+        route[i].load= demand_array[i];
         route[i].length= d[VRPH_DEPOT][i] + d[i][VRPH_DEPOT];
         route[i].num_customers=1;
+        route_changed(i);
         routed[i]=true;    
 
     }
@@ -1397,6 +1800,8 @@ bool VRP::create_default_routes(int day)
     create_pred_array();
 
     total_number_of_routes=n;
+    num_free_routes=0;
+    solution_hash=hash_solution();
 
     // Now eject the nodes that don't require service on this day
     for(i=1;i<=n;i++)
@@ -1406,7 +1811,6 @@ bool VRP::create_default_routes(int day)
     }
 
     // Now check for feasibility;
-    this->normalize_route_numbers();
 
     // Check capacities
     for(i=1;i<=this->total_number_of_routes;i++)
@@ -1522,7 +1926,7 @@ bool VRP::perturb()
         post= VRPH_MAX(VRPH_DEPOT, next_array[current]);
 
         // Define s[i]= d(pre(i),i) + d(i,next(i))-d(pre(i),next(i))
-        v[i].val=((double) nodes[current].demand) / 
+        v[i].val=((double) demand_array[current]) / 
             (VRPH_EPSILON+d[pre][current]+d[current][post]-d[pre][post]);
         v[i].position=current;
         i++;
@@ -1540,8 +1944,10 @@ bool VRP::perturb()
 
     // Now insert the first m nodes from the sorted list into new locations.
 
-    int a,b,c,j,k,node1=0, node2=0,b_route,b_load,k_demand, jj, ll;
+    int a,b,c,h,j,k,r,node1=0, node2=0,b_route,b_load,k_demand,k_route, jj, ll;
     double  best_savings,b_len,jk,kl,jl;
+    struct VRPBestInsertions *B;
+    bool scan, found;
 
 
     for(j=0;j<m;j++)
@@ -1549,7 +1955,7 @@ bool VRP::perturb()
         best_savings=VRP_INFINITY;
 
         k=v[j].position;
-        k_demand= nodes[k].demand;
+        k_demand= demand_array[k];
 
         // Node k will be moved
 
@@ -1564,65 +1970,117 @@ bool VRP::perturb()
 
         // Node k will be moved - look for a new location
         // OLD SITUATION:  jj-k-ll
-        b=VRPH_ABS(next_array[VRPH_DEPOT]);
-        while(b!=VRPH_DEPOT)
+        k_route= route_num[k];
+        r=VRPH_ABS(next_array[VRPH_DEPOT]);
+        while(r!=VRPH_DEPOT)
         {
-            b_route= route_num[b];
-            b_load= route[b].load;
-            b_len= route[b].length;
-
-            a=VRPH_MAX(pred_array[b],0);
-            c=VRPH_MAX(next_array[b],0);
-
-            if(a!=k && b!=k && c!=k)// This guarantees a new location
+            b_route= route_num[r];
+
+            // The cached insertions into a route without k are tried in
+            // increasing order of savings, so the first feasible one is the
+            // best in the route.  Only the time windows, checked by
+            // is_feasible(), make feasibility depend on the position, and the
+            // route is scanned in full only if they rule out every cached
+            // insertion.
+            scan=true;
+            if(b_route!=k_route)
             {
-
-                if(a!=VRPH_DEPOT)
+                B=this->best_insertions(k,b_route);
+                found=false;
+                for(h=0;h<VRPH_NUM_BEST_INSERTIONS && B->after[h]!=-1;h++)
                 {
-                    if(Postsert.evaluate(this,k,a,&M)==true && M.savings<best_savings)
+                    a=B->after[h];
+                    if(a!=VRPH_DEPOT)
+                        c=VRPH_MAX(next_array[a],0);
+                    else
+                        c=route[b_route].start;
+
+                    if(a!=VRPH_DEPOT)
+                        found=Postsert.evaluate(this,k,a,&M) && is_feasible(&M,0);
+                    else
+                        found=Presert.evaluate(this,k,c,&M) && is_feasible(&M,0);
+
+                    if(found)
                     {
-                        best_savings=M.savings;
-                        node1=a;node2=b;
+                        if(M.savings<best_savings)
+                        {
+                            best_savings=M.savings;
+                            node1=a;node2=c;
+                        }
+                        break;
                     }
+                    if(!has_time_windows)
+                        break;
                 }
-                else
+                if(found || !has_time_windows || h==route[b_route].num_customers+1)
+                    scan=false;
+            }
+
+            b=r;
+            while(scan && b>0)
+            {
+                b_load= route[b].load;
+                b_len= route[b].length;
+
+                a=VRPH_MAX(pred_array[b],0);
+                c=VRPH_MAX(next_array[b],0);
+
+                if(a!=k && b!=k && c!=k)// This guarantees a new location
                 {
 
-                    if(Presert.evaluate(this,k,b,&M)==true && M.savings<best_savings)
+                    if(a!=VRPH_DEPOT)
                     {
-                        best_savings=M.savings;
-                        node1=a;node2=b;
+                        if(Postsert.evaluate(this,k,a,&M)==true && M.savings<best_savings &&
+                            is_feasible(&M,0))
+                        {
+                            best_savings=M.savings;
+                            node1=a;node2=b;
+                        }
                     }
+                    else
+                    {
 
+                        if(Presert.evaluate(this,k,b,&M)==true && M.savings<best_savings &&
+                            is_feasible(&M,0))
+                        {
+                            best_savings=M.savings;
+                            node1=a;node2=b;
+                        }
 
 
-                }
 
-                // Now try the edge b-c
-                if(b!=VRPH_DEPOT)
-                {
-                    if(Postsert.evaluate(this,k,b,&M)==true && M.savings<best_savings)
-                    {
-                        best_savings=M.savings;
-                        node1=b;node2=c;
                     }
-                }
-                else
-                {
-                    // b is the VRPH_DEPOT
-                    if(Presert.evaluate(this,k,c,&M)==true && M.savings<best_savings)
+
+                    // Now try the edge b-c
+                    if(b!=VRPH_DEPOT)
                     {
-                        best_savings=M.savings;
-                        node1=b;node2=c;
+                        if(Postsert.evaluate(this,k,b,&M)==true && M.savings<best_savings &&
+                            is_feasible(&M,0))
+                        {
+                            best_savings=M.savings;
+                            node1=b;node2=c;
+                        }
                     }
+                    else
+                    {
+                        // b is the VRPH_DEPOT
+                        if(Presert.evaluate(this,k,c,&M)==true && M.savings<best_savings &&
+                            is_feasible(&M,0))
+                        {
+                            best_savings=M.savings;
+                            node1=b;node2=c;
+                        }
 
 
-                }
+                    }
 
+                }
+                // Advance b
+                b=next_array[b];
             }
-            // Advance b
-            b=VRPH_ABS(next_array[b]);
 
+            // Move on to the next route
+            r=VRPH_ABS(next_array[route[b_route].end]);
         }
         if(best_savings!=VRP_INFINITY)
         {
@@ -1663,6 +2121,9 @@ bool VRP::eject_node(int j)
 
     flag=0;
 
+    this->journal_route_info(route_num[k]);
+    this->journal_node(k);
+
     // k is no longer routed
     routed[k]=false;
     
@@ -1682,8 +2143,8 @@ bool VRP::eject_node(int j)
     {
         // c is in a different route
         route[k_route].start=VRPH_ABS(e);
-        next_array[VRPH_ABS(c)]=-VRPH_ABS(e);
-        pred_array[VRPH_ABS(e)]=-VRPH_ABS(c);
+        set_next(VRPH_ABS(c),-VRPH_ABS(e));
+        set_pred(VRPH_ABS(e),-VRPH_ABS(c));
         
     }
 
@@ -1691,23 +2152,23 @@ bool VRP::eject_node(int j)
     {
         // e is in a different route
         route[k_route].end=c;
-        next_array[VRPH_ABS(c)]=-VRPH_ABS(e);
-        pred_array[VRPH_ABS(e)]=-VRPH_ABS(c);
+        set_next(VRPH_ABS(c),-VRPH_ABS(e));
+        set_pred(VRPH_ABS(e),-VRPH_ABS(c));
     }
 
     if(k_end==k && k_start==k)
     {
         // k is its own route
-        next_array[VRPH_ABS(c)]=-VRPH_ABS(e);
-        pred_array[VRPH_ABS(e)]=-VRPH_ABS(c);
+        set_next(VRPH_ABS(c),-VRPH_ABS(e));
+        set_pred(VRPH_ABS(e),-VRPH_ABS(c));
         flag=1;
     }
 
     if(k_start!=k && k_end!=k)
     {
         // k was interior--easy case
-        next_array[c]=e;
-        pred_array[e]=c;
+        set_next(c,e);
+        set_pred(e,c);
 
     }
 
@@ -1731,18 +2192,25 @@ bool VRP::eject_node(int j)
     change=ce-(ck+ke);
     total_route_length+=change;
     route[k_route].length+=change;
-    route[k_route].load-= nodes[k].demand;
+    route[k_route].load-= demand_array[k];
 
     // Removing a node from route k_route
     route[k_route].num_customers--;
+    route_changed(k_route);
     num_nodes--;
 
     if(flag)
+    {
         // We removed a singleton route
         this->total_number_of_routes--;
+        free_routes[num_free_routes++]=k_route;
+    }
     
-    route_num[k]=-1;
-    normalize_route_numbers();
+    // k's edges no longer count towards the solution_hash
+    solution_hash-=next_key(k,next_array[k]);
+
+    set_route_num(k,-1);
+    reclaim_routes();
     
     return true;
 }
@@ -1778,174 +2246,88 @@ bool VRP::eject_route(int r, int *route_buff)
     return true;
 
 }
-bool VRP::check_move(VRPMove *M, int rules)
+bool VRP::is_feasible(VRPMove *M, int rules)
 {
-
     ///
-    /// Evaluates the move in terms of the rules.  Can consider savings,
-    /// as well as other aspects of the VRPMove M.
+    /// Determines whether a proposed move is feasible or not, including
+    /// time windows if the problem has them.  The rules
+    /// is currently not used.
     ///
 
-
-    double savings;
-
-    savings=M->savings;
-
-
-    if(this->forbid_tiny_moves)
+    for(int i=0;i<M->num_affected_routes;i++)
     {
-        // See if it is a "meaningless" move
-        if(savings>-VRPH_EPSILON && savings < VRPH_EPSILON)
+        if( (M->route_lens[i]>this->max_route_length) || (M->route_loads[i]>this->max_veh_capacity) )
             return false;
     }
 
+    if(this->has_time_windows)
+        return this->check_time_windows(M);
+    
+    return true;
 
+}
+bool VRP::inject_node(int j)
+{
+    ///
+    /// Takes the node with index j that is currently NOT in the current solution and adds it
+    /// to the VRP in the best possible feasible position.
+    ///
 
-    if( (rules & VRPH_FREE) == VRPH_FREE )
-    {
-        // use with care!
-        return true;
-    }
-
+    if(j==VRPH_DEPOT)
+        report_error("%s: Can't inject VRPH_DEPOT!!\n",__FUNCTION__);
 
-    
+    int edge[4];
+    double costs[4];
+    this->find_cheapest_insertion(j,edge,costs,VRPH_USE_NEIGHBOR_LIST); 
 
-    if( (rules & VRPH_DOWNHILL) == VRPH_DOWNHILL)
-    {
-        if(savings<-VRPH_EPSILON )
-            return true;
-        else
-            return false;
+    this->insert_node(j,edge[0],edge[1]);
 
-    }
+    return true;
 
-    
+}
 
+bool VRP::insert_node(int j, int i, int k)
+{    
+    ///
+    /// Inserts j in between nodes i and k.  Both i and k
+    /// are assumed to be routed while j is not routed.
+    ///
 
-    if( rules & VRPH_RECORD_TO_RECORD )
+    if(routed[j] || !routed[i] || !routed[k])
     {
-        if(savings<=-VRPH_EPSILON)
-            return true;
-
-        // o/w savings is positive but must be less than deviation*record
+        fprintf(stderr,"insert_node(%d,%d,%d)\n",j,i,k);
+        report_error("%s: Improper nodes used in insert_node\n",__FUNCTION__);
+    }
 
+    double increase;
+    int r;
 
+    this->journal_node(j);
+    routed[j]=true;
 
-        if(!has_service_times)
-        {
-            if(total_route_length+savings<= (1+deviation)*record)
-                return true;
-            else
-                return false;
-
-        }
-        else
-        {
-            // We have service times so remove the service time from the
-            // deviation calculation
-
-            if( (total_route_length - total_service_time) + savings <=
-                ((1+deviation)*(record-total_service_time)))
-                return true;
-            else
-                return false;
-        }
-    }
-
-    if( rules & VRPH_SIMULATED_ANNEALING )
-    {
-        if(M->evaluated_savings==true)
-            return true;    // We already checked the random acceptance
-
-        // Otherwise, determine whether to accept or not.
-        if( exp(- (M->savings / this->temperature)) > lcgrand(10) )
-            return true;
-        else
-            return false;
-
-    }
-
-
-
-    report_error("%s: didn't return yet!\n",__FUNCTION__);
-
-    return false;
-    
-
-}
-
-
-bool VRP::is_feasible(VRPMove *M, int rules)
-{
-    ///
-    /// Determines whether a proposed move is feasible or not.
-    /// Could add time window feasibility checks here, etc.  The rules
-    /// is currently not used.
-    ///
-
-    for(int i=0;i<M->num_affected_routes;i++)
-    {
-        if( (M->route_lens[i]>this->max_route_length) || (M->route_loads[i]>this->max_veh_capacity) )
-            return false;
-    }
-    
-    return true;
-
-}
-bool VRP::inject_node(int j)
-{
-    ///
-    /// Takes the node with index j that is currently NOT in the current solution and adds it
-    /// to the VRP in the best possible feasible position.
-    ///
-
-    if(j==VRPH_DEPOT)
-        report_error("%s: Can't inject VRPH_DEPOT!!\n",__FUNCTION__);
-
-    int edge[4];
-    double costs[4];
-    this->find_cheapest_insertion(j,edge,costs,VRPH_USE_NEIGHBOR_LIST); 
-
-    this->insert_node(j,edge[0],edge[1]);
-
-    return true;
-
-}
-
-bool VRP::insert_node(int j, int i, int k)
-{    
-    ///
-    /// Inserts j in between nodes i and k.  Both i and k
-    /// are assumed to be routed while j is not routed.
-    ///
-
-    if(routed[j] || !routed[i] || !routed[k])
-    {
-        fprintf(stderr,"insert_node(%d,%d,%d)\n",j,i,k);
-        report_error("%s: Improper nodes used in insert_node\n",__FUNCTION__);
-    }
-
-    double increase;
-    int r;
-    routed[j]=true;
+    // j's edges count towards the solution_hash from now on
+    next_array[j]=VRPH_DEPOT;
+    solution_hash+=next_key(j,VRPH_DEPOT);
 
     if(i==k && k==VRPH_DEPOT)
     {
         
         int last_node=VRPH_ABS(pred_array[VRPH_DEPOT]);
-        this->next_array[last_node]=-j;
-        this->pred_array[j]=-last_node;
-        this->next_array[j]=VRPH_DEPOT;
-        this->pred_array[VRPH_DEPOT]=-j;
+        this->journal_route_info(total_number_of_routes+1);
+        this->set_next(last_node,-j);
+        this->set_pred(j,-last_node);
+        this->set_next(j,VRPH_DEPOT);
+        this->set_pred(VRPH_DEPOT,-j);
 
         increase=this->d[0][j]+this->d[j][0];
         this->total_number_of_routes++;
-        this->route_num[j]=this->total_number_of_routes;
+        this->set_route_num(j,this->total_number_of_routes);
         this->route[total_number_of_routes].length=increase;
-        this->route[total_number_of_routes].load=nodes[j].demand;
+        this->route[total_number_of_routes].load=demand_array[j];
         this->route[total_number_of_routes].num_customers=1;
         this->route[total_number_of_routes].start=j;
         this->route[total_number_of_routes].end=j;
+        this->route_changed(total_number_of_routes);
         this->num_nodes++;
         this->total_route_length+=increase;
 
@@ -1967,17 +2349,19 @@ bool VRP::insert_node(int j, int i, int k)
 
         increase=d[i][j]+d[j][k]-d[i][k];
         r=route_num[i];
+        this->journal_route_info(r);
 
 
         num_nodes++;
-        next_array[i]=j;
-        pred_array[j]=i;
-        next_array[j]=k;
-        pred_array[k]=j;
-        route_num[j]=r;
+        set_next(i,j);
+        set_pred(j,i);
+        set_next(j,k);
+        set_pred(k,j);
+        set_route_num(j,r);
         route[r].length+=increase;
-        route[r].load+= nodes[j].demand;
+        route[r].load+= demand_array[j];
         route[r].num_customers++;
+        route_changed(r);
         total_route_length+=increase;
 
         return true;
@@ -1989,6 +2373,7 @@ bool VRP::insert_node(int j, int i, int k)
         increase=d[i][j]+d[j][k]-d[i][k];
 
         r=route_num[k];
+        this->journal_route_info(r);
 
 
         int pre=VRPH_ABS(pred_array[k]);
@@ -1996,15 +2381,16 @@ bool VRP::insert_node(int j, int i, int k)
         // pre-VRPH_DEPOT-j-k situation...
         num_nodes++;
 
-        next_array[pre]=-j;
-        pred_array[j]=-pre;
-        next_array[j]=k;
-        pred_array[k]=j;
-        route_num[j]=r;
+        set_next(pre,-j);
+        set_pred(j,-pre);
+        set_next(j,k);
+        set_pred(k,j);
+        set_route_num(j,r);
         route[r].start=j;
         route[r].length+=increase;
-        route[r].load+= nodes[j].demand;
+        route[r].load+= demand_array[j];
         route[r].num_customers++;
+        route_changed(r);
 
         total_route_length+=increase;
         return true;
@@ -2016,21 +2402,23 @@ bool VRP::insert_node(int j, int i, int k)
 
         increase=d[i][j]+d[j][k]-d[i][k];
         r=route_num[i];
+        this->journal_route_info(r);
 
         int post=VRPH_ABS(next_array[i]);
         // i-j-VRPH_DEPOT-post situation...
 
         num_nodes++;
 
-        next_array[i]=j;
-        pred_array[j]=i;
-        next_array[j]=-post;
-        pred_array[post]=-j;
-        route_num[j]=r;
+        set_next(i,j);
+        set_pred(j,i);
+        set_next(j,-post);
+        set_pred(post,-j);
+        set_route_num(j,r);
         route[r].length+=increase;
-        route[r].load+= nodes[j].demand;
+        route[r].load+= demand_array[j];
         route[r].end=j;
         route[r].num_customers++;
+        route_changed(r);
         total_route_length+=increase;
         return true;
 
@@ -2058,9 +2446,10 @@ void VRP::find_cheapest_insertion(int j, int *edge, double *costs, int rules)
     ///
 
     int h,i,k,m, best_route, new_route, next_node;
-    double ij,ik,jk,min_feasible_increase, increase, min_increase;
+    double min_feasible_increase, increase, min_increase;
+    struct VRPBestInsertions *B;
+    bool found;
 
-    this->normalize_route_numbers();
     best_route = -1;
     k=-1;
 
@@ -2073,146 +2462,87 @@ void VRP::find_cheapest_insertion(int j, int *edge, double *costs, int rules)
 
     if(!(rules & VRPH_USE_NEIGHBOR_LIST))
     {
-        i=VRPH_DEPOT;
-        next_node=VRPH_ABS(next_array[i]);
-        int cnt=0;
+        // Visit the routes in the order of the solution, taking the cheapest
+        // insertion into each from the insertion cache.
+        next_node=VRPH_ABS(next_array[VRPH_DEPOT]);
         while(next_node != VRPH_DEPOT)
         {
-            cnt++;
-            if(next_node > 0)
-            {
-                k=next_node;
-
-                // Try to put j between i and k
-
-                ij= d[i][j];
-                ik= d[i][k];
-                jk= d[j][k];
-                increase=ij+jk-ik;
-
-                if(increase<min_increase)
-                {
-                    min_increase=increase;
-                    edge[2]=i;
-                    edge[3]=k;
-                }
-                if(increase<min_feasible_increase)
-                {
-                    // Check feasibility
-                    new_route= route_num[k];
-
-                    if( (route[new_route].length+increase <= max_route_length) &&
-                        (route[new_route].load + nodes[j].demand <= max_veh_capacity) )
-                    {
-                        edge[0]=i;
-                        edge[1]=k;
-                        best_route=new_route;
-                        min_feasible_increase=increase;
-
-                    }
+            new_route= route_num[next_node];
+            B=this->best_insertions(j,new_route);
 
-                }
-                // Move on to the next node.
-                i=k;
+            increase=B->cost[0];
+            i=B->after[0];
+            if(i==VRPH_DEPOT)
+                k=route[new_route].start;
+            else
+                k=VRPH_MAX(VRPH_DEPOT,next_array[i]);
 
+            if(increase<min_increase)
+            {
+                min_increase=increase;
+                edge[2]=i;
+                edge[3]=k;
             }
-            else
+            if(increase<min_feasible_increase && 
+                route[new_route].load + demand_array[j] <= max_veh_capacity)
             {
-                // next_node <= 0, implying the edges i-VRPH_DEPOT, VRPH_DEPOT-VRPH_ABS(next_node)
-                // First, consider i-VRPH_DEPOT
-                k=VRPH_DEPOT;
-
-                ij= d[i][j];
-                ik= d[i][k];
-                jk= d[j][k];
-                increase=ij+jk-ik;
-
-                if(increase<min_increase)
+                // The cached insertions come in increasing order of cost and
+                // the load and length do not depend on the position, so only
+                // the time windows can rule out an insertion in favor of a
+                // more expensive one.  The route is scanned in full if they
+                // rule out every cached insertion.
+                found=false;
+                for(h=0;h<VRPH_NUM_BEST_INSERTIONS && B->after[h]!=-1;h++)
                 {
-                    min_increase=increase;
-                    edge[2]=i;
-                    edge[3]=k;
-                }
-
-                if(increase<min_feasible_increase)
-                { 
-                    // Check feasibility
-                    new_route= route_num[i];
+                    increase=B->cost[h];
+                    if(increase>=min_feasible_increase || 
+                        route[new_route].length+increase > max_route_length)
+                        break;
+
+                    i=B->after[h];
+                    if(i==VRPH_DEPOT)
+                        k=route[new_route].start;
+                    else
+                        k=VRPH_MAX(VRPH_DEPOT,next_array[i]);
 
-                    if( (route[new_route].length+increase <= max_route_length) &&
-                        (route[new_route].load + nodes[j].demand <= max_veh_capacity) )
+                    if(!has_time_windows || tw_insert(j,i,k))
                     {
                         edge[0]=i;
                         edge[1]=k;
                         best_route=new_route;
                         min_feasible_increase=increase;
+                        found=true;
+                        break;
                     }
                 }
 
-                // Now consider the edge VRPH_DEPOT-VRPH_ABS(next_node)
-                i=VRPH_DEPOT;
-                k=VRPH_ABS(next_node);
-
-                ij= d[i][j];
-                ik= d[i][k];
-                jk= d[j][k];
-                increase=ij+jk-ik;
-
-                if(increase<min_increase)
-                {
-                    min_increase=increase;
-                    edge[2]=i;
-                    edge[3]=k;
-                }
-
-                if(increase<min_feasible_increase)
+                if(!found && h==VRPH_NUM_BEST_INSERTIONS)
                 {
-                    new_route= route_num[k];
-
-                    if( (route[new_route].length+increase <= max_route_length )&&
-                        (route[new_route].load + nodes[j].demand <= max_veh_capacity ) )
+                    i=VRPH_DEPOT;
+                    k=route[new_route].start;
+                    for(;;)
                     {
-                        edge[0]=i;
-                        edge[1]=k;
-                        best_route=new_route;
-                        min_feasible_increase=increase;
-                    }
+                        increase=d[i][j]+d[j][k]-d[i][k];
+                        if(increase<min_feasible_increase && 
+                            route[new_route].length+increase <= max_route_length &&
+                            tw_insert(j,i,k))
+                        {
+                            edge[0]=i;
+                            edge[1]=k;
+                            best_route=new_route;
+                            min_feasible_increase=increase;
+                        }
 
+                        if(k==VRPH_DEPOT)
+                            break;
+                        i=k;
+                        k=VRPH_MAX(VRPH_DEPOT,next_array[k]);
+                    }
                 }
-                i=k;
             }
 
-
-            next_node= next_array[i];
-
-        }
-        // Consider the final edge
-        k=VRPH_DEPOT;
-        ij= d[i][j];
-        ik= d[i][k];
-        jk= d[j][k];
-        increase=ij+jk-ik;
-
-        if(increase<min_increase)
-        {
-            min_increase=increase;
-            edge[2]=i;
-            edge[3]=k;
-        }
-
-        if(increase<min_feasible_increase)
-        { 
-            // Check feasibility
-            new_route= route_num[i];
-
-            if( (route[new_route].length+increase <= max_route_length) &&
-                (route[new_route].load + nodes[j].demand <= max_veh_capacity) )
-            {
-                edge[0]=i;
-                edge[1]=k;
-                best_route=new_route;
-                min_feasible_increase=increase;
-            }
+            // Move on to the first node of the next route
+            next_node=VRPH_ABS(next_array[route[new_route].end]);
         }
 
         costs[0]=min_feasible_increase;
@@ -2249,7 +2579,8 @@ void VRP::find_cheapest_insertion(int j, int *edge, double *costs, int rules)
 
 
                     if( (route[new_route].length+increase <= max_route_length) &&
-                        (route[new_route].load + nodes[j].demand <= max_veh_capacity) )
+                        (route[new_route].load + demand_array[j] <= max_veh_capacity) &&
+                        (!has_time_windows || tw_insert(j,h,i)) )
                     {
                         edge[0]=h;
                         edge[1]=i;
@@ -2278,7 +2609,8 @@ void VRP::find_cheapest_insertion(int j, int *edge, double *costs, int rules)
 
 
                     if( (route[new_route].length+increase <= max_route_length) &&
-                        (route[new_route].load + nodes[j].demand <= max_veh_capacity) )
+                        (route[new_route].load + demand_array[j] <= max_veh_capacity) &&
+                        (!has_time_windows || tw_insert(j,i,k)) )
                     {
                         edge[0]=i;
                         edge[1]=k;
@@ -2308,10 +2640,12 @@ int VRP::inject_set(int num, int *nodelist, int rules, int attempts)
 
     int i,j,k;
     double best_obj=VRP_INFINITY;
-    int *best_sol, *orderings,*best_ordering, *start_sol;
+    VRPIndex *best_sol, *start_sol;
+    int *orderings,*best_ordering;
     int best_index=0;
 
-    best_sol=orderings=best_ordering=start_sol=NULL;
+    best_sol=start_sol=NULL;
+    orderings=best_ordering=NULL;
 
     for(i=0;i<num;i++)
     {
@@ -2322,8 +2656,8 @@ int VRP::inject_set(int num, int *nodelist, int rules, int attempts)
         }
     }
 
-    best_sol=new int[3+(this->num_nodes)+num];//!!! The eventual sol_buff is larger !!!!
-    start_sol=new int[3+(this->num_nodes)+num];
+    best_sol=new VRPIndex[3+(this->num_nodes)+num];//!!! The eventual sol_buff is larger !!!!
+    start_sol=new VRPIndex[3+(this->num_nodes)+num];
     this->export_solution_buff(start_sol);
     this->import_solution_buff(start_sol);
     
@@ -2396,6 +2730,9 @@ int VRP::inject_set(int num, int *nodelist, int rules, int attempts)
             for(j=0;j<num;j++)
                 current_list[j]=nodelist[orderings[j]];
 
+            // Record the changes made by this attempt so that they can be undone
+            this->start_journal();
+
             // It is unfortunately possible to enter some cycles here - this is a cheap
             // way of getting out
             int cycle_ctr=0;
@@ -2407,6 +2744,7 @@ int VRP::inject_set(int num, int *nodelist, int rules, int attempts)
                     fprintf(stderr,"Cycle encountered in REGRET SEARCH!\nReverting to original solution\n");
                     if(best_obj<VRP_INFINITY)
                     {
+                        this->stop_journal();
                         this->import_solution_buff(best_sol);
                         delete [] best_sol;
                         delete [] orderings;
@@ -2468,8 +2806,9 @@ int VRP::inject_set(int num, int *nodelist, int rules, int attempts)
             }
 
             // Now return to the original solution...
-            this->import_solution_buff(start_sol);
+            this->undo_journal();
         }
+        this->stop_journal();
         delete [] current_list;
     }
 
@@ -2555,149 +2894,454 @@ void VRP::eject_neighborhood(int j, int num, int *nodelist)
 void VRP::normalize_route_numbers()
 {
     ///
-    /// Renumbers the routes so that with R total routes, they
-    /// are numbered 1,2, ..., R instead of all over the place
-    /// as they typically are after Clarke Wright.
+    /// Retained for compatibility.  The routes are now always numbered
+    /// 1,2, ..., R since the id of an emptied route is recycled by 
+    /// reclaim_routes() as soon as the route disappears, so there is
+    /// nothing left to do here.
     ///
 
-    int current, end, n, R, i;
-    int current_route;
-    int *indices;
-    R= count_num_routes();
-    n= this->num_original_nodes;
+    return;
 
+}
 
-    // First check to see if we are already normalized
+void VRP::reclaim_routes()
+{
+    ///
+    /// Recycles the ids of the routes emptied since the last call.  Before
+    /// these routes disappeared the ids were 1,2, ..., R0, so each free
+    /// id that is at most R=total_number_of_routes is given to the
+    /// highest numbered route that is still in use.  Only the nodes in 
+    /// the relabeled routes are visited.
+    ///
 
-    // Make the arrays 1-based to avoid insanity...
-    indices=new int[n+1];
+    int i, j, f, h, current, num_free;
 
-    for(i=0;i<=n;i++)
-        indices[i]=1;
+    if(num_free_routes==0)
+        return;
 
-    int ctr=0;
-    i=VRPH_ABS(next_array[VRPH_DEPOT]);
-    while(i!=VRPH_DEPOT)
+    // Discard duplicates and ids of routes that were refilled after being
+    // emptied (possible inside composite moves)
+    num_free=0;
+    for(i=0;i<num_free_routes;i++)
     {
-        if(route_num[i] <= R && routed[i]==true)
+        f=free_routes[i];
+        if(route[f].num_customers!=0)
+            continue;
+        for(j=0;j<num_free;j++)
         {
-            // route_num[i] is less than R, so we have to
-            // avoid this index.
-            indices[route_num[i]]=0;
+            if(free_routes[j]==f)
+                break;
         }
-        else
-            ctr++;
-
-        i=VRPH_ABS(next_array[i]);
+        if(j==num_free)
+            free_routes[num_free++]=f;
     }
-    
-    if(ctr==0)
+    num_free_routes=0;
+
+    // h is the highest id that may still be in use
+    h=total_number_of_routes+num_free;
+    for(i=0;i<num_free;i++)
     {
-        delete [] indices;
-        return;// route numbers are already normalized since no route_nums were >R.
+        f=free_routes[i];
+        if(f>total_number_of_routes)
+            continue;
+
+        // Find the highest numbered route that still has customers
+        while(route[h].num_customers==0)
+            h--;
+
+        this->journal_route_info(h);
+        this->journal_route_info(f);
+
+        // Move route h into position f
+        route[f].start = route[h].start;
+        route[f].end = route[h].end;
+        route[f].length = route[h].length;
+        route[f].load = route[h].load;
+        route[f].num_customers = route[h].num_customers;
+        route[f].times_valid = route[h].times_valid;
+        route[f].version = ++route_clock;
+        route[h].num_customers = 0;
+
+        current=route[f].start;
+        while(current>0)
+        {
+            set_route_num(current,f);
+            current=next_array[current];
+        }
+        h--;
     }
 
-    // Now all of the available indices that are less than or equal to R
-    // are marked with a 1. The unavailable indices are set to zero.
+    return;
 
-    int next_index=1;
-    while(indices[next_index]==0)
-        next_index++;
+}
 
-    // So next_index is the first index available for use.
 
-    // Get the first route and change the information
-    current=VRPH_ABS(next_array[VRPH_DEPOT]);
+void VRP::clear_idle_stamps()
+{
+    ///
+    /// Clears the don't-look bits of every node in all slots.
+    ///
 
-    while(current!=VRPH_DEPOT)
-    {
-        current_route= route_num[current];
-        end= route[current_route].end;
+    for(int i=0;i<VRPH_IDLE_SLOTS*(this->num_original_nodes+2);i++)
+        this->idle_stamp[i]=-1;
+}
+
+void VRP::set_idle(int j, int slot)
+{
+    ///
+    /// Records that the operator using the given slot searched node j
+    /// without finding a move.
+    ///
 
-        // Get the next available index
-        while(indices[next_index]==0)
-            next_index++;
+    this->idle_stamp[slot*(this->num_original_nodes+2)+j]=this->route_clock;
+}
 
-        // Modify the current index if necessary
-        if(current_route>R)
-        {
-            // Update the route_num
-            i=VRPH_ABS(next_array[VRPH_DEPOT]);
-            while(i!=VRPH_DEPOT)
-            {
-                if(route_num[i]==current_route)
-                    route_num[i]=next_index;
-                i=VRPH_ABS(next_array[i]);
+bool VRP::is_idle(int j, int slot)
+{
+    ///
+    /// Returns true if the operator using the given slot can skip node j:
+    /// the route of j and the routes of the nodes in its neighbor list 
+    /// have not changed since j was last searched without success.
+    /// Assumes that the search is restricted to the neighbor list.
+    /// A VRPH_DEPOT neighbor brings the ends of every route into the
+    /// search, so then no route may have changed.
+    ///
 
-            }
-            // Update the route information
-            route[next_index].start = route[current_route].start;
-            route[next_index].end = route[current_route].end;
-            route[next_index].length = route[current_route].length;
-            route[next_index].load = route[current_route].load;
-            route[next_index].num_customers = route[current_route].num_customers;
-            
-            next_index++;
+    int i,k,stamp;
 
+    stamp=this->idle_stamp[slot*(this->num_original_nodes+2)+j];
+    if(this->route[this->route_num[j]].version>stamp)
+        return false;
 
+    for(i=0;i<this->neighbor_list_size;i++)
+    {
+        k=this->nodes[j].neighbor_list[i].position;
+        if(k==VRPH_DEPOT)
+        {
+            if(this->route_clock>stamp)
+                return false;
         }
+        else if(this->routed[k] && this->route[this->route_num[k]].version>stamp)
+            return false;
+    }
 
-        // Set current to be the first node in the next route
-        current=VRPH_ABS(next_array[end]);
+    return true;
+}
 
+// Only downhill searches depend on nothing but the two routes
+#define VRPH_PAIR_CACHEABLE(rules)  (((rules) & VRPH_DOWNHILL) && \
+    !((rules) & (VRPH_RECORD_TO_RECORD|VRPH_SIMULATED_ANNEALING|VRPH_TABU|VRPH_EVALUATE_ONLY)))
 
-    }
+// Slot of the search of routes r1 and r2 by a heuristic
+#define VRPH_PAIR_SLOT(r1,r2,heuristic,rules)   \
+    ((unsigned)((r1)*31+(r2)*1021+(heuristic)*7+(rules)) & (unsigned)(this->pair_cache_size-1))
 
-    delete [] indices;
+void VRP::clear_pair_cache()
+{
+    ///
+    /// Forgets all route pair searches.
+    ///
 
-    return;
+    for(int i=0;i<this->pair_cache_size;i++)
+        this->pair_cache[i].heuristic=0;
+}
+
+bool VRP::pair_searched(int r1, int r2, int heuristic, int rules)
+{
+    ///
+    /// Returns true if routes r1 and r2 were searched by the given heuristic
+    /// with the same rules without finding a move, and neither route has
+    /// changed since.
+    ///
+
+    struct VRPPairSearch *P;
+
+    if(!VRPH_PAIR_CACHEABLE(rules))
+        return false;
+
+    P=&(this->pair_cache[VRPH_PAIR_SLOT(r1,r2,heuristic,rules)]);
+    return (P->heuristic==heuristic && P->rules==rules && P->r1==r1 && P->r2==r2 &&
+        P->v1==this->route[r1].version && P->v2==this->route[r2].version);
+}
+
+void VRP::pair_search_failed(int r1, int r2, int heuristic, int rules)
+{
+    ///
+    /// Records that the given heuristic found no move between routes r1
+    /// and r2, replacing whatever search was held in the same slot.
+    ///
 
+    struct VRPPairSearch *P;
 
+    if(!VRPH_PAIR_CACHEABLE(rules))
+        return;
 
+    P=&(this->pair_cache[VRPH_PAIR_SLOT(r1,r2,heuristic,rules)]);
+    P->r1=r1;
+    P->r2=r2;
+    P->v1=this->route[r1].version;
+    P->v2=this->route[r2].version;
+    P->heuristic=heuristic;
+    P->rules=rules;
 }
 
+// Slot of the insertions of customer j into route r
+#define VRPH_INSERTION_SLOT(j,r)    \
+    ((unsigned)((j)*1021+(r)*31) & (unsigned)(this->insertion_cache_size-1))
 
-bool VRP::create_search_neighborhood(int j, int rules)
+void VRP::clear_insertion_cache()
 {
     ///
-    /// Creates the search_size and search_space fields for the
-    /// current VRP in terms of the given node j and the rules.
+    /// Forgets all cached insertions.
     ///
 
-    int i,k, cnt;
-    // Define the search space
-    
+    for(int i=0;i<this->insertion_cache_size;i++)
+        this->insertion_cache[i].j=-1;
+}
 
-    if( rules & VRPH_USE_NEIGHBOR_LIST )
+struct VRPBestInsertions *VRP::best_insertions(int j, int r)
+{
+    ///
+    /// Returns the VRPH_NUM_BEST_INSERTIONS cheapest places to insert
+    /// customer j into route r, in the order the route visits them among
+    /// positions of equal cost.  They come from the insertion cache unless
+    /// route r has changed since they were found.  The result is only valid
+    /// until the next call.
+    ///
+
+    struct VRPRouteInsertions *I;
+    int i, x, y;
+    double cost;
+
+    I=&(this->insertion_cache[VRPH_INSERTION_SLOT(j,r)]);
+    if(I->j==j && I->r==r && I->version==this->route[r].version)
+        return &(I->B);
+
+    I->j=j;
+    I->r=r;
+    I->version=this->route[r].version;
+    for(i=0;i<VRPH_NUM_BEST_INSERTIONS;i++)
     {
+        I->B.cost[i]=VRP_INFINITY;
+        I->B.after[i]=-1;
+    }
 
-        // Search only those nodes that are in the neighbor list
-        search_size=0;
-        cnt=0;
-        for(i=0;i<neighbor_list_size;i++)
+    x=VRPH_DEPOT;
+    y=this->route[r].start;
+    for(;;)
+    {
+        cost=this->d[x][j]+this->d[j][y]-this->d[x][y];
+        if(cost<I->B.cost[VRPH_NUM_BEST_INSERTIONS-1])
         {
-            // Consider node k
-            k=nodes[j].neighbor_list[i].position;
-            if( routed[k] == true)
+            // Insertion sort
+            i=VRPH_NUM_BEST_INSERTIONS-1;
+            while(i>0 && I->B.cost[i-1]>cost)
             {
-                // The node is routed 
-                if(rules & VRPH_INTER_ROUTE_ONLY)
-                {
-                    // Make sure k is in a different route
-                    if(route_num[k]!=route_num[j])
-                    {
-                        search_space[cnt] = k;
-                        cnt++;
-                        
-                    }
-                }
-                else
-                {
-                    if(rules & VRPH_INTRA_ROUTE_ONLY)
-                    {
-                        // Make sure k is in the same route
+                I->B.cost[i]=I->B.cost[i-1];
+                I->B.after[i]=I->B.after[i-1];
+                i--;
+            }
+            I->B.cost[i]=cost;
+            I->B.after[i]=x;
+        }
 
-                        if(route_num[k]==route_num[j])
+        if(y==VRPH_DEPOT)
+            break;
+        x=y;
+        y=VRPH_MAX(this->next_array[y],VRPH_DEPOT);
+    }
+
+    return &(I->B);
+}
+
+void VRP::clear_route_members()
+{
+    ///
+    /// Forgets the customers listed for every route.
+    ///
+
+    for(int i=0;i<this->num_original_nodes+2;i++)
+        this->route_members[i].version=-1;
+}
+
+VRPIndex *VRP::route_customers(int r)
+{
+    ///
+    /// Returns the customers of route r in the order the route visits them.
+    /// They are listed again only if route r has changed since the last
+    /// call, and the list is valid until it changes again.
+    ///
+
+    struct VRPRouteMembers *M;
+    int i,k;
+
+    M=&(this->route_members[r]);
+    if(M->version==this->route[r].version)
+    {
+#if ROUTE_MEMBERS_VERIFY
+        k=this->route[r].start;
+        for(i=0;i<M->num_customers;i++)
+        {
+            if(M->members[i]!=k)
+                report_error("%s: route %d changed without a new version\n",__FUNCTION__,r);
+            k=VRPH_MAX(this->next_array[k],VRPH_DEPOT);
+        }
+        if(k!=VRPH_DEPOT || M->num_customers!=this->route[r].num_customers)
+            report_error("%s: route %d changed without a new version\n",__FUNCTION__,r);
+#endif
+        return M->members;
+    }
+
+    if(M->size<this->route[r].num_customers)
+    {
+        if(M->members)
+            delete [] M->members;
+        M->size=VRPH_MAX(2*M->size,this->route[r].num_customers);
+        M->members=new VRPIndex[M->size];
+    }
+
+    k=this->route[r].start;
+    for(i=0;i<this->route[r].num_customers;i++)
+    {
+        M->members[i]=k;
+        k=this->next_array[k];
+    }
+    M->num_customers=this->route[r].num_customers;
+    M->version=this->route[r].version;
+
+    return M->members;
+}
+
+void VRP::clear_route_memo()
+{
+    ///
+    /// Forgets all routes known to be locally optimal.
+    ///
+
+    for(int i=0;i<this->route_memo_size;i++)
+        this->route_memo[i].heuristics=0;
+}
+
+bool VRP::route_is_optimal(int r, int heuristics)
+{
+    ///
+    /// Returns true if route r is known to be locally optimal under each of
+    /// the intra-route heuristics given.  If VRPH_USE_NEIGHBOR_LIST is set,
+    /// a route found optimal by the restricted neighbor list searches also
+    /// counts.
+    ///
+
+    struct VRPOptimalRoute *O;
+    int h1,h2;
+
+    if(route[r].num_customers==0)
+        return false;
+
+    this->update_route(r,this->memo_route);
+    h1=this->memo_route->hash(SALT_1);
+    h2=this->memo_route->hash(SALT_2);
+
+    O=&(this->route_memo[h1 & (this->route_memo_size-1)]);
+
+    if(O->heuristics==0 || O->hash_val!=h1 || O->hash_val2!=h2 || O->start!=route[r].start ||
+        VRPH_ABS(O->length-route[r].length)>VRPH_EPSILON)
+        return false;
+
+    // The heuristics must all have been run, and with neighbor lists only if
+    // that is all that is asked for
+    if( (heuristics & ~VRPH_USE_NEIGHBOR_LIST) & ~O->heuristics)
+        return false;
+    if( (O->heuristics & VRPH_USE_NEIGHBOR_LIST) && !(heuristics & VRPH_USE_NEIGHBOR_LIST) )
+        return false;
+
+    return true;
+}
+
+void VRP::route_found_optimal(int r, int heuristics)
+{
+    ///
+    /// Records that none of the given intra-route heuristics can improve
+    /// route r, with VRPH_USE_NEIGHBOR_LIST set if they were restricted to
+    /// the neighbor lists.  Replaces whatever route was in the same slot.
+    ///
+
+    struct VRPOptimalRoute *O;
+    int h1,h2;
+
+    if(route[r].num_customers==0)
+        return;
+
+    this->update_route(r,this->memo_route);
+    h1=this->memo_route->hash(SALT_1);
+    h2=this->memo_route->hash(SALT_2);
+
+    O=&(this->route_memo[h1 & (this->route_memo_size-1)]);
+
+    if(O->heuristics!=0 && O->hash_val==h1 && O->hash_val2==h2 &&
+        O->start==route[r].start && VRPH_ABS(O->length-route[r].length)<=VRPH_EPSILON)
+    {
+        // The same route - add to what is known about it unless one search
+        // used the neighbor lists and the other did not, in which case the
+        // full search is kept
+        if( (O->heuristics ^ heuristics) & VRPH_USE_NEIGHBOR_LIST )
+        {
+            if(O->heuristics & VRPH_USE_NEIGHBOR_LIST)
+                O->heuristics=heuristics;
+            return;
+        }
+        O->heuristics|=heuristics;
+        return;
+    }
+
+    O->hash_val=h1;
+    O->hash_val2=h2;
+    O->start=route[r].start;
+    O->length=route[r].length;
+    O->heuristics=heuristics;
+}
+
+bool VRP::create_search_neighborhood(int j, int rules)
+{
+    ///
+    /// Creates the search_size and search_space fields for the
+    /// current VRP in terms of the given node j and the rules.
+    ///
+
+    int i,k,r,cnt;
+    VRPIndex *members;
+    // Define the search space
+    
+
+    if( rules & VRPH_USE_NEIGHBOR_LIST )
+    {
+
+        // Search only those nodes that are in the neighbor list
+        search_size=0;
+        cnt=0;
+        for(i=0;i<neighbor_list_size;i++)
+        {
+            // Consider node k
+            k=nodes[j].neighbor_list[i].position;
+            if( routed[k] == true)
+            {
+                // The node is routed 
+                if(rules & VRPH_INTER_ROUTE_ONLY)
+                {
+                    // Make sure k is in a different route
+                    if(route_num[k]!=route_num[j])
+                    {
+                        search_space[cnt] = k;
+                        cnt++;
+                        
+                    }
+                }
+                else
+                {
+                    if(rules & VRPH_INTRA_ROUTE_ONLY)
+                    {
+                        // Make sure k is in the same route
+
+                        if(route_num[k]==route_num[j])
                         {
                             // The node is in a different route - add to the search space
                             search_space[cnt] = k;
@@ -2721,126 +3365,89 @@ bool VRP::create_search_neighborhood(int j, int rules)
     }
 
 
-    // Otherwise no neighborlist
+    // Otherwise no neighborlist - the search spaces are copied from the
+    // lists of route customers
     if( (rules & VRPH_INTRA_ROUTE_ONLY) )
     {        
         // Search_space is just the route itself
+        r=route_num[j];
         search_space[0]=VRPH_DEPOT;
-        search_space[1]=this->route[route_num[j]].start;
-        for(i=2;i<=this->route[route_num[j]].num_customers;i++)
-            search_space[i]=this->next_array[search_space[i-1]];
-
-        search_size=this->route[route_num[j]].num_customers+1;//add 1 for depot
+        memcpy(search_space+1,this->route_customers(r),route[r].num_customers*sizeof(VRPIndex));
+        search_size=route[r].num_customers+1;//add 1 for depot
 
         goto randomize;
-
-        /*
-
-        search_size=0;
-        i=0;
-        search_space[i]=VRPH_DEPOT;
-        i++;
-        search_space[i]=route[route_num[j]].start;
-        for(;;)
-        {
-            search_space[i]=next_array[search_space[i]];
-            if(search_space[i]<=VRPH_DEPOT)
-            {
-                search_size=i;
-                goto randomize;
-            }
-            i++;
-        }*/
-
     }
 
     if( (rules & VRPH_INTER_ROUTE_ONLY) )
     {        
         // Only nodes in a different route        
-        i=0;
-        search_space[i]=VRPH_DEPOT;
-        search_size=1;
-        k=VRPH_ABS(next_array[search_space[i]]);    
-        i++;
-
-        for(;;)
+        search_space[0]=VRPH_DEPOT;
+        cnt=1;
+        k=VRPH_ABS(next_array[VRPH_DEPOT]);
+        while(k!=VRPH_DEPOT)
         {
-            if(k==VRPH_DEPOT)
-                // end of solution
-                goto randomize;
-
-            if(route_num[k]!=route_num[j])
+            r=route_num[k];
+            if(r!=route_num[j])
             {
-                search_space[i]=k;
-                i++;
-                search_size++;
+                memcpy(search_space+cnt,this->route_customers(r),route[r].num_customers*sizeof(VRPIndex));
+                cnt+=route[r].num_customers;
             }
-            k=VRPH_ABS(next_array[k]);
+            k=VRPH_ABS(next_array[route[r].end]);
         }
+        search_size=cnt;
+        goto randomize;
 
     }
 
-    
-    // Search space will consist of all positions in routes moving in the
-    // given direction
-
-    if((rules & VRPH_FORWARD))
+    if((rules & VRPH_BACKWARD) && !(rules & VRPH_FORWARD))
     {
-        search_size=0;
-
-        i=0;
-        search_space[i]=VRPH_ABS(next_array[route[route_num[j]].end]);
-        search_size++;
-
-        // First node in next route in the solution
-        for(;;)
+        // All positions in the routes before the route of j, last node in
+        // the previous route first, ending with the VRPH_DEPOT
+        cnt=0;
+        k=VRPH_ABS(pred_array[route[route_num[j]].start]);
+        if(k==VRPH_DEPOT)
         {
-            search_space[i+1]=VRPH_ABS(next_array[search_space[i]]);    
-            search_size++;
-            if(search_space[i+1]==VRPH_DEPOT)
-                goto randomize;
-            i++;
-
+            // j is in the first route - wrap around to the last one
+            search_space[cnt++]=VRPH_DEPOT;
+            k=VRPH_ABS(pred_array[VRPH_DEPOT]);
         }
-
-    }
-
-    if((rules & VRPH_BACKWARD))
-    {
-        search_size=0;
-
-        i=0;
-        search_space[i]=VRPH_ABS(pred_array[route[route_num[j]].start]);
-        search_size++;
-
-        // Last node in previous route in the solution
-        for(;;)
+        while(k!=VRPH_DEPOT)
         {
-            search_space[i+1]=VRPH_ABS(pred_array[search_space[i]]);    
-            search_size++;
-            if(search_space[i+1]==VRPH_DEPOT)
-                goto randomize;
-            i++;
-
+            r=route_num[k];
+            members=this->route_customers(r);
+            for(i=route[r].num_customers-1;i>=0;i--)
+                search_space[cnt++]=members[i];
+            k=VRPH_ABS(pred_array[route[r].start]);
         }
-    
+        search_space[cnt++]=VRPH_DEPOT;
+        search_size=cnt;
+        goto randomize;
     }
 
-    // No rules given - search space is set of all nodes
-    search_size=0;
-    i=0;
-
-    search_space[i]=VRPH_ABS(next_array[VRPH_DEPOT]);
-    search_size++;
+    if((rules & VRPH_FORWARD))
+        // All positions in the routes after the route of j, first node in
+        // the next route first, ending with the VRPH_DEPOT
+        k=VRPH_ABS(next_array[route[route_num[j]].end]);
+    else
+        // No rules given - search space is set of all nodes
+        k=VRPH_ABS(next_array[VRPH_DEPOT]);
 
-    for(;;)
+    cnt=0;
+    if(k==VRPH_DEPOT)
     {
-        search_space[i+1]=VRPH_ABS(next_array[search_space[i]]);    
-        search_size++;
-        if(search_space[i+1]==VRPH_DEPOT)
-            goto randomize;
-        i++;
+        // Wrap around to the first route
+        search_space[cnt++]=VRPH_DEPOT;
+        k=VRPH_ABS(next_array[VRPH_DEPOT]);
+    }
+    while(k!=VRPH_DEPOT)
+    {
+        r=route_num[k];
+        memcpy(search_space+cnt,this->route_customers(r),route[r].num_customers*sizeof(VRPIndex));
+        cnt+=route[r].num_customers;
+        k=VRPH_ABS(next_array[route[r].end]);
     }
+    search_space[cnt++]=VRPH_DEPOT;
+    search_size=cnt;
 
 randomize:
 
@@ -2898,7 +3505,7 @@ double VRP::insertion_cost(int u, int a, int b)
     else
         new_route=route_num[a];
 
-    if(nodes[u].demand+route[new_route].load>max_veh_capacity)
+    if(demand_array[u]+route[new_route].load>max_veh_capacity)
         return VRP_INFEASIBLE;
     
     double increase=d[a][u] + d[u][b] - d[a][b];
@@ -2938,17 +3545,19 @@ void VRP::clean_route(int r, int heuristics)
     /// until a local minimum is reached.
     ///
 
-    int i,j, r_start, r_end;
-    double start_val, end_val, start_rlen, end_rlen;
+    double start_val, end_val;
 
-    OnePointMove    OPM;
-    TwoPointMove    TPM;
-    TwoOpt            TO;
     ThreeOpt        ThreeO;
-    OrOpt            OrO;
+    HeldKarp        HK;
 
     int rules= VRPH_INTRA_ROUTE_ONLY+VRPH_DOWNHILL+VRPH_FIRST_ACCEPT+VRPH_SAVINGS_ONLY;
 
+    // Nothing to do if the route is already known to be a local minimum.
+    // The route memo has no bit for HELD_KARP, so it is not consulted when
+    // the routes are solved exactly.
+    if(!this->use_held_karp && this->route_is_optimal(r,heuristics))
+        return;
+
 
 start_improving:
 
@@ -2959,6 +3568,132 @@ start_improving:
 #endif
 
     end_val = - VRP_INFINITY;
+
+    this->clean_route_moves(r,heuristics);
+
+    if(this->use_held_karp)
+    {
+        // Short routes are solved exactly and longer ones searched with
+        // ThreeOpt, in place of the THREE_OPT search
+        while(HK.route_search(this,r,rules));
+
+#if CLEAN_DEBUG
+        printf("CLEAN::HK end_val=%f\n",route[r].length);
+#endif
+    }
+    else if((heuristics & THREE_OPT)==THREE_OPT)
+    {
+        //show_route(r);
+
+        while(ThreeO.route_search(this,r,rules))
+
+            end_val = route[r].length;
+#if CLEAN_DEBUG
+        printf("CLEAN::3O end_val=%f\n",end_val);
+#endif
+
+
+    }
+
+    end_val= route[r].length;
+
+#if CLEAN_DEBUG
+    printf("CLEAN::final end_val=%f\n",end_val);
+#endif
+
+
+    if(VRPH_ABS(start_val-end_val)>VRPH_EPSILON)
+        goto start_improving;
+
+    this->route_found_optimal(r,heuristics);
+    return;
+
+}
+
+void VRP::clean_routes(int heuristics)
+{
+    ///
+    /// Runs clean_route on every route.  The routes are cleaned together:
+    /// each pass runs the searches of clean_route_moves on every route that
+    /// is not yet a local minimum and then the THREE_OPT (or HELD_KARP)
+    /// search on all of them at once, which spreads the routes over the
+    /// threads when VRPH is built with OpenMP.  Each route goes through
+    /// the same searches as in clean_route, so the routes end up the same.
+    ///
+
+    int i,k,r,R,num_routes;
+    int *routes;
+    double *start_val;
+
+    ThreeOpt        ThreeO;
+    HeldKarp        HK;
+
+    int rules= VRPH_INTRA_ROUTE_ONLY+VRPH_DOWNHILL+VRPH_FIRST_ACCEPT+VRPH_SAVINGS_ONLY;
+
+    R=this->total_number_of_routes;
+    routes=new int[R+1];
+    start_val=new double[R+1];
+
+    num_routes=0;
+    for(r=1;r<=R;r++)
+    {
+        if(route[r].num_customers==0)
+            continue;
+        if(!this->use_held_karp && this->route_is_optimal(r,heuristics))
+            continue;
+        routes[num_routes++]=r;
+    }
+
+    while(num_routes>0)
+    {
+        for(i=0;i<num_routes;i++)
+        {
+            r=routes[i];
+            start_val[i]=route[r].length;
+            this->clean_route_moves(r,heuristics);
+        }
+
+        if(this->use_held_karp)
+            HK.search_routes(this,rules);
+        else if((heuristics & THREE_OPT)==THREE_OPT)
+            ThreeO.search_routes(this,num_routes,routes,rules);
+
+        // Keep the routes that changed
+        k=0;
+        for(i=0;i<num_routes;i++)
+        {
+            r=routes[i];
+            if(VRPH_ABS(start_val[i]-route[r].length)>VRPH_EPSILON)
+                routes[k++]=r;
+            else
+                this->route_found_optimal(r,heuristics);
+        }
+        num_routes=k;
+    }
+
+    delete [] routes;
+    delete [] start_val;
+
+}
+
+void VRP::clean_route_moves(int r, int heuristics)
+{
+    ///
+    /// Runs the ONE_POINT_MOVE, TWO_POINT_MOVE, TWO_OPT and OR_OPT
+    /// searches of clean_route on route r, each until it no longer
+    /// improves the route.
+    ///
+
+    int i,j, r_start, r_end;
+    double start_rlen, end_rlen;
+
+    OnePointMove    OPM;
+    TwoPointMove    TPM;
+    TwoOpt            TO;
+    OrOpt            OrO;
+
+    int rules= VRPH_INTRA_ROUTE_ONLY+VRPH_DOWNHILL+VRPH_FIRST_ACCEPT+VRPH_SAVINGS_ONLY;
+
     r_start=route[r].start;
     r_end=route[r].end;
 
@@ -3069,41 +3804,15 @@ or_search:
 
     }
 
-    if((heuristics & THREE_OPT)==THREE_OPT)
-    {
-        //show_route(r);
+}
 
-        while(ThreeO.route_search(this,r,rules))
-
-            end_val = route[r].length;
-#if CLEAN_DEBUG
-        printf("CLEAN::3O end_val=%f\n",end_val);
-#endif
-
-
-    }
-
-    end_val= route[r].length;
-
-#if CLEAN_DEBUG
-    printf("CLEAN::final end_val=%f\n",end_val);
-#endif
-
-
-    if(VRPH_ABS(start_val-end_val)>VRPH_EPSILON)
-        goto start_improving;
-    else
-        return;
-
-}
-
-bool VRP::before(int a, int b)
-{
-    ///
-    /// This function returns TRUE if a comes before b in their route
-    /// and FALSE if b is before a. An error is reported if a and b are in different routes.
-    /// Should be used sparingly as it loops and can be slow for large routes.
-    ///
+bool VRP::before(int a, int b)
+{
+    ///
+    /// This function returns TRUE if a comes before b in their route
+    /// and FALSE if b is before a. An error is reported if a and b are in different routes.
+    /// Should be used sparingly as it loops and can be slow for large routes.
+    ///
 
     int i;
 
@@ -3148,6 +3857,13 @@ void VRP::update(VRPMove *M)
 
     int i;
 
+    // Save the routes before the caller modifies them
+    if(this->journal_on)
+    {
+        for(i=0; i < M->num_affected_routes; i++)
+            this->journal_route_info(M->route_nums[i]);
+    }
+
     for(i=0; i < M->num_affected_routes; i++)
     {
         // Update length
@@ -3158,6 +3874,13 @@ void VRP::update(VRPMove *M)
 
         // Update # of customers
         route[M->route_nums[i]].num_customers = M->route_custs[i];
+
+        // Arrival times must be recomputed
+        route_changed(M->route_nums[i]);
+
+        // Remember emptied routes so that their ids can be reclaimed
+        if(M->route_custs[i]==0)
+            free_routes[num_free_routes++] = M->route_nums[i];
     }
 
     // Now update total_route_length
@@ -3207,7 +3930,6 @@ void VRP::find_neighboring_routes()
     VRPNeighborElement **rd;
 
     // Compute the route centers
-    normalize_route_numbers();
     for(i=1;i<=total_number_of_routes;i++)
     {
         compute_route_center(i);
@@ -3275,10 +3997,16 @@ void VRP::capture_best_solution()
     if(this->total_route_length < this->solution_wh->worst_obj || 
         this->solution_wh->num_sols < this->solution_wh->max_size)
     {
+        // The solution_hash is always current, so duplicates are rejected
+        // before exporting anything
+        if(this->solution_wh->contains(this->solution_hash,this->total_route_length))
+            return;
+
         VRPSolution this_sol(this->num_nodes);
 
         this_sol.obj=this->total_route_length;
         this_sol.in_IP=false;
+        this_sol.edge_hash=this->solution_hash;
 
         // Export buffer
         this->export_canonical_solution_buff(this_sol.sol);
@@ -3292,6 +4020,55 @@ void VRP::capture_best_solution()
     
 }
 
+VRPHash VRP::hash_solution()
+{
+    ///
+    /// Computes the edge hash of the current solution from scratch.  The
+    /// result should always equal solution_hash, which the moves maintain.
+    ///
+
+    VRPHash h;
+    int current;
+
+    h=next_key(VRPH_DEPOT,next_array[VRPH_DEPOT]);
+    current=VRPH_ABS(next_array[VRPH_DEPOT]);
+    while(current!=VRPH_DEPOT)
+    {
+        h+=next_key(current,next_array[current]);
+        current=VRPH_ABS(next_array[current]);
+    }
+
+    return h;
+
+}
+
+VRPHash VRP::hash_route(int r)
+{
+    ///
+    /// Computes the edge hash of route r, including its two VRPH_DEPOT edges.
+    /// Unless there are time windows the value does not depend on the
+    /// orientation of the route.
+    ///
+
+    VRPHash h;
+    int current;
+
+    if(route[r].num_customers==0)
+        return 0;
+
+    current=route[r].start;
+    h=edge_key(VRPH_DEPOT,current);
+    while(next_array[current]>0)
+    {
+        h+=edge_key(current,next_array[current]);
+        current=next_array[current];
+    }
+    h+=edge_key(current,VRPH_DEPOT);
+
+    return h;
+
+}
+
 void VRP::update_solution_wh()
 {
     ///
@@ -3302,6 +4079,7 @@ void VRP::update_solution_wh()
 
     this_sol.obj=this->total_route_length;
     this_sol.in_IP=false;
+    this_sol.edge_hash=this->solution_hash;
 
     // Export buffer
     this->export_canonical_solution_buff(this_sol.sol);
@@ -3344,12 +4122,12 @@ void VRP::update_route(int j, VRPRoute *R)
         R->ordering[0]=current;
         R->x[1]=this->nodes[current].x;
         R->y[1]=this->nodes[current].y;
-        st+=this->nodes[current].service_time;
+        st+=this->service_time_array[current];
 
         for(i=1; i<R->num_customers; i++)
         {
             current=this->next_array[current];
-            st+=this->nodes[current].service_time;
+            st+=this->service_time_array[current];
             R->ordering[i]=current;
             R->x[i+1]=this->nodes[current].x;
             R->y[i+1]=this->nodes[current].y;
@@ -3365,13 +4143,13 @@ void VRP::update_route(int j, VRPRoute *R)
     R->ordering[0]=current;
     R->x[1]=this->nodes[current].x;
     R->y[1]=this->nodes[current].y;
-    st+=this->nodes[current].service_time;
+    st+=this->service_time_array[current];
 
 
     for(i=1; i<R->num_customers; i++)
     {
         current=this->pred_array[current];
-        st+=this->nodes[current].service_time;
+        st+=this->service_time_array[current];
         R->ordering[i]=current;
         R->x[i+1]=this->nodes[current].x;
         R->y[i+1]=this->nodes[current].y;
@@ -3554,22 +4332,42 @@ void VRP::fix_edge(int start, int end)
     /// VRPH_FIXED_EDGES rules.
     ///
 
-    this->fixed[start][end]=true;
-    this->fixed[end][start]=true;
+    int i,k;
+    bool full;
+
+    if(start==end || this->is_fixed(start,end))
+        return;
 
-    // Handle the dummy_node
-    if(start==VRPH_DEPOT)
+    // A customer on more than two fixed edges cannot be in a feasible solution,
+    // but the edge is still kept, in the edge set if a slot is missing
+    full=false;
+    for(k=0;k<2;k++)
     {
-        this->fixed[dummy_index][start]=true;
-        this->fixed[start][dummy_index]=true;
+        i=(k==0)?start:end;
+        if(i!=VRPH_DEPOT && this->fixed_neighbors[2*i]!=-1 && this->fixed_neighbors[2*i+1]!=-1)
+            full=true;
     }
 
-    if(end==VRPH_DEPOT)
+    if(full)
+        this->fixed_edge_set->add(start,end);
+    else
     {
-        this->fixed[dummy_index][end]=true;
-        this->fixed[end][dummy_index]=true;
+        for(k=0;k<2;k++)
+        {
+            // Record the edge at each customer endpoint
+            i=(k==0)?start:end;
+            if(i==VRPH_DEPOT)
+                continue;
+
+            if(this->fixed_neighbors[2*i]==-1)
+                this->fixed_neighbors[2*i]=(k==0)?end:start;
+            else
+                this->fixed_neighbors[2*i+1]=(k==0)?end:start;
+        }
     }
 
+    if(start==VRPH_DEPOT || end==VRPH_DEPOT)
+        this->num_fixed_depot_edges++;
 
 }
 
@@ -3579,25 +4377,28 @@ void VRP::unfix_edge(int start, int end)
     /// Unfixes an edge that is already fixed.
     ///
 
-    if(this->fixed[start][end])
-        report_error("%s: Edge %d-%d is not already fixed!\n",__FUNCTION__,start,end);
+    int i,k;
 
-    this->fixed[start][end]=false;
-    this->fixed[end][start]=false;
+    if(!this->is_fixed(start,end))
+        report_error("%s: Edge %d-%d is not already fixed!\n",__FUNCTION__,start,end);
 
-    // Handle the dummy_node
-    if(start==VRPH_DEPOT)
+    if(!this->fixed_edge_set->remove(start,end))
     {
-        this->fixed[dummy_index][start]=false;
-        this->fixed[start][dummy_index]=false;
-    }
+        for(k=0;k<2;k++)
+        {
+            i=(k==0)?start:end;
+            if(i==VRPH_DEPOT)
+                continue;
 
-    if(end==VRPH_DEPOT)
-    {
-        this->fixed[dummy_index][end]=false;
-        this->fixed[end][dummy_index]=false;
+            if(this->fixed_neighbors[2*i]==((k==0)?end:start))
+                this->fixed_neighbors[2*i]=-1;
+            else
+                this->fixed_neighbors[2*i+1]=-1;
+        }
     }
 
+    if(start==VRPH_DEPOT || end==VRPH_DEPOT)
+        this->num_fixed_depot_edges--;
 
 }
 
@@ -3607,9 +4408,10 @@ void VRP::unfix_all()
     /// Unfixes any and all edges that may be currently fixed.
     ///
 
-    for(int i=0;i<=matrix_size;i++)
-        for(int j=0;j<=matrix_size;j++)
-            fixed[i][j]=false;
+    for(int i=0;i<2*(this->num_original_nodes+2);i++)
+        fixed_neighbors[i]=-1;
+    fixed_edge_set->clear();
+    num_fixed_depot_edges=0;
 }
 
 void VRP::fix_string(int *node_string, int k)
@@ -3678,7 +4480,7 @@ void VRP::list_fixed_edges(int *fixed_list)
     ///
     /// Looks through the current solution and places all edges that
     /// are currently fixed and in the solution in the fixed_list[] array.
-    /// So if fixed[2][3]==true and fixed[3][7]==true, the array
+    /// So if edges 2-3 and 3-7 are fixed, the array
     /// fixed_list[] is {2,3,3,7}.
     ///
 
@@ -3688,7 +4490,7 @@ void VRP::list_fixed_edges(int *fixed_list)
 
     while(next!=VRPH_DEPOT)
     {
-        if(fixed[current][next])
+        if(is_fixed(current,next))
         {
             fixed_list[pos]=current;
             fixed_list[pos+1]=next;
@@ -3700,14 +4502,14 @@ void VRP::list_fixed_edges(int *fixed_list)
 
         if(next<0)
         {
-            if(fixed[current][VRPH_DEPOT])
+            if(is_fixed(current,VRPH_DEPOT))
             {
                 fixed_list[pos]=current;
                 fixed_list[pos+1]=VRPH_DEPOT;
                 pos+=2;
             }
 
-            if(fixed[VRPH_DEPOT][-next])
+            if(is_fixed(VRPH_DEPOT,-next))
             {
                 fixed_list[pos]=VRPH_DEPOT;
                 fixed_list[pos+1]=-next;
@@ -3741,7 +4543,7 @@ void VRP::perturb_locations(double c)
         pre= VRPH_MAX(VRPH_DEPOT,this->pred_array[i]);
         post=VRPH_MAX(VRPH_DEPOT,this->next_array[i]);
 
-        v= (this->d[pre][i]+this->d[i][post]) - (this->nodes[i].service_time + this->nodes[post].service_time);
+        v= (this->d[pre][i]+this->d[i][post]) - (this->service_time_array[i] + this->service_time_array[post]);
         v= v*c;
 
         // Now alter the location of node i by shifting v units in a random direction theta
@@ -3775,11 +4577,11 @@ void VRP::add_route(int *route_buff)
     // Probably not the fastest way, but we have many fields to update when adding a
     // new route!
 
-    int *temp_buff;
+    VRPIndex *temp_buff;
 
     this->verify_routes("Before adding route\n");
 
-    temp_buff=new int[this->num_original_nodes+2];
+    temp_buff=new VRPIndex[this->num_original_nodes+2];
     this->export_solution_buff(temp_buff);
 
 
@@ -3805,7 +4607,7 @@ void VRP::add_route(int *route_buff)
     delete [] temp_buff;
 
 }
-void VRP::append_route(int *sol_buff, int *route_buff)
+void VRP::append_route(VRPIndex *sol_buff, int *route_buff)
 {
     ///
     /// Appends the single route contained in route_buff[] (which ends in a -1)
@@ -3841,7 +4643,7 @@ void VRP::append_route(int *sol_buff, int *route_buff)
 
 }
 
-int VRP::intersect_solutions(int *new_sol, int **route_list, int *sol1, int *sol2, int min_routes)
+int VRP::intersect_solutions(VRPIndex *new_sol, int **route_list, VRPIndex *sol1, VRPIndex *sol2, int min_routes)
 {
     ///
     /// Takes the two solutions sol1 and sol2 and constructs a smaller instance by
@@ -3865,7 +4667,7 @@ int VRP::intersect_solutions(int *new_sol, int **route_list, int *sol1, int *sol
     if(j==0)
     {
         // No routes in common - just put sol1 into new_sol
-        memcpy(new_sol,sol1, (this->num_original_nodes+2)*sizeof(int));
+        memcpy(new_sol,sol1, (this->num_original_nodes+2)*sizeof(VRPIndex));
         delete[] rnums;
         return 0;
     }
@@ -3959,7 +4761,7 @@ bool VRP::osman_insert(int k, double alpha)
             if(savings<best_savings && l!=i && m!=j)
             {
                 // Now check feasibility-put k before m
-                if(presert.evaluate(this,k,m,&M)==true)
+                if(presert.evaluate(this,k,m,&M)==true && this->is_feasible(&M,0))
                 {
                     best_savings=savings;
                     best_l=l;
@@ -3977,7 +4779,7 @@ bool VRP::osman_insert(int k, double alpha)
             if(savings<best_savings && l!=i && mm!=j)
             {
                 // put k after l
-                if(postsert.evaluate(this,k,l,&M)==true)
+                if(postsert.evaluate(this,k,l,&M)==true && this->is_feasible(&M,0))
                 {
                     best_savings=savings;
                     best_l=l;
@@ -3992,7 +4794,7 @@ bool VRP::osman_insert(int k, double alpha)
             if(savings<best_savings && ll!=i && m!=j)
             {
                 // put k before m
-                if(presert.evaluate(this,k,m,&M)==true)
+                if(presert.evaluate(this,k,m,&M)==true && this->is_feasible(&M,0))
                 {
                     best_savings=savings;
                     best_l=ll;
@@ -4074,61 +4876,46 @@ bool VRP::check_fixed_edges(const char *message)
     /// is displayed and the provided message is printed before exiting.
     ///
 
+    int i,j,k;
 
-
-    int i,j;
-
-    for(i=0;i<=this->num_original_nodes;i++)
+    // Every fixed edge has at least one customer endpoint i
+    for(i=1;i<=this->num_original_nodes;i++)
     {
-        for(j=0;j<=this->num_original_nodes;j++)
+        for(k=0;k<2;k++)
         {
-            if(this->fixed[i][j])
-            {
-                // Make sure i-j or j-i exists
-                if(i!=VRPH_DEPOT)
-                {
-                    if(VRPH_MAX(this->next_array[i],VRPH_DEPOT)!=j && VRPH_MAX(this->pred_array[i],VRPH_DEPOT)!=j)
-                    {
-                        fprintf(stderr,"Fixed edge %d-%d not in solution!!",i,j);
-                        fprintf(stderr,"%d-%d-%d\n",VRPH_MAX(this->pred_array[i],VRPH_DEPOT),i,
-                            VRPH_MAX(this->next_array[i],VRPH_DEPOT));
-                        fprintf(stderr,message);
+            j=this->fixed_neighbors[2*i+k];
+            if(j==-1)
+                continue;
 
-                        if(this->fixed[j][i])
-                            fprintf(stderr,"%d-%d also fixed\n",j,i);
-                        else
-                            fprintf(stderr,"%d-%d NOT fixed!\n",j,i);
-
-                        return false;
-                    }
-                }
-
-                // Make sure i-j or j-i exists
-                if(j!=VRPH_DEPOT)
-                {
-                    if(VRPH_MAX(this->next_array[j],VRPH_DEPOT)!=i && VRPH_MAX(this->pred_array[j],VRPH_DEPOT)!=i)
-                    {
-                        fprintf(stderr,"Fixed edge %d-%d not in solution!!",i,j);
-                        fprintf(stderr,"%d-%d-%d\n",VRPH_MAX(this->pred_array[j],VRPH_DEPOT),j,
-                            VRPH_MAX(this->next_array[j],VRPH_DEPOT));
-                        fprintf(stderr,message);
-                        if(this->fixed[j][i])
-                            fprintf(stderr,"%d-%d also fixed\n",j,i);
-                        else
-                            fprintf(stderr,"%d-%d NOT fixed!\n",j,i);
-                        return false;
-
-                    }
-                }
+            // Make sure i-j or j-i exists
+            if(VRPH_MAX(this->next_array[i],VRPH_DEPOT)!=j && VRPH_MAX(this->pred_array[i],VRPH_DEPOT)!=j)
+            {
+                fprintf(stderr,"Fixed edge %d-%d not in solution!!",i,j);
+                fprintf(stderr,"%d-%d-%d\n",VRPH_MAX(this->pred_array[i],VRPH_DEPOT),i,
+                    VRPH_MAX(this->next_array[i],VRPH_DEPOT));
+                fprintf(stderr,"%s",message);
+                return false;
             }
-    
         }
+    }
+
+    // The edges in the edge set have b>a, so b is a customer
+    for(k=0;k<this->fixed_edge_set->size;k++)
+    {
+        if(!this->fixed_edge_set->get_edge(k,&j,&i))
+            continue;
 
+        if(VRPH_MAX(this->next_array[i],VRPH_DEPOT)!=j && VRPH_MAX(this->pred_array[i],VRPH_DEPOT)!=j)
+        {
+            fprintf(stderr,"Fixed edge %d-%d not in solution!!",i,j);
+            fprintf(stderr,"%s",message);
+            return false;
+        }
     }
 
     return true;
 }
-int VRP::find_common_routes(int *sol1, int *sol2, int *route_nums)
+int VRP::find_common_routes(VRPIndex *sol1, VRPIndex *sol2, int *route_nums)
 {
     ///
     /// Finds the routes that are shared by the two solutions sol1 and sol2.
@@ -4203,6 +4990,9 @@ void VRP::set_daily_demands(int day)
     /// integer.  If a day of 0 is given, then we set the demand to the mean value.
     ///
 
+    if(!this->owns_instance)
+        report_error("%s: the instance data is shared\n",__FUNCTION__);
+
     int i;
 
     if(day>0)
@@ -4239,6 +5029,8 @@ void VRP::set_daily_demands(int day)
         }    
 
     }
+
+    this->update_node_arrays();
 }
 
 void VRP::set_daily_service_times(int day)
@@ -4248,69 +5040,552 @@ void VRP::set_daily_service_times(int day)
     /// for the given day.  Used for period VRPs.
     ///
 
+    if(!this->owns_instance)
+        report_error("%s: the instance data is shared\n",__FUNCTION__);
+
     int i;
 
     for(i=0;i<=this->num_original_nodes;i++)
     {
         this->nodes[i].service_time=this->nodes[i].daily_service_times[day];
     }
+    this->update_node_arrays();
 
     // We also have to recompute the distance matrix if the service times are not identical
     // across the days
     this->create_distance_matrix(this->edge_weight_type);
 }
 
+void VRP::update_node_arrays()
+{
+    ///
+    /// Copies the demand and service time of each node (including the
+    /// VRPH_DEPOT and the dummy node) into demand_array[] and 
+    /// service_time_array[].  Must be called whenever these values
+    /// change in nodes[].
+    ///
+
+    if(!this->owns_instance)
+        report_error("%s: the instance data is shared\n",__FUNCTION__);
+
+    int i;
+
+    for(i=0;i<=this->num_original_nodes+1;i++)
+    {
+        this->demand_array[i]=this->nodes[i].demand;
+        this->service_time_array[i]=this->nodes[i].service_time;
+    }
+}
 
 void VRP::update_arrival_times()
 {
     ///
-    /// Computes the arrival time at all customers.
+    /// Computes the arrival time at all customers.  Each route is
+    /// traversed once so this is linear in the number of nodes.
     ///
 
-    int routenum, next, current;
-    double t;
+    int i;
+
+    for(i=1;i<=this->total_number_of_routes;i++)
+        this->update_route_times(i);
+
+    // Set the arrival times to -1 so that the only ones with positive
+    // arrival_time values are those that are actually visited.
+    // Shared nodes belong to another VRP and are left alone.
+    if(!this->owns_instance)
+        return;
+    for(i=1;i<=this->num_original_nodes;i++)
+    {
+        if(routed[i])
+            this->nodes[i].arrival_time=this->arrival_time[i];
+        else
+            this->nodes[i].arrival_time=-1;
+    }
+
+}
+
+void VRP::update_route_times(int r)
+{
+    ///
+    /// Computes the arrival time, waiting time and forward time slack at each
+    /// node in route r.  The slack at node i is the largest delay in the start
+    /// of service at i that leaves the rest of the route feasible.  The dummy
+    /// node is skipped so that this can be called while it is in a route.
+    ///
 
-    // Set the arrival times to -1 so that the only ones with positive 
-    // arrival_time values are those that are actually visited
-    for(int i=1;i<=this->num_original_nodes;i++)
-        this->nodes[i].arrival_time=-1;
+    int current, prev, last;
+    double t, slack;
 
+    t=VRPH_MAX(this->nodes[VRPH_DEPOT].start_tw,0);
+    prev=VRPH_DEPOT;
+    last=VRPH_DEPOT;
+    current=this->route[r].start;
 
-    for(int i=1;i<=this->num_original_nodes;i++)
+    // Forward pass - arrival and waiting times
+    while(current>0)
     {
+        if(current!=this->dummy_index)
+        {
+            t+=this->travel_time(prev,current);
+            this->arrival_time[current]=t;
+            this->wait_time[current]=VRPH_MAX(0,this->nodes[current].start_tw-t);
+            t+=this->wait_time[current]+this->service_time_array[current];
+            prev=current;
+            last=current;
+        }
+        current=this->next_array[current];
+    }
 
-        if(routed[i])
+    // Backward pass - forward time slacks, starting from the return to the depot
+    slack=this->nodes[VRPH_DEPOT].end_tw-(t+this->travel_time(prev,VRPH_DEPOT));
+    current=last;
+    while(current>0)
+    {
+        if(current!=this->dummy_index)
         {
-            // Get the route number
-            routenum=this->route_num[i];
+            slack=VRPH_MIN(slack,this->nodes[current].end_tw-
+                (this->arrival_time[current]+this->wait_time[current]));
+            this->time_slack[current]=slack;
+            slack+=this->wait_time[current];
+        }
+        current=this->pred_array[current];
+    }
 
-            // Start at the beginning of this route
-            current=this->route[routenum].start;
-            t=this->d[VRPH_DEPOT][current];
+    this->route[r].times_valid=true;
 
-            while(current!=i)
-            {
-                next=VRPH_MAX(VRPH_DEPOT, this->next_array[current]);
-                t+=this->d[current][next];
-                current=next;
+}
 
-            }
+double VRP::travel_time(int i, int j)
+{
+    ///
+    /// Returns the travel time from i to j.  The distance matrix includes half
+    /// of the service time at each end, so this is removed.  The dummy node
+    /// is treated as the depot.
+    ///
+
+    if(i==this->dummy_index)
+        i=VRPH_DEPOT;
+    if(j==this->dummy_index)
+        j=VRPH_DEPOT;
+
+    return this->d[i][j]-.5*(this->service_time_array[i]+this->service_time_array[j]);
+
+}
+
+double VRP::departure_time(int i)
+{
+    ///
+    /// Returns the time at which service at i is completed in the current
+    /// solution.  The depot and dummy node are assumed to be the start of a route.
+    ///
+
+    if(i==VRPH_DEPOT || i==this->dummy_index)
+        return VRPH_MAX(this->nodes[VRPH_DEPOT].start_tw,0);
+
+    return this->arrival_time[i]+this->wait_time[i]+this->service_time_array[i];
+
+}
+
+bool VRP::tw_visit(double *t, int *prev, int j)
+{
+    ///
+    /// Travels from *prev (left at time *t) to j and serves j.  Returns false
+    /// if j's time window is missed; otherwise *t becomes the departure time from j.
+    ///
+
+    *t+=this->travel_time(*prev,j);
+    if(*t>this->nodes[j].end_tw+VRPH_EPSILON)
+        return false;
+
+    *t=VRPH_MAX(*t,this->nodes[j].start_tw)+this->service_time_array[j];
+    *prev=j;
+    return true;
+
+}
+
+bool VRP::tw_visit_string(double *t, int *prev, int first, int last, bool reversed)
+{
+    ///
+    /// Visits the string of nodes from first to last, following the current
+    /// next_array (or pred_array if reversed is true).
+    ///
+
+    int current=first;
+
+    while(true)
+    {
+        if(current<=VRPH_DEPOT)
+            report_error("%s: string %d..%d is not in a single route\n",__FUNCTION__,first,last);
+
+        if(this->tw_visit(t,prev,current)==false)
+            return false;
+        if(current==last)
+            return true;
+
+        if(reversed)
+            current=this->pred_array[current];
+        else
+            current=this->next_array[current];
+    }
+
+}
+
+bool VRP::tw_push(double t, int prev, int k, double *push)
+{
+    ///
+    /// Travels from prev (left at time t) to k, where k and the rest of its route
+    /// are unchanged.  *push is set to the change in the start of service at k,
+    /// and the function returns true if the rest of the route remains feasible.
+    ///
+
+    double arrival=t+this->travel_time(prev,k);
+
+    *push=0;
+    if(k==VRPH_DEPOT || k==this->dummy_index)
+        return (arrival<=this->nodes[VRPH_DEPOT].end_tw+VRPH_EPSILON);
+
+    *push=VRPH_MAX(arrival,this->nodes[k].start_tw)-
+        (this->arrival_time[k]+this->wait_time[k]);
+
+    if(*push<=VRPH_EPSILON)
+        return true;
+
+    return (*push<=this->time_slack[k]+VRPH_EPSILON);
+
+}
+
+bool VRP::tw_splice(int p, double delay, int first, int last, bool reversed, int k, double *push)
+{
+    ///
+    /// Checks the route change p-first...last-k, where the string first..last
+    /// is visited as in tw_visit_string() and service at p is completed
+    /// delay time units later than it is now.  Use first=-1 if there is no string.
+    ///
+
+    double t=this->departure_time(p)+delay;
+    int prev=p;
+
+    if(first!=-1 && this->tw_visit_string(&t,&prev,first,last,reversed)==false)
+        return false;
+
+    return this->tw_push(t,prev,k,push);
+
+}
+
+bool VRP::tw_before(int p, int q)
+{
+    ///
+    /// Returns true if p comes before q in their route.  p and q may be the
+    /// depot or dummy node at the start of the route.
+    ///
+
+    if(p==VRPH_DEPOT || p==this->dummy_index)
+        return true;
+    if(q==VRPH_DEPOT || q==this->dummy_index)
+        return false;
+    if(this->arrival_time[p]!=this->arrival_time[q])
+        return (this->arrival_time[p]<this->arrival_time[q]);
+
+    return this->before(p,q);
+
+}
+
+bool VRP::check_time_windows(VRPMove *M)
+{
+    ///
+    /// Determines whether the move M respects all time windows.  Every move
+    /// replaces at most two pieces of a route by p-(string)-k where k and the
+    /// rest of its route are unchanged, so the check costs O(1) per piece
+    /// plus the length of the string.  When both pieces are in the same route,
+    /// the later one is conservatively delayed by the full push of the earlier.
+    ///
+
+    int i, a, b, c, h, j, k, t, u, v, w, type;
+    int p[2], first[2], last[2], q[2];
+    bool reversed[2], same_route;
+    double push;
+
+    for(i=0;i<M->num_affected_routes;i++)
+    {
+        if(this->route[M->route_nums[i]].times_valid==false)
+            this->update_route_times(M->route_nums[i]);
+    }
 
-            // Now subtract the service time at t as this is included in the distance 
-            // matrix
-            t-=this->nodes[i].service_time;
-            this->nodes[i].arrival_time=t;
+    same_route=false;
+
+    switch(M->move_type)
+    {
+    case PRESERT:
+    case POSTSERT:
+        // u goes in front of (or after) i
+        u=M->move_arguments[0];
+        i=M->move_arguments[1];
+        if(M->move_type==PRESERT)
+        {
+            a=VRPH_MAX(this->pred_array[i],VRPH_DEPOT);
+            b=i;
+        }
+        else
+        {
+            a=i;
+            b=VRPH_MAX(this->next_array[i],VRPH_DEPOT);
+        }
+        if(a==u || b==u)
+            return true;
+        t=VRPH_MAX(this->pred_array[u],VRPH_DEPOT);
+        w=VRPH_MAX(this->next_array[u],VRPH_DEPOT);
+        p[0]=a; first[0]=u; last[0]=u; reversed[0]=false; q[0]=b;
+        p[1]=t; first[1]=-1; last[1]=-1; reversed[1]=false; q[1]=w;
+        same_route=(this->route_num[u]==this->route_num[i]);
+        break;
+
+    case SWAP:
+        u=M->move_arguments[0];
+        i=M->move_arguments[1];
+        t=VRPH_MAX(this->pred_array[u],VRPH_DEPOT);
+        v=VRPH_MAX(this->next_array[u],VRPH_DEPOT);
+        h=VRPH_MAX(this->pred_array[i],VRPH_DEPOT);
+        j=VRPH_MAX(this->next_array[i],VRPH_DEPOT);
+        if(v==i)
+            // t-u-i-j becomes t-i-u-j
+            return this->tw_splice(t,0,i,u,true,j,&push);
+        if(j==u)
+            // h-i-u-v becomes h-u-i-v
+            return this->tw_splice(h,0,u,i,true,v,&push);
+        p[0]=t; first[0]=i; last[0]=i; reversed[0]=false; q[0]=v;
+        p[1]=h; first[1]=u; last[1]=u; reversed[1]=false; q[1]=j;
+        same_route=(this->route_num[u]==this->route_num[i]);
+        break;
+
+    case FLIP:
+        // start-post_start...pre_end-end becomes start-pre_end...post_start-end
+        a=M->move_arguments[0];
+        b=M->move_arguments[1];
+        return this->tw_splice(a,0,this->pred_array[b],this->next_array[a],true,b,&push);
+
+    case SWAP_ENDS:
+        a=M->move_arguments[0];
+        v=M->move_arguments[1];
+        p[0]=a; first[0]=-1; last[0]=-1; reversed[0]=false; q[0]=VRPH_MAX(this->next_array[v],VRPH_DEPOT);
+        p[1]=v; first[1]=-1; last[1]=-1; reversed[1]=false; q[1]=VRPH_MAX(this->next_array[a],VRPH_DEPOT);
+        break;
+
+    case MOVE_STRING:
+        // t-u...v-w and a-b become t-w and a-u...v-b, or a-v...u-b if
+        // a fifth argument is set
+        a=M->move_arguments[0];
+        b=M->move_arguments[1];
+        u=M->move_arguments[2];
+        v=M->move_arguments[3];
+        t=VRPH_MAX(this->pred_array[u],VRPH_DEPOT);
+        w=VRPH_MAX(this->next_array[v],VRPH_DEPOT);
+        if(M->num_arguments>4 && M->move_arguments[4])
+        {
+            p[0]=a; first[0]=v; last[0]=u; reversed[0]=true; q[0]=b;
         }
+        else
+        {
+            if(b==u)
+                return true;
+            p[0]=a; first[0]=u; last[0]=v; reversed[0]=false; q[0]=b;
+        }
+        p[1]=t; first[1]=-1; last[1]=-1; reversed[1]=false; q[1]=w;
+        same_route=(M->num_affected_routes==1);
+        break;
+
+    case CROSS_EXCHANGE:
+        // i1-j2...l1-k2 and j1-i2...k1-l2
+        p[0]=M->move_arguments[0]; first[0]=M->move_arguments[5]; last[0]=M->move_arguments[6];
+        reversed[0]=false; q[0]=M->move_arguments[3];
+        p[1]=M->move_arguments[4]; first[1]=M->move_arguments[1]; last[1]=M->move_arguments[2];
+        reversed[1]=false; q[1]=M->move_arguments[7];
+        break;
+
+    case THREE_POINT_MOVE:
+        // a-b-c and h-i-j-k become a-i-j-c and h-b-k
+        b=M->move_arguments[0];
+        i=M->move_arguments[1];
+        j=M->move_arguments[2];
+        a=VRPH_MAX(this->pred_array[b],VRPH_DEPOT);
+        c=VRPH_MAX(this->next_array[b],VRPH_DEPOT);
+        h=VRPH_MAX(this->pred_array[i],VRPH_DEPOT);
+        k=VRPH_MAX(this->next_array[j],VRPH_DEPOT);
+        if(b==h || b==k)
+        {
+            // a-b-i-j-k becomes a-i-j-b-k and h-i-j-b-c becomes h-b-i-j-c
+            double time;
+            int prev;
+
+            prev= (b==h) ? a : h;
+            time=this->departure_time(prev);
+            if(b==k && this->tw_visit(&time,&prev,b)==false)
+                return false;
+            if(this->tw_visit_string(&time,&prev,i,j,false)==false)
+                return false;
+            if(b==h && this->tw_visit(&time,&prev,b)==false)
+                return false;
+            return this->tw_push(time,prev,(b==h) ? k : c,&push);
+        }
+        p[0]=a; first[0]=i; last[0]=j; reversed[0]=false; q[0]=c;
+        p[1]=h; first[1]=b; last[1]=b; reversed[1]=false; q[1]=k;
+        same_route=(M->num_affected_routes==1);
+        break;
+
+    case THREE_OPT:
+        {
+            // a-b...c-d...e-f with the two middle segments reordered and/or reversed
+            int f;
+            double time;
+            int prev;
+
+            type=M->move_arguments[0];
+            a=M->eval_arguments[0]; b=M->eval_arguments[1]; c=M->eval_arguments[2];
+            h=M->eval_arguments[3]; j=M->eval_arguments[4]; f=M->eval_arguments[5];
+
+            time=this->departure_time(a);
+            prev=a;
+            switch(type)
+            {
+            case 1:
+                if(!this->tw_visit_string(&time,&prev,b,c,false) || !this->tw_visit_string(&time,&prev,j,h,true))
+                    return false;
+                break;
+            case 2:
+                if(!this->tw_visit_string(&time,&prev,c,b,true) || !this->tw_visit_string(&time,&prev,h,j,false))
+                    return false;
+                break;
+            case 3:
+                if(!this->tw_visit_string(&time,&prev,c,b,true) || !this->tw_visit_string(&time,&prev,j,h,true))
+                    return false;
+                break;
+            case 4:
+                if(!this->tw_visit_string(&time,&prev,h,j,false) || !this->tw_visit_string(&time,&prev,b,c,false))
+                    return false;
+                break;
+            case 5:
+                if(!this->tw_visit_string(&time,&prev,h,j,false) || !this->tw_visit_string(&time,&prev,c,b,true))
+                    return false;
+                break;
+            case 6:
+                if(!this->tw_visit_string(&time,&prev,j,h,true) || !this->tw_visit_string(&time,&prev,b,c,false))
+                    return false;
+                break;
+            case 7:
+                if(!this->tw_visit_string(&time,&prev,j,h,true) || !this->tw_visit_string(&time,&prev,c,b,true))
+                    return false;
+                break;
+            }
+            return this->tw_push(time,prev,f,&push);
+        }
+
+    case CONCATENATE:
+        // The end of route j is joined to the start of route i
+        return this->tw_splice(this->route[M->move_arguments[1]].end,0,-1,-1,false,
+            this->route[M->move_arguments[0]].start,&push);
+
+    case SWAP_STAR:
+        // u goes after x in the route of v, and v goes after y in the route of u
+        u=M->move_arguments[0];
+        v=M->move_arguments[2];
+        return this->tw_replace(v,u,M->move_arguments[1]) && 
+            this->tw_replace(u,v,M->move_arguments[3]);
+
+    default:
+        return true;
     }
 
+    return this->tw_splices(p,first,last,reversed,q,same_route);
+
 }
 
-bool VRP::check_tabu_status(VRPMove *M, int *old_sol)
+bool VRP::tw_splices(int *p, int *first, int *last, bool *reversed, int *q, bool same_route)
+{
+    ///
+    /// Checks the two route changes p[i]-first[i]...last[i]-q[i] as in tw_splice().
+    /// When both are in the same route, the later one is conservatively delayed 
+    /// by the full push of the earlier.
+    ///
+
+    int i;
+    double push, delay;
+
+    // Check the earlier change in the route first so that its push can be
+    // passed on to the later one
+    i=0;
+    if(same_route && !this->tw_before(p[0],p[1]))
+        i=1;
+
+    if(this->tw_splice(p[i],0,first[i],last[i],reversed[i],q[i],&push)==false)
+        return false;
+
+    delay=0;
+    if(same_route)
+        delay=VRPH_MAX(0,push);
+
+    i=1-i;
+    return this->tw_splice(p[i],delay,first[i],last[i],reversed[i],q[i],&push);
+
+}
+
+bool VRP::tw_replace(int v, int u, int x)
+{
+    ///
+    /// Checks the route of v when v is removed from it and u is inserted 
+    /// right after x, where x is VRPH_DEPOT for the start of the route.
+    ///
+
+    int t, w, k;
+    int p[2], first[2], last[2], q[2];
+    bool reversed[2];
+    double push;
+
+    t=VRPH_MAX(this->pred_array[v],VRPH_DEPOT);
+    w=VRPH_MAX(this->next_array[v],VRPH_DEPOT);
+
+    if(x==t)
+        // u takes the place of v
+        return this->tw_splice(t,0,u,u,false,w,&push);
+
+    if(x==VRPH_DEPOT)
+        k=this->route[this->route_num[v]].start;
+    else
+        k=VRPH_MAX(this->next_array[x],VRPH_DEPOT);
+
+    p[0]=t; first[0]=-1; last[0]=-1; reversed[0]=false; q[0]=w;
+    p[1]=x; first[1]=u; last[1]=u; reversed[1]=false; q[1]=k;
+    return this->tw_splices(p,first,last,reversed,q,true);
+
+}
+
+bool VRP::tw_insert(int j, int a, int b)
+{
+    ///
+    /// Checks the route a-b when j, which is not routed, is inserted between
+    /// the adjacent nodes a and b.  a is VRPH_DEPOT at the start of a route and
+    /// b is VRPH_DEPOT at the end, and both are VRPH_DEPOT for a new route.
+    ///
+
+    int r;
+    double push;
+
+    r=-1;
+    if(a!=VRPH_DEPOT)
+        r=this->route_num[a];
+    else if(b!=VRPH_DEPOT)
+        r=this->route_num[b];
+    if(r!=-1 && this->route[r].times_valid==false)
+        this->update_route_times(r);
+
+    return this->tw_splice(a,0,j,j,false,b,&push);
+
+}
+
+bool VRP::check_tabu_status(VRPMove *M)
 {
     ///
     /// The tabu search rules is entirely route-based.  We hash
     /// each of the affected routes and see if the values are in the
-    /// tabu list.  If the move is tabu, then we revert back to the old solution
+    /// tabu list.  If the move is tabu, then we undo the journaled changes
     /// and return false.  Otherwise, we allow the move and return true.
     /// When the move is allowed, we update the tabu list using a circular buffer.
     ///
@@ -4321,7 +5596,7 @@ bool VRP::check_tabu_status(VRPMove *M, int *old_sol)
 #endif
 
 
-    int i,j;
+    int i;
 
     // We will always accept a move that reduces the # of routes
     if(M->num_affected_routes>1)
@@ -4333,7 +5608,7 @@ bool VRP::check_tabu_status(VRPMove *M, int *old_sol)
         }
     }    
     
-    VRPRoute r(this->num_nodes);
+    VRPHash h[MAX_AFFECTED_ROUTES];
     int num_tabu_routes=0;
 
 #if VRPH_TABU_DEBUG
@@ -4342,16 +5617,11 @@ bool VRP::check_tabu_status(VRPMove *M, int *old_sol)
 
     for(i=0;i<M->num_affected_routes;i++)
     {
-        this->update_route(M->route_nums[i],&r);
-        r.hash_val = r.hash(SALT_1);
-        r.hash_val2 = r.hash(SALT_2);    
+        h[i]=this->hash_route(M->route_nums[i]);
         
-        for(j=0;j<this->tabu_list->num_entries;j++)
-        {
-            if(r.hash_val==this->tabu_list->hash_vals1[j] && r.hash_val2==this->tabu_list->hash_vals2[j])
-                // The move is tabu!
-                num_tabu_routes++;            
-        }
+        if(this->tabu_list->contains(h[i]))
+            // The move is tabu!
+            num_tabu_routes++;            
         
     }
     
@@ -4359,7 +5629,7 @@ bool VRP::check_tabu_status(VRPMove *M, int *old_sol)
     if(num_tabu_routes>0)
     {
         // At least one tabu route
-        this->import_solution_buff(old_sol);
+        this->undo_journal();
 #if VRPH_TABU_DEBUG
                 printf("Move is Tabu! Reverting to old solution\n");
 #endif
@@ -4372,13 +5642,134 @@ bool VRP::check_tabu_status(VRPMove *M, int *old_sol)
 
     // The move is not tabu - update the tabu list 
     for(i=0;i<M->num_affected_routes;i++)
-    {    
-        this->update_route(M->route_nums[i],&r);
+        this->tabu_list->update_list(h[i]);
+
+    return true;
+
+}
+
+void VRP::start_journal()
+{
+    ///
+    /// Starts recording the changes made to the current solution so that
+    /// they can later be reverted by undo_journal().  Until stop_journal()
+    /// is called, the pre-image of each node and route is saved just before
+    /// it is first modified.
+    ///
+
+    this->journal->reset();
+    this->journal->total_route_length=this->total_route_length;
+    this->journal->total_number_of_routes=this->total_number_of_routes;
+    this->journal->num_vrp_nodes=this->num_nodes;
+    this->journal->num_free_routes=this->num_free_routes;
+    this->journal->solution_hash=this->solution_hash;
+    this->journal_on=true;
+
+#if JOURNAL_VERIFY
+    this->export_solution_buff(this->journal_sol);
+#endif
 
-        this->tabu_list->update_list(&r);
+}
+
+void VRP::stop_journal()
+{
+    ///
+    /// Stops recording changes.  Safe to call when no journal is active.
+    ///
+
+    this->journal_on=false;
+
+}
+
+void VRP::journal_node(int j)
+{
+    ///
+    /// Saves the pre-image of node j if it is not yet in the journal.
+    ///
+
+    int m;
+
+    if(!this->journal_on || !this->journal->add_node(j))
+        return;
+
+    m=this->journal->num_nodes-1;
+    this->journal->next[m]=this->next_array[j];
+    this->journal->pred[m]=this->pred_array[j];
+    this->journal->route_num[m]=this->route_num[j];
+    this->journal->routed[m]=this->routed[j];
+
+}
+
+void VRP::journal_route_info(int r)
+{
+    ///
+    /// Saves the fields of route r if they are not yet in the journal.
+    ///
+
+    int m;
+
+    if(!this->journal_on || !this->journal->add_route(r))
+        return;
+
+    m=this->journal->num_routes-1;
+    this->journal->start[m]=this->route[r].start;
+    this->journal->end[m]=this->route[r].end;
+    this->journal->load[m]=this->route[r].load;
+    this->journal->num_customers[m]=this->route[r].num_customers;
+    this->journal->length[m]=this->route[r].length;
+
+}
+
+void VRP::undo_journal()
+{
+    ///
+    /// Reverts the current solution to its state when the journal was
+    /// started, restoring only the nodes and routes that were modified.
+    /// The journal remains active and empty afterwards.
+    ///
+
+    int i,j,r;
+
+    for(i=0;i<this->journal->num_nodes;i++)
+    {
+        j=this->journal->node[i];
+        this->next_array[j]=this->journal->next[i];
+        this->pred_array[j]=this->journal->pred[i];
+        this->route_num[j]=this->journal->route_num[i];
+        this->routed[j]=this->journal->routed[i];
     }
 
-    return true;
+    for(i=0;i<this->journal->num_routes;i++)
+    {
+        r=this->journal->r[i];
+        this->route[r].start=this->journal->start[i];
+        this->route[r].end=this->journal->end[i];
+        this->route[r].load=this->journal->load[i];
+        this->route[r].num_customers=this->journal->num_customers[i];
+        this->route[r].length=this->journal->length[i];
+        this->route_changed(r);
+    }
+
+    this->total_route_length=this->journal->total_route_length;
+    this->total_number_of_routes=this->journal->total_number_of_routes;
+    this->num_nodes=this->journal->num_vrp_nodes;
+    this->num_free_routes=this->journal->num_free_routes;
+    this->solution_hash=this->journal->solution_hash;
+
+    this->journal->reset();
+
+#if JOURNAL_VERIFY
+    VRPIndex *sol=new VRPIndex[this->num_original_nodes+2];
+    this->export_solution_buff(sol);
+    for(i=0;i<=this->num_nodes+1;i++)
+    {
+        if(sol[i]!=this->journal_sol[i])
+            report_error("%s: solution differs from the journaled one at position %d\n",
+            __FUNCTION__,i);
+    }
+    delete [] sol;
+    this->verify_routes("undo_journal\n");
+#endif
 
 }
 
@@ -4403,8 +5794,12 @@ void VRP::print_stats()
         this->num_moves[THREE_OPT_INDEX], this->num_evaluations[THREE_OPT_INDEX]);
     printf("        Or-opt Move:   (%010d, %010d)\n",
         this->num_moves[OR_OPT_INDEX], this->num_evaluations[OR_OPT_INDEX]);
-    printf("Cross-Exchange Move:   (%010d, %010d)\n\n",
+    printf("Cross-Exchange Move:   (%010d, %010d)\n",
         this->num_moves[CROSS_EXCHANGE_INDEX], this->num_evaluations[CROSS_EXCHANGE_INDEX]);
+    printf("         Swap* Move:   (%010d, %010d)\n",
+        this->num_moves[SWAP_STAR_INDEX], this->num_evaluations[SWAP_STAR_INDEX]);
+    printf("          Held-Karp:   (%010d, %010d)\n\n",
+        this->num_moves[HELD_KARP_INDEX], this->num_evaluations[HELD_KARP_INDEX]);
 
     return;
 
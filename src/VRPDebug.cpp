@@ -92,6 +92,14 @@ bool VRP::verify_routes(const char *message)
         report_error("%s: Next/pred inconsistency\n",__FUNCTION__);
     }
 
+    // Make sure the moves kept the solution_hash current
+    if(this->solution_hash!=this->hash_solution())
+    {
+        fprintf(stderr,"Solution hash error: calculated(%llx)!=claimed(%llx)\n",
+            this->hash_solution(),this->solution_hash);
+        report_error(message);
+    }
+
     n=num_nodes;
     // Only consider the nodes in the solution!
 
@@ -117,6 +125,12 @@ bool VRP::verify_routes(const char *message)
         fprintf(stderr,"Error in initial route start:  %d != %d\n",route_start, current_start);
         report_error(message,__FUNCTION__);
     }
+
+    if(current_route<1 || current_route>total_number_of_routes)
+    {
+        fprintf(stderr,"Route number %d not in [1,%d]\n",current_route, total_number_of_routes);
+        report_error(message,__FUNCTION__);
+    }
         
     
 
@@ -275,6 +289,13 @@ bool VRP::verify_routes(const char *message)
                 report_error(message);
             }
 
+            // Route numbers must be 1,2,...,R
+            if(current_route<1 || current_route>total_number_of_routes)
+            {
+                fprintf(stderr,"Route number %d not in [1,%d]\n",current_route, total_number_of_routes);
+                report_error(message);
+            }
+
             current_node = route_start;
             total_load+=nodes[current_node].demand;
             // reset current_load to 0
@@ -163,7 +163,6 @@ bool VRP::plot(const char *filename, int options, int orientation)
 
     int R;
 
-    normalize_route_numbers();
     R= count_num_routes();
 
     for(i=1;i<=R;i++)
@@ -355,6 +355,8 @@ void VRP::read_TSPLIB_file(const char *node_file)
                 fprintf(stderr,"Creating neighbor lists...\n");
 #endif
 
+            this->update_node_arrays();
+
             // Create the neighbor_lists-we may use a smaller size depending on the parameter
             // but we will construct the largest possible here...
             this->create_neighbor_lists(VRPH_MIN(MAX_NEIGHBORLIST_SIZE,num_nodes));
@@ -744,6 +746,10 @@ void VRP::read_TSPLIB_file(const char *node_file)
                 nodes[i].end_tw=b;
                 i++;
             }
+            // The dummy node shares the depot's time window
+            nodes[num_nodes+1].start_tw=nodes[0].start_tw;
+            nodes[num_nodes+1].end_tw=nodes[0].end_tw;
+            has_time_windows=true;
 
             break;
         case 20:
@@ -865,7 +871,7 @@ void VRP::write_solution_file(const char *filename)
     int n, current;
     FILE *out;
 
-    int *sol;
+    VRPIndex *sol;
 
     // Open the file
     if( (out = fopen(filename,"w"))==NULL)
@@ -885,7 +891,7 @@ void VRP::write_solution_file(const char *filename)
         n++;
     }
     // We have n non-VRPH_DEPOT nodes in the problem
-    sol=new int[n+2];
+    sol=new VRPIndex[n+2];
     // Canonicalize
     this->export_canonical_solution_buff(sol);
     this->import_solution_buff(sol);
@@ -925,9 +931,9 @@ void VRP::write_solutions(int num_sols, const char *filename)
 
     int i,n, current;
     FILE *out;
-    int *sol;
+    VRPIndex *sol;
 
-    sol=new int[this->num_original_nodes+2]; // should be big enough
+    sol=new VRPIndex[this->num_original_nodes+2]; // should be big enough
 
     // Open the file
     if( (out = fopen(filename,"w"))==NULL)
@@ -1066,13 +1072,16 @@ void VRP::read_solution_file(const char *filename)
         report_error("%s\n",__FUNCTION__);
     }
 
-    int *new_sol;
-    int i,n;
+    VRPIndex *new_sol;
+    int i,n,x;
     fscanf(in,"%d",&n);
-    new_sol=new int[n+2];
+    new_sol=new VRPIndex[n+2];
     new_sol[0]=n;
     for(i=1;i<=n+1;i++)
-        fscanf(in,"%d",new_sol+i);
+    {
+        fscanf(in,"%d",&x);
+        new_sol[i]=x;
+    }
     
     // Import the buffer
     this->import_solution_buff(new_sol);
@@ -1081,7 +1090,7 @@ void VRP::read_solution_file(const char *filename)
 
     this->verify_routes("After read_solution_file\n");
 
-    memcpy(this->best_sol_buff,this->current_sol_buff,(this->num_nodes+2)*sizeof(int));
+    memcpy(this->best_sol_buff,this->current_sol_buff,(this->num_nodes+2)*sizeof(VRPIndex));
 
     return;
 
@@ -1089,7 +1098,7 @@ void VRP::read_solution_file(const char *filename)
 
 
 
-void VRP::import_solution_buff(int *sol_buff)
+void VRP::import_solution_buff(VRPIndex *sol_buff)
 {
     ///
     /// Imports a solution from buffer produced by something like
@@ -1191,7 +1200,11 @@ void VRP::import_solution_buff(int *sol_buff)
     route[rnum].num_customers=num_in_route;
     total_route_length+=len;
     total_number_of_routes=rnum;
+    num_free_routes=0;
+    for(i=1;i<=rnum;i++)
+        route_changed(i);
     create_pred_array();
+    solution_hash=hash_solution();
 
     // Make sure everything imported successfully!
     verify_routes("After import sol_buff\n");
@@ -1204,12 +1217,12 @@ void VRP::import_solution_buff(int *sol_buff)
 
     route_num[VRPH_DEPOT]=0;
 
-    memcpy(this->current_sol_buff,sol_buff,(this->num_nodes+2)*sizeof(int));
+    memcpy(this->current_sol_buff,sol_buff,(this->num_nodes+2)*sizeof(VRPIndex));
 
     return;
 
 }
-void VRP::export_solution_buff(int *sol_buff)
+void VRP::export_solution_buff(VRPIndex *sol_buff)
 {
     ///
     /// Exports the solution to sol_buff.
@@ -1234,11 +1247,12 @@ void VRP::export_solution_buff(int *sol_buff)
     return;
 }
 
-void VRP::export_canonical_solution_buff(int *sol_buff)
+void VRP::export_canonical_solution_buff(VRPIndex *sol_buff)
 {
     ///
     /// Puts the solution into the buffer in a "canonical form".
-    /// The orientation of each route is such that start<end.
+    /// The orientation of each route is such that start<end, unless
+    /// there are time windows, in which case the orientation matters.
     /// Also, the ordering of the different routes is determined
     /// so that route i precedes route j in the ordering if
     /// start_i < start_j.
@@ -1249,12 +1263,11 @@ void VRP::export_canonical_solution_buff(int *sol_buff)
 
     start_buff=new int[total_number_of_routes];
     
-    this->normalize_route_numbers();
 
     // First orient each route properly
     for(i=1;i<=total_number_of_routes;i++)
     {
-        if(route[i].end<route[i].start)
+        if(route[i].end<route[i].start && !has_time_windows)
             reverse_route(i);
 
         start_buff[i-1]=route[i].start;
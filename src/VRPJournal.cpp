@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////
+//                                                        //
+// This file is part of the VRPH software package for     //
+// generating solutions to vehicle routing problems.      //
+// VRPH was developed by Chris Groer (cgroer@gmail.com).  //
+//                                                        //
+// (c) Copyright 2010 Chris Groer.                        //
+// All Rights Reserved.  VRPH is licensed under the       //
+// Common Public License.  See LICENSE file for details.  //
+//                                                        //
+////////////////////////////////////////////////////////////
+
+#include "VRPH.h"
+
+VRPJournal::VRPJournal()
+{
+    ///
+    /// Default constructor for the VRPJournal.
+    ///
+
+    this->max_size=0;
+    this->num_nodes=0;
+    this->num_routes=0;
+    this->current_stamp=0;
+
+    this->node=NULL;
+    this->next=NULL;
+    this->pred=NULL;
+    this->route_num=NULL;
+    this->routed=NULL;
+    this->r=NULL;
+    this->start=NULL;
+    this->end=NULL;
+    this->load=NULL;
+    this->num_customers=NULL;
+    this->length=NULL;
+    this->node_stamp=NULL;
+    this->route_stamp=NULL;
+
+}
+
+VRPJournal::VRPJournal(int n)
+{
+    ///
+    /// Constructor for a journal large enough for an n node problem,
+    /// including the VRPH_DEPOT and the dummy node.
+    ///
+
+    int i;
+
+    this->max_size=n+2;
+    this->num_nodes=0;
+    this->num_routes=0;
+    this->current_stamp=1;
+
+    this->node=new VRPIndex[n+2];
+    this->next=new VRPIndex[n+2];
+    this->pred=new VRPIndex[n+2];
+    this->route_num=new VRPIndex[n+2];
+    this->routed=new bool[n+2];
+    this->r=new int[n+2];
+    this->start=new int[n+2];
+    this->end=new int[n+2];
+    this->load=new int[n+2];
+    this->num_customers=new int[n+2];
+    this->length=new double[n+2];
+    this->node_stamp=new int[n+2];
+    this->route_stamp=new int[n+2];
+
+    for(i=0;i<n+2;i++)
+    {
+        this->node_stamp[i]=0;
+        this->route_stamp[i]=0;
+    }
+
+}
+
+VRPJournal::~VRPJournal()
+{
+    ///
+    /// Destructor for the VRPJournal.
+    ///
+
+    if(this->node)
+        delete [] this->node;
+    if(this->next)
+        delete [] this->next;
+    if(this->pred)
+        delete [] this->pred;
+    if(this->route_num)
+        delete [] this->route_num;
+    if(this->routed)
+        delete [] this->routed;
+    if(this->r)
+        delete [] this->r;
+    if(this->start)
+        delete [] this->start;
+    if(this->end)
+        delete [] this->end;
+    if(this->load)
+        delete [] this->load;
+    if(this->num_customers)
+        delete [] this->num_customers;
+    if(this->length)
+        delete [] this->length;
+    if(this->node_stamp)
+        delete [] this->node_stamp;
+    if(this->route_stamp)
+        delete [] this->route_stamp;
+
+}
+
+void VRPJournal::reset()
+{
+    ///
+    /// Empties the journal in constant time.
+    ///
+
+    int i;
+
+    this->num_nodes=0;
+    this->num_routes=0;
+    this->current_stamp++;
+
+    if(this->current_stamp==VRP_INFINITY)
+    {
+        // Wrap around - clear the stamps
+        for(i=0;i<this->max_size;i++)
+        {
+            this->node_stamp[i]=0;
+            this->route_stamp[i]=0;
+        }
+        this->current_stamp=1;
+    }
+
+}
+
+bool VRPJournal::add_node(int j)
+{
+    ///
+    /// Reserves a record for node j.  Returns true if j has not been
+    /// recorded since the last reset, in which case the caller must fill
+    /// in the record at index num_nodes-1.
+    ///
+
+    if(this->node_stamp[j]==this->current_stamp)
+        return false;
+
+    this->node_stamp[j]=this->current_stamp;
+    this->node[this->num_nodes]=j;
+    this->num_nodes++;
+
+    return true;
+
+}
+
+bool VRPJournal::add_route(int r)
+{
+    ///
+    /// Reserves a record for route r.  Returns true if r has not been
+    /// recorded since the last reset, in which case the caller must fill
+    /// in the record at index num_routes-1.
+    ///
+
+    if(this->route_stamp[r]==this->current_stamp)
+        return false;
+
+    this->route_stamp[r]=this->current_stamp;
+    this->r[this->num_routes]=r;
+    this->num_routes++;
+
+    return true;
+
+}
+
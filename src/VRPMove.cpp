@@ -46,15 +46,17 @@ VRPMove::~VRPMove()
 }
 
 
-bool VRPMove::is_better(VRP *V, VRPMove *M2, int rules)
+static bool is_better_move(double savings, int total_number_of_routes, int num_affected_routes,
+                           const int *route_custs, double savings2, int total_number_of_routes2,
+                           int num_affected_routes2, const int *route_custs2, int rules)
 {
     ///
-    /// Evaluates this move versus M2 in terms of the provided
-    /// rules.  Returns true of this move is superior to M2
-    /// and false otherwise.  
-    /// 
+    /// Compares two moves given by their savings, resulting number of routes and
+    /// customers on the affected routes.  Returns true if the first move is
+    /// superior to the second in terms of the provided rules.
+    ///
 
-    if(M2->num_affected_routes==-1)
+    if(num_affected_routes2==-1)
     {
         // M2 does not have meaningful information, so return true
         // Probably has savings=VRP_INFINITY
@@ -68,7 +70,7 @@ bool VRPMove::is_better(VRP *V, VRPMove *M2, int rules)
     {
         // Decide in terms of total length only
 
-        if(this->savings <= M2->savings)
+        if(savings <= savings2)
             return true;
         else
             return false;
@@ -80,17 +82,17 @@ bool VRPMove::is_better(VRP *V, VRPMove *M2, int rules)
     if(rules & VRPH_MINIMIZE_NUM_ROUTES)
     {
         // First check the # of routes in the solution produced by the two moves
-        if(this->total_number_of_routes<M2->total_number_of_routes)
+        if(total_number_of_routes<total_number_of_routes2)
             return true;
 
-        if(this->total_number_of_routes>M2->total_number_of_routes)
+        if(total_number_of_routes>total_number_of_routes2)
             return false;
 
         // Otherwise the # of routes remains the same
         // If the two moves affect diff. #'s of routes, then just use the total length
-        if(this->num_affected_routes != M2->num_affected_routes)
+        if(num_affected_routes != num_affected_routes2)
         {
-            if(this->savings < M2->savings)
+            if(savings < savings2)
                 return true;
             else
                 return false;    
@@ -102,11 +104,11 @@ bool VRPMove::is_better(VRP *V, VRPMove *M2, int rules)
         int i,sq, sq2;
 
         sq=0; sq2=0;
-        for(i=0;i<this->num_affected_routes;i++)
-            sq+= (this->route_custs[i])*(this->route_custs[i]);
+        for(i=0;i<num_affected_routes;i++)
+            sq+= (route_custs[i])*(route_custs[i]);
 
-        for(i=0;i<M2->num_affected_routes;i++)
-            sq2+= (M2->route_custs[i])*(M2->route_custs[i]);
+        for(i=0;i<num_affected_routes2;i++)
+            sq2+= (route_custs2[i])*(route_custs2[i]);
 
         if(sq>sq2)
             // this move is better
@@ -117,7 +119,7 @@ bool VRPMove::is_better(VRP *V, VRPMove *M2, int rules)
 
         // Otherwise, sq==sq2, use the savings
 
-        if(this->savings <= M2->savings)
+        if(savings <= savings2)
             return true;
         else
             return false;    
@@ -130,3 +132,94 @@ bool VRPMove::is_better(VRP *V, VRPMove *M2, int rules)
 
 }
 
+bool VRPMove::is_better(VRP *V, VRPMove *M2, int rules)
+{
+    ///
+    /// Evaluates this move versus M2 in terms of the provided
+    /// rules.  Returns true of this move is superior to M2
+    /// and false otherwise.  
+    /// 
+
+    return is_better_move(this->savings, this->total_number_of_routes,
+        this->num_affected_routes, this->route_custs, M2->savings,
+        M2->total_number_of_routes, M2->num_affected_routes, M2->route_custs, rules);
+
+}
+
+bool VRPMove::is_better(VRP *V, VRPCompactMove *M2, int rules)
+{
+    ///
+    /// Evaluates this move versus the compact move M2 in terms of the
+    /// provided rules.  Returns true of this move is superior to M2
+    /// and false otherwise.  
+    /// 
+
+    return is_better_move(this->savings, this->total_number_of_routes,
+        this->num_affected_routes, this->route_custs, M2->savings,
+        M2->total_number_of_routes, M2->num_affected_routes, M2->route_custs, rules);
+
+}
+
+VRPCompactMove::VRPCompactMove()
+{
+    this->savings=VRP_INFINITY;
+    this->move_type=-1;
+    this->total_number_of_routes=-1;
+    this->num_affected_routes=-1;
+    this->num_arguments=0;
+
+}
+
+VRPCompactMove& VRPCompactMove::operator=(const VRPMove &M)
+{
+    ///
+    /// Stores the parts of M needed to compare and make the move.
+    ///
+
+    int i;
+
+    if(M.num_arguments>MAX_COMPACT_ARGUMENTS)
+        report_error("%s: move has too many arguments\n",__FUNCTION__);
+
+    this->savings=M.savings;
+    this->move_type=M.move_type;
+    this->total_number_of_routes=M.total_number_of_routes;
+    this->num_affected_routes=M.num_affected_routes;
+    for(i=0;i<M.num_affected_routes;i++)
+    {
+        this->route_nums[i]=M.route_nums[i];
+        this->route_custs[i]=M.route_custs[i];
+    }
+    this->num_arguments=M.num_arguments;
+    for(i=0;i<M.num_arguments;i++)
+        this->move_arguments[i]=M.move_arguments[i];
+
+    return *this;
+
+}
+
+void VRPCompactMove::expand(VRPMove *M)
+{
+    ///
+    /// Fills in M so that it can be passed to the move() function of the
+    /// operator and to VRP::check_tabu_status.  The route lengths and loads
+    /// are not stored and are left unset.
+    ///
+
+    int i;
+
+    M->savings=this->savings;
+    M->move_type=this->move_type;
+    M->total_number_of_routes=this->total_number_of_routes;
+    M->num_affected_routes=this->num_affected_routes;
+    for(i=0;i<this->num_affected_routes;i++)
+    {
+        M->route_nums[i]=this->route_nums[i];
+        M->route_custs[i]=this->route_custs[i];
+    }
+    M->num_arguments=this->num_arguments;
+    for(i=0;i<this->num_arguments;i++)
+        M->move_arguments[i]=this->move_arguments[i];
+    M->new_total_route_length=VRP_INFINITY;
+
+}
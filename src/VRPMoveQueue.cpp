@@ -0,0 +1,399 @@
+////////////////////////////////////////////////////////////
+//                                                        //
+// This file is part of the VRPH software package for     //
+// generating solutions to vehicle routing problems.      //
+// VRPH was developed by Chris Groer (cgroer@gmail.com).  //
+//                                                        //
+// (c) Copyright 2010 Chris Groer.                        //
+// All Rights Reserved.  VRPH is licensed under the       //
+// Common Public License.  See LICENSE file for details.  //
+//                                                        //
+////////////////////////////////////////////////////////////
+
+#include "VRPH.h"
+
+VRPMoveQueue::VRPMoveQueue()
+{
+    ///
+    /// Default constructor for the VRPMoveQueue.
+    ///
+
+    this->max_size=0;
+    this->heap_size=0;
+    this->num_dirty=0;
+    this->num_depot_nbrs=0;
+
+    this->heap=NULL;
+    this->heap_pos=NULL;
+    this->savings=NULL;
+    this->dirty=NULL;
+    this->is_dirty=NULL;
+    this->rev_start=NULL;
+    this->rev_list=NULL;
+    this->depot_nbrs=NULL;
+
+}
+
+VRPMoveQueue::VRPMoveQueue(int n)
+{
+    ///
+    /// Constructor for a queue of move descriptors for an n node problem.
+    ///
+
+    int i;
+
+    this->max_size=n+2;
+    this->heap_size=0;
+    this->num_dirty=0;
+    this->num_depot_nbrs=0;
+
+    this->heap=new int[n+2];
+    this->heap_pos=new int[n+2];
+    this->savings=new double[n+2];
+    this->dirty=new int[n+2];
+    this->is_dirty=new bool[n+2];
+    this->rev_start=new int[n+3];
+    this->rev_list=new int[(n+2)*MAX_NEIGHBORLIST_SIZE];
+    this->depot_nbrs=new int[n+2];
+
+    for(i=0;i<n+2;i++)
+    {
+        this->heap_pos[i]=-1;
+        this->is_dirty[i]=false;
+    }
+
+}
+
+VRPMoveQueue::~VRPMoveQueue()
+{
+    ///
+    /// Destructor for the VRPMoveQueue.
+    ///
+
+    if(this->heap)
+        delete [] this->heap;
+    if(this->heap_pos)
+        delete [] this->heap_pos;
+    if(this->savings)
+        delete [] this->savings;
+    if(this->dirty)
+        delete [] this->dirty;
+    if(this->is_dirty)
+        delete [] this->is_dirty;
+    if(this->rev_start)
+        delete [] this->rev_start;
+    if(this->rev_list)
+        delete [] this->rev_list;
+    if(this->depot_nbrs)
+        delete [] this->depot_nbrs;
+
+}
+
+int VRPMoveQueue::search(class VRP *V, int heuristic, int rules)
+{
+    ///
+    /// Runs a best-improvement search with the given heuristic (ONE_POINT_MOVE,
+    /// TWO_POINT_MOVE or TWO_OPT), always making the best move available
+    /// over all nodes, until no improving move remains.  The rules must
+    /// include VRPH_BEST_ACCEPT and VRPH_USE_NEIGHBOR_LIST.  Returns the
+    /// number of moves made.
+    ///
+
+    int i,j,k,r,current,clock,num_moves;
+
+    if(!(rules & VRPH_USE_NEIGHBOR_LIST) || !(rules & VRPH_BEST_ACCEPT))
+        report_error("%s: rules must include VRPH_BEST_ACCEPT and VRPH_USE_NEIGHBOR_LIST\n",
+            __FUNCTION__);
+
+    if(V->num_original_nodes+2>this->max_size)
+        report_error("%s: queue is too small\n",__FUNCTION__);
+
+    this->build_reverse_lists(V);
+
+    // Compute every descriptor
+    for(j=1;j<=V->num_original_nodes;j++)
+    {
+        if(V->routed[j] && this->evaluate(V,j,heuristic,rules))
+            this->set_key(j,V->best_savings);
+        else
+            this->remove(j);
+    }
+
+    num_moves=0;
+    while(this->heap_size>0)
+    {
+        j=this->heap[0];
+        clock=V->route_clock;
+
+        if(this->make_move(V,j,heuristic,rules)==false)
+        {
+            // Should not happen since nothing the descriptor depends on
+            // has changed - drop it
+            this->remove(j);
+            continue;
+        }
+        num_moves++;
+
+        // Every node on a changed route and every node with a neighbor
+        // on one may now have a different best move
+        for(r=1;r<=V->total_number_of_routes;r++)
+        {
+            if(V->route[r].version<=clock)
+                continue;
+
+            current=V->route[r].start;
+            while(current>0)
+            {
+                this->mark_dirty(current);
+                for(i=this->rev_start[current];i<this->rev_start[current+1];i++)
+                    this->mark_dirty(this->rev_list[i]);
+                current=V->next_array[current];
+            }
+        }
+        // A VRPH_DEPOT neighbor brings the ends of every route into the search
+        for(i=0;i<this->num_depot_nbrs;i++)
+            this->mark_dirty(this->depot_nbrs[i]);
+
+        for(i=0;i<this->num_dirty;i++)
+        {
+            k=this->dirty[i];
+            this->is_dirty[k]=false;
+            if(this->evaluate(V,k,heuristic,rules))
+                this->set_key(k,V->best_savings);
+            else
+                this->remove(k);
+        }
+        this->num_dirty=0;
+    }
+
+    return num_moves;
+
+}
+
+void VRPMoveQueue::build_reverse_lists(class VRP *V)
+{
+    ///
+    /// Inverts the neighbor lists of V so that the nodes having a given
+    /// node as a neighbor can be found directly.
+    ///
+
+    int i,j,k,n;
+
+    n=V->num_original_nodes;
+
+    for(k=0;k<=n+2;k++)
+        this->rev_start[k]=0;
+    this->num_depot_nbrs=0;
+
+    // Count the entries for each node, offset by one
+    for(j=1;j<=n;j++)
+    {
+        for(i=0;i<V->neighbor_list_size;i++)
+        {
+            k=V->nodes[j].neighbor_list[i].position;
+            if(k==VRPH_DEPOT)
+                this->depot_nbrs[this->num_depot_nbrs++]=j;
+            else
+                this->rev_start[k+1]++;
+        }
+    }
+
+    for(k=1;k<=n+2;k++)
+        this->rev_start[k]+=this->rev_start[k-1];
+
+    // Fill the lists, using rev_start[k] as the insertion point for k
+    for(j=1;j<=n;j++)
+    {
+        for(i=0;i<V->neighbor_list_size;i++)
+        {
+            k=V->nodes[j].neighbor_list[i].position;
+            if(k!=VRPH_DEPOT)
+                this->rev_list[this->rev_start[k]++]=j;
+        }
+    }
+
+    // Shift the starts back
+    for(k=n+1;k>0;k--)
+        this->rev_start[k]=this->rev_start[k-1];
+    this->rev_start[0]=0;
+
+}
+
+bool VRPMoveQueue::evaluate(class VRP *V, int j, int heuristic, int rules)
+{
+    ///
+    /// Finds the best move for node j without making it, leaving its savings
+    /// in V->best_savings.  Returns false if there is no acceptable move.
+    ///
+
+    OnePointMove OPM;
+    TwoPointMove TPM;
+    TwoOpt TO;
+
+    rules|=VRPH_EVALUATE_ONLY;
+
+    switch(heuristic)
+    {
+    case ONE_POINT_MOVE:
+        return OPM.search(V,j,rules);
+    case TWO_POINT_MOVE:
+        return TPM.search(V,j,rules);
+    case TWO_OPT:
+        return TO.search(V,j,rules);
+    }
+
+    report_error("%s: unsupported heuristic\n",__FUNCTION__);
+    return false;
+
+}
+
+bool VRPMoveQueue::make_move(class VRP *V, int j, int heuristic, int rules)
+{
+    ///
+    /// Makes the best move for node j.
+    ///
+
+    OnePointMove OPM;
+    TwoPointMove TPM;
+    TwoOpt TO;
+
+    switch(heuristic)
+    {
+    case ONE_POINT_MOVE:
+        return OPM.search(V,j,rules);
+    case TWO_POINT_MOVE:
+        return TPM.search(V,j,rules);
+    case TWO_OPT:
+        return TO.search(V,j,rules);
+    }
+
+    report_error("%s: unsupported heuristic\n",__FUNCTION__);
+    return false;
+
+}
+
+void VRPMoveQueue::mark_dirty(int j)
+{
+    ///
+    /// Adds node j to the list of descriptors to recompute.
+    ///
+
+    if(this->is_dirty[j])
+        return;
+
+    this->is_dirty[j]=true;
+    this->dirty[this->num_dirty++]=j;
+
+}
+
+void VRPMoveQueue::set_key(int j, double s)
+{
+    ///
+    /// Sets the savings of node j to s, adding j to the heap if necessary.
+    ///
+
+    int p;
+
+    if(this->heap_pos[j]==-1)
+    {
+        p=this->heap_size++;
+        this->heap[p]=j;
+        this->heap_pos[j]=p;
+        this->savings[j]=s;
+        this->sift_up(p);
+        return;
+    }
+
+    p=this->heap_pos[j];
+    if(s<this->savings[j])
+    {
+        this->savings[j]=s;
+        this->sift_up(p);
+    }
+    else
+    {
+        this->savings[j]=s;
+        this->sift_down(p);
+    }
+
+}
+
+void VRPMoveQueue::remove(int j)
+{
+    ///
+    /// Removes node j from the heap if it is there.
+    ///
+
+    int p,last;
+
+    p=this->heap_pos[j];
+    if(p==-1)
+        return;
+
+    this->heap_pos[j]=-1;
+    this->heap_size--;
+    if(p==this->heap_size)
+        return;
+
+    // Move the last element into the hole
+    last=this->heap[this->heap_size];
+    this->heap[p]=last;
+    this->heap_pos[last]=p;
+    this->sift_up(p);
+    this->sift_down(this->heap_pos[last]);
+
+}
+
+// Ties are broken by node number so that the search is repeatable
+#define VRPH_MQ_LESS(a,b)   (savings[a]<savings[b] || (savings[a]==savings[b] && (a)<(b)))
+
+void VRPMoveQueue::sift_up(int p)
+{
+    ///
+    /// Restores the heap order above position p.
+    ///
+
+    int j,q;
+
+    j=this->heap[p];
+    while(p>0)
+    {
+        q=(p-1)/2;
+        if(!VRPH_MQ_LESS(j,this->heap[q]))
+            break;
+        this->heap[p]=this->heap[q];
+        this->heap_pos[this->heap[p]]=p;
+        p=q;
+    }
+    this->heap[p]=j;
+    this->heap_pos[j]=p;
+
+}
+
+void VRPMoveQueue::sift_down(int p)
+{
+    ///
+    /// Restores the heap order below position p.
+    ///
+
+    int j,c;
+
+    j=this->heap[p];
+    for(;;)
+    {
+        c=2*p+1;
+        if(c>=this->heap_size)
+            break;
+        if(c+1<this->heap_size && VRPH_MQ_LESS(this->heap[c+1],this->heap[c]))
+            c++;
+        if(!VRPH_MQ_LESS(this->heap[c],j))
+            break;
+        this->heap[p]=this->heap[c];
+        this->heap_pos[this->heap[p]]=p;
+        p=c;
+    }
+    this->heap[p]=j;
+    this->heap_pos[j]=p;
+
+}
+
@@ -24,6 +24,8 @@ VRPRoute::VRPRoute()
     this->ordering=NULL;
     this->x=NULL;
     this->y=NULL;
+    this->times_valid=false;
+    this->version=0;
 
 }
 
@@ -38,6 +40,8 @@ VRPRoute::VRPRoute(int n)
     this->ordering=new int[n];
     this->x=new double[n];
     this->y=new double[n];
+    this->times_valid=false;
+    this->version=0;
 
 }
 
@@ -38,7 +38,7 @@ VRPSolutionWarehouse::VRPSolutionWarehouse(int max_sols, int n)
     // This calls the default constructor so we have to allocate the memory for
     // the sol buffer still... 
     for(int i=0;i<this->max_size;i++)
-        this->sols[i].sol=new int[n+2];
+        this->sols[i].sol=new VRPIndex[n+2];
 
     this->hash_table=new struct htable_entry[HASH_TABLE_SIZE];
 
@@ -75,9 +75,8 @@ int VRPSolutionWarehouse::add_sol(VRPSolution *new_sol, int start_index)
     /// was not placed in the warehouse.  The start_index provides a place
     /// to begin the search -- useful when inserting multiple solutions
     /// whose order is already known.  Use start_index=0 if no information
-    /// about the solution's position  is known.  The VRPSolution being passed
-    /// in should be in "canonical form" for the hash function to work 
-    /// properly!!
+    /// about the solution's position  is known.  Duplicates are detected using
+    /// the edge_hash of the VRPSolution, which must be set by the caller.
     ///
 
     int i,j;
@@ -96,30 +95,17 @@ int VRPSolutionWarehouse::add_sol(VRPSolution *new_sol, int start_index)
     }
 
     // First check the hash table;
-    int hash_val=new_sol->hash(SALT_1);
-    int hash_val2=new_sol->hash(SALT_2);
-
-    if( (this->hash_table[hash_val].num_vals)>0)
+    if(this->contains(new_sol->edge_hash,new_sol->obj))
     {
 #if WAREHOUSE_DEBUG
-    printf("Possible duplicate at position %d\n",hash_val);
+        printf("Duplicate solution\n");
 #endif
-        // We have possibly seen this solution before -- hash again and check the lengths
-        for(j=0; j<this->hash_table[hash_val].num_vals;j++)
-        {
-            if( (VRPH_ABS(this->hash_table[hash_val].length[j] - new_sol->obj)<VRPH_EPSILON) &&
-                (this->hash_table[hash_val].hash_val_2[j]==hash_val2) )
-            {
-                // This must be the same solution
-#if WAREHOUSE_DEBUG
-                printf("Duplicate solution\n");
-#endif
-                return -1;
-            }
-
-        }
+        return -1;
     }
 
+    int hash_val=VRPH_WH_HASH_1(new_sol->edge_hash);
+    int hash_val2=VRPH_WH_HASH_2(new_sol->edge_hash);
+
 #if WAREHOUSE_DEBUG
     printf("New solution found (%d now at this location)\n",this->hash_table[hash_val].num_vals+1);
 #endif
@@ -153,7 +139,8 @@ int VRPSolutionWarehouse::add_sol(VRPSolution *new_sol, int start_index)
         this->sols[j].n=this->sols[j-1].n;
         this->sols[j].in_IP=this->sols[j-1].in_IP;
         this->sols[j].time=this->sols[j-1].time;
-        memcpy(this->sols[j].sol,this->sols[j-1].sol,((new_sol->n) + 2)*sizeof(int));
+        this->sols[j].edge_hash=this->sols[j-1].edge_hash;
+        memcpy(this->sols[j].sol,this->sols[j-1].sol,((new_sol->n) + 2)*sizeof(VRPIndex));
     }
 #if WAREHOUSE_DEBUG
     printf("WH after making room\n");
@@ -169,7 +156,8 @@ int VRPSolutionWarehouse::add_sol(VRPSolution *new_sol, int start_index)
     this->sols[i].n=new_sol->n;
     this->sols[i].in_IP=false;  // new solution
     this->sols[i].time=new_sol->time;
-    memcpy(this->sols[i].sol,new_sol->sol,((new_sol->n) + 2)*sizeof(int));
+    this->sols[i].edge_hash=new_sol->edge_hash;
+    memcpy(this->sols[i].sol,new_sol->sol,((new_sol->n) + 2)*sizeof(VRPIndex));
     if(this->num_sols < this->max_size)
         this->num_sols++;
     // Update worst
@@ -186,6 +174,29 @@ int VRPSolutionWarehouse::add_sol(VRPSolution *new_sol, int start_index)
 
 }
 
+bool VRPSolutionWarehouse::contains(VRPHash h, double obj)
+{
+    ///
+    /// Returns true if a solution with edge hash h and objective obj has 
+    /// already been added to the warehouse.
+    ///
+
+    int j;
+    int hash_val=VRPH_WH_HASH_1(h);
+    int hash_val2=VRPH_WH_HASH_2(h);
+
+    for(j=0; j<this->hash_table[hash_val].num_vals;j++)
+    {
+        if( (VRPH_ABS(this->hash_table[hash_val].length[j] - obj)<VRPH_EPSILON) &&
+            (this->hash_table[hash_val].hash_val_2[j]==hash_val2) )
+            // This must be the same solution
+            return true;
+    }
+
+    return false;
+
+}
+
 void VRPSolutionWarehouse::show()
 {
     ///
@@ -218,7 +229,7 @@ bool VRPSolutionWarehouse::liquidate()
 
     for(i=0;i<this->num_sols;i++)
         // Erase the existing solutions
-        memset(this->sols[i].sol,0,this->sols[i].n*sizeof(int));
+        memset(this->sols[i].sol,0,this->sols[i].n*sizeof(VRPIndex));
     
     this->num_sols=0;
     this->worst_obj=VRP_INFINITY;
@@ -281,10 +292,11 @@ VRPSolution::VRPSolution(int n)
     ///
 
     this->n=n;
-    this->sol=new int[n+2];
+    this->sol=new VRPIndex[n+2];
     this->in_IP=false;
     this->obj=0;
     this->time=0;
+    this->edge_hash=0;
 
 
 }
@@ -300,6 +312,7 @@ VRPSolution::VRPSolution()
     this->time=0;
     this->in_IP=false;
     this->obj=0;
+    this->edge_hash=0;
     this->sol=NULL;
 
 }
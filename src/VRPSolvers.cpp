@@ -69,11 +69,34 @@ double VRP::RTR_solve(int heuristics, int intensity, int max_stuck, int max_pert
     ThreeOpt     ThreeO;
     CrossExchange    CE;
     ThreePointMove ThreePM;
+    SwapStar    SS;
+    CompositeSearch CS;
+    HeldKarp    HK;
 
     double start_val;
     int *perm;
     perm=new int[this->num_nodes];
 
+    // Best-accept downhill searches with neighbor lists may use a global
+    // queue of move descriptors for ONE_POINT_MOVE, TWO_POINT_MOVE and TWO_OPT
+    bool move_queue=false;
+    VRPMoveQueue *MQ=NULL;
+    if((heuristics & VRPH_MOVE_QUEUE) && neighbor_list && accept_type==VRPH_BEST_ACCEPT)
+    {
+        move_queue=true;
+        MQ=new VRPMoveQueue(this->num_original_nodes);
+    }
+
+    // The downhill phase may instead search ONE_POINT_MOVE, TWO_POINT_MOVE,
+    // TWO_OPT and OR_OPT together, walking each neighborhood only once
+    int composite=0;
+    if((heuristics & VRPH_COMPOSITE_SEARCH) && !move_queue)
+    {
+        composite=heuristics & (ONE_POINT_MOVE|TWO_POINT_MOVE|TWO_OPT|OR_OPT);
+        if(heuristics & KITCHEN_SINK)
+            composite=ONE_POINT_MOVE|TWO_POINT_MOVE|TWO_OPT|OR_OPT;
+    }
+
 
     j=VRPH_ABS(this->next_array[VRPH_DEPOT]);
     for(i=0;i<this->num_nodes;i++)
@@ -103,7 +126,6 @@ double VRP::RTR_solve(int heuristics, int intensity, int max_stuck, int max_pert
     this->export_solution_buff(this->current_sol_buff);
     this->export_solution_buff(this->best_sol_buff);
 
-    normalize_route_numbers();
 
     ctr=0;
 
@@ -191,13 +213,7 @@ uphill:
                 random_permutation(perm, this->num_nodes);
 
             for(i=1;i<=n;i++)    
-                OR.search(this,perm[i-1],4,rules);
-
-            for(i=1;i<=n;i++)    
-                OR.search(this,perm[i-1],3,rules);
-
-            for(i=1;i<=n;i++)    
-                OR.search(this,perm[i-1],2,rules);
+                OR.search(this,perm[i-1],2,4,rules);
 
             //check_fixed_edges("After OR\n");
 
@@ -205,7 +221,6 @@ uphill:
 
         if(heuristics & THREE_OPT)
         {
-            normalize_route_numbers();
             R=total_number_of_routes;
 
             for(i=1; i<=R; i++)    
@@ -217,18 +232,31 @@ uphill:
 
         if(heuristics & CROSS_EXCHANGE)
         {
-            normalize_route_numbers();
             this->find_neighboring_routes();
             R=total_number_of_routes;
 
+            // Bounded segments and neighbor list endpoints make it affordable 
+            // to search every neighboring route
             for(i=1; i<=R-1; i++)    
             {
-                for(j=0;j<1;j++)
-                    CE.route_search(this,i, route[i].neighboring_routes[j],rules-neighbor_list); 
+                for(j=0;j<MAX_NEIGHBORING_ROUTES && j<R-1;j++)
+                    CE.route_search(this,i, route[i].neighboring_routes[j],CE_MAX_SEGMENT_LENGTH,rules); 
             }
 
             //check_fixed_edges("After CE\n");
         }
+
+        if(heuristics & SWAP_STAR)
+        {
+            this->find_neighboring_routes();
+            R=total_number_of_routes;
+
+            for(i=1; i<=R; i++)    
+            {
+                for(j=0;j<MAX_NEIGHBORING_ROUTES && j<R-1;j++)
+                    SS.route_search(this,i, route[i].neighboring_routes[j],rules); 
+            }
+        }
     }
 
     if(total_route_length<record)
@@ -260,94 +288,169 @@ downhill:
         printf("Downhill starting at %f (best=%f)\n",orig_val,this->best_total_route_length);
 
 
-    if((heuristics & ONE_POINT_MOVE)|| (heuristics & KITCHEN_SINK) )
+    if(composite)
     {
         rules=VRPH_DOWNHILL+objective+random+fixed+neighbor_list+accept_type;
+        clear_idle_stamps();
         for(;;)
         {
-            // One Point Move
+            // All of the operators in one pass over each neighborhood
             start_val=total_route_length;
 
             if(random)
                 random_permutation(perm, this->num_nodes);
 
             for(i=1;i<=n;i++)
-                OPM.search(this,perm[i-1],rules );
-
+            {
+                j=perm[i-1];
+                if(neighbor_list && is_idle(j,0))
+                    continue;
+                if(!CS.search(this,j,composite,rules))
+                    set_idle(j,0);
+            }
 
             if(VRPH_ABS(total_route_length-start_val)<VRPH_EPSILON)
                 break; 
+        }
+    }
+
+    if(!composite && ((heuristics & ONE_POINT_MOVE)|| (heuristics & KITCHEN_SINK)) )
+    {
+        rules=VRPH_DOWNHILL+objective+random+fixed+neighbor_list+accept_type;
+        if(move_queue)
+            MQ->search(this,ONE_POINT_MOVE,rules);
+        else
+        {
+            clear_idle_stamps();
+            for(;;)
+            {
+                // One Point Move
+                start_val=total_route_length;
 
+                if(random)
+                    random_permutation(perm, this->num_nodes);
+
+                for(i=1;i<=n;i++)
+                {
+                    j=perm[i-1];
+                    if(neighbor_list && is_idle(j,0))
+                        continue;
+                    if(!OPM.search(this,j,rules))
+                        set_idle(j,0);
+                }
+
+
+                if(VRPH_ABS(total_route_length-start_val)<VRPH_EPSILON)
+                    break; 
+
+            }
         }
 
     }
 
 
 
-    if((heuristics & TWO_POINT_MOVE) || (heuristics & KITCHEN_SINK) )
+    if(!composite && ((heuristics & TWO_POINT_MOVE) || (heuristics & KITCHEN_SINK)) )
     {
         rules=VRPH_DOWNHILL+VRPH_INTER_ROUTE_ONLY+objective+random+fixed+neighbor_list+accept_type;
-        for(;;)
+        if(move_queue)
+            MQ->search(this,TWO_POINT_MOVE,rules);
+        else
         {
-            // Two Point Move
-            start_val=total_route_length;
+            clear_idle_stamps();
+            for(;;)
+            {
+                // Two Point Move
+                start_val=total_route_length;
 
-            if(random)
-                random_permutation(perm, this->num_nodes);
+                if(random)
+                    random_permutation(perm, this->num_nodes);
 
-            for(i=1;i<=n;i++)    
-                TPM.search(this,perm[i-1],rules);
+                for(i=1;i<=n;i++)
+                {
+                    j=perm[i-1];
+                    if(neighbor_list && is_idle(j,0))
+                        continue;
+                    if(!TPM.search(this,j,rules))
+                        set_idle(j,0);
+                }
 
-            if(VRPH_ABS(total_route_length-start_val)<VRPH_EPSILON)
-                break; 
+                if(VRPH_ABS(total_route_length-start_val)<VRPH_EPSILON)
+                    break; 
 
+            }
         }
 
     }
 
 
 
-    if((heuristics & TWO_OPT)|| (heuristics & KITCHEN_SINK) )
+    if(!composite && ((heuristics & TWO_OPT)|| (heuristics & KITCHEN_SINK)) )
     {
         // Do inter-route first a la Li
         rules=VRPH_DOWNHILL+VRPH_INTER_ROUTE_ONLY+objective+random+fixed+neighbor_list+accept_type;
-        for(;;)
+        if(move_queue)
+            MQ->search(this,TWO_OPT,rules);
+        else
         {
+            clear_idle_stamps();
+            for(;;)
+            {
 
-            start_val=total_route_length;
+                start_val=total_route_length;
 
-            if(random)
-                random_permutation(perm, this->num_nodes);
+                if(random)
+                    random_permutation(perm, this->num_nodes);
 
-            for(i=1;i<=n;i++)    
-                TO.search(this,perm[i-1],rules);
+                for(i=1;i<=n;i++)
+                {
+                    j=perm[i-1];
+                    if(neighbor_list && is_idle(j,0))
+                        continue;
+                    if(!TO.search(this,j,rules))
+                        set_idle(j,0);
+                }
 
-            if(VRPH_ABS(total_route_length-start_val)<VRPH_EPSILON)
-                break; 
+                if(VRPH_ABS(total_route_length-start_val)<VRPH_EPSILON)
+                    break; 
+            }
         }
 
         // Now do both intra and inter
         rules=VRPH_DOWNHILL+objective+random+fixed+neighbor_list+accept_type;
 
-        for(;;)
+        if(move_queue)
+            MQ->search(this,TWO_OPT,rules);
+        else
         {
+            clear_idle_stamps();
+            for(;;)
+            {
 
-            start_val=total_route_length;
+                start_val=total_route_length;
 
-            if(random)
-                random_permutation(perm, this->num_nodes);
+                if(random)
+                    random_permutation(perm, this->num_nodes);
 
-            for(i=1;i<=n;i++)    
-                TO.search(this,perm[i-1],rules);
+                for(i=1;i<=n;i++)
+                {
+                    j=perm[i-1];
+                    if(neighbor_list && is_idle(j,0))
+                        continue;
+                    if(!TO.search(this,j,rules))
+                        set_idle(j,0);
+                }
 
-            if(VRPH_ABS(total_route_length-start_val)<VRPH_EPSILON)
-                break; 
+                if(VRPH_ABS(total_route_length-start_val)<VRPH_EPSILON)
+                    break; 
+            }
         }
     }
 
     if((heuristics & THREE_POINT_MOVE) || (heuristics & KITCHEN_SINK) )
     {
         rules=VRPH_DOWNHILL+VRPH_INTER_ROUTE_ONLY+objective+random+fixed+accept_type+neighbor_list;
+        clear_idle_stamps();
         for(;;)
         {
             // Three Point Move
@@ -356,8 +459,14 @@ downhill:
             if(random)
                 random_permutation(perm, this->num_nodes);
 
-            for(i=1;i<=n;i++)    
-                ThreePM.search(this,perm[i-1],rules);
+            for(i=1;i<=n;i++)
+            {
+                j=perm[i-1];
+                if(neighbor_list && is_idle(j,0))
+                    continue;
+                if(!ThreePM.search(this,j,rules))
+                    set_idle(j,0);
+            }
 
             if(VRPH_ABS(total_route_length-start_val)<VRPH_EPSILON)
                 break; 
@@ -371,6 +480,7 @@ downhill:
 
         rules=VRPH_DOWNHILL+ objective +random +fixed + accept_type + neighbor_list;
 
+        clear_idle_stamps();
         for(;;)
         {
             // OrOpt
@@ -378,12 +488,14 @@ downhill:
             if(random)
                 random_permutation(perm, this->num_nodes);
 
-            for(i=1;i<=n;i++)    
-                OR.search(this,perm[i-1],4,rules);
-            for(i=1;i<=n;i++)
-                OR.search(this,perm[i-1],3,rules);
             for(i=1;i<=n;i++)
-                OR.search(this,perm[i-1],2,rules);
+            {
+                j=perm[i-1];
+                if(neighbor_list && is_idle(j,0))
+                    continue;
+                if(!OR.search(this,j,2,4,rules))
+                    set_idle(j,0);
+            }
 
 
             if(VRPH_ABS(total_route_length-start_val)<VRPH_EPSILON)
@@ -391,18 +503,32 @@ downhill:
         }
     }
 
-    if((heuristics & THREE_OPT) || (heuristics & KITCHEN_SINK) )
+    if(this->use_held_karp)
     {
-        normalize_route_numbers();
-        R= total_number_of_routes;
-        rules=VRPH_DOWNHILL+objective+VRPH_INTRA_ROUTE_ONLY+ random +fixed + accept_type;
+        // One exact solve of each short route in place of the 3-opt sweeps,
+        // spread over the threads
+        rules=VRPH_DOWNHILL+objective+VRPH_INTRA_ROUTE_ONLY+ random +fixed + accept_type + neighbor_list;
         for(;;)
         {
-            // 3OPT
             start_val=total_route_length;
 
-            for(i=1;i<=R;i++)    
-                ThreeO.route_search(this,i,rules);
+            HK.search_routes(this,rules);
+
+            if(VRPH_ABS(total_route_length-start_val)<VRPH_EPSILON)
+                break; 
+        }
+    }
+
+    if(!this->use_held_karp && ((heuristics & THREE_OPT) || (heuristics & KITCHEN_SINK)) )
+    {
+        rules=VRPH_DOWNHILL+objective+VRPH_INTRA_ROUTE_ONLY+ random +fixed + accept_type + neighbor_list;
+        for(;;)
+        {
+            // 3OPT, on copies of the routes spread over the threads.  The
+            // routes already known to be 3-opt optimal are skipped.
+            start_val=total_route_length;
+
+            ThreeO.search_routes(this,rules);
 
             if(VRPH_ABS(total_route_length-start_val)<VRPH_EPSILON)
                 break; 
@@ -412,7 +538,6 @@ downhill:
 
     if( (heuristics & CROSS_EXCHANGE) )
     {
-        normalize_route_numbers();
         this->find_neighboring_routes();
         R=total_number_of_routes;
 
@@ -425,6 +550,20 @@ downhill:
         }
     }
 
+    if( (heuristics & SWAP_STAR) )
+    {
+        this->find_neighboring_routes();
+        R=total_number_of_routes;
+
+        rules=VRPH_DOWNHILL+objective+ random +fixed + accept_type;
+
+        for(i=1; i<=R; i++)    
+        {
+            for(j=0;j<MAX_NEIGHBORING_ROUTES && j<R-1;j++)
+                SS.route_search(this,i, route[i].neighboring_routes[j], rules); 
+        }
+    }
+
 
     // Repeat the downhill phase until we find no more improvements
     if(total_route_length<orig_val-VRPH_EPSILON)
@@ -478,6 +617,8 @@ downhill:
     }
 
     delete [] perm; 
+    if(MQ)
+        delete MQ;
 
     // Import the best solution found
     this->import_solution_buff(best_sol_buff);
@@ -561,7 +702,6 @@ double VRP::SA_solve(int heuristics, double start_temp, double cool_ratio,
     this->neighbor_list_size=VRPH_MIN(nlist_size, num_nodes);
 
     best_total_route_length=this->total_route_length;
-    normalize_route_numbers();
 
     ctr=0;
 
@@ -594,7 +734,6 @@ double VRP::SA_solve(int heuristics, double start_temp, double cool_ratio,
             if(heuristics & THREE_OPT)
             {
                 rules=VRPH_SIMULATED_ANNEALING+VRPH_INTRA_ROUTE_ONLY+random+fixed+objective;
-                normalize_route_numbers();
                 R=total_number_of_routes;
                 for(i=1; i<=R; i++)    
                 {
@@ -682,14 +821,7 @@ double VRP::SA_solve(int heuristics, double start_temp, double cool_ratio,
 
                 for(i=1;i<=n;i++)    
                 {
-                    OR.search(this,perm[i-1],3,rules);
-                    if(this->total_route_length > worst_obj)
-                        worst_obj=this->total_route_length;
-                }
-
-                for(i=1;i<=n;i++)    
-                {
-                    OR.search(this,perm[i-1],2,rules);
+                    OR.search(this,perm[i-1],2,3,rules);
                     if(this->total_route_length > worst_obj)
                         worst_obj=this->total_route_length;
                 }
@@ -699,7 +831,6 @@ double VRP::SA_solve(int heuristics, double start_temp, double cool_ratio,
 
             if(heuristics & CROSS_EXCHANGE)
             {
-                normalize_route_numbers();
                 this->find_neighboring_routes();
                 R=total_number_of_routes;
                 rules=VRPH_SIMULATED_ANNEALING+fixed+objective;
@@ -22,8 +22,7 @@ VRPTabuList::VRPTabuList()
     this->num_entries=0;
     this->full=false;
     this->start_index=0;
-    this->hash_vals1=NULL;
-    this->hash_vals2=NULL;
+    this->hash_vals=NULL;
 
     
 }
@@ -38,15 +37,11 @@ VRPTabuList::VRPTabuList(int t)
     this->num_entries=0;
     this->full=false;
     this->start_index=0;
-    this->hash_vals1=new int[t];
-    this->hash_vals2=new int[t];
+    this->hash_vals=new VRPHash[t];
 
     int i;
     for(i=0;i<this->max_entries;i++)
-    {
-        this->hash_vals1[i]=-1;
-        this->hash_vals2[i]=-1;
-    }
+        this->hash_vals[i]=0;
     
 
 }
@@ -57,32 +52,43 @@ VRPTabuList::~VRPTabuList()
     /// Destructor for the VRPTabuList.
     ///
 
-    if(this->hash_vals1)
-        delete [] hash_vals1;
-
-    if(this->hash_vals2)
-        delete [] hash_vals2;
+    if(this->hash_vals)
+        delete [] hash_vals;
 }
 
-void VRPTabuList::update_list(VRPRoute *r)
+bool VRPTabuList::contains(VRPHash h)
 {
     ///
-    /// Updates the tabu list by adding the route r.
+    /// Returns true if a route with edge hash h is in the tabu list.
     ///
 
-    r->hash_val=r->hash(SALT_1);
-    r->hash_val2=r->hash(SALT_2);
+    int i;
+
+    for(i=0;i<this->num_entries;i++)
+    {
+        if(this->hash_vals[i]==h)
+            return true;
+    }
+
+    return false;
+
+}
+
+void VRPTabuList::update_list(VRPHash h)
+{
+    ///
+    /// Updates the tabu list by adding the route with edge hash h
+    /// (see VRP::hash_route()).
+    ///
 
 #if VRPH_TABU_DEBUG
-    printf("Adding route with hashes (%d, %d) and length, load (%5.2f, %d) to tabu list\n",
-        r->hash_val,r->hash_val2,r->length,r->load);
+    printf("Adding route with hash %llx to tabu list\n",h);
 #endif
     
     if(this->num_entries < this->max_entries)
     {
         // Update the lists of hash_vals
-        this->hash_vals1[this->num_entries]=r->hash_val;
-        this->hash_vals2[this->num_entries]=r->hash_val2;
+        this->hash_vals[this->num_entries]=h;
 
         this->num_entries++;
 #if VRPH_TABU_DEBUG
@@ -97,8 +103,7 @@ void VRPTabuList::update_list(VRPRoute *r)
     // The list is full - overwrite the current start_index entry
     // and increment start_index
 
-    this->hash_vals1[this->start_index]=r->hash_val;
-    this->hash_vals2[this->start_index]=r->hash_val2;
+    this->hash_vals[this->start_index]=h;
     this->start_index = ((this->start_index + 1) % (this->num_entries));
     this->full=true;
 
@@ -121,10 +126,7 @@ void VRPTabuList::empty()
 #endif
     int i;
     for(i=0;i<this->max_entries;i++)
-    {
-        this->hash_vals1[i]=-1;
-        this->hash_vals2[i]=-1;
-    }
+        this->hash_vals[i]=0;
 
     this->start_index=0;
     this->num_entries=0;
@@ -146,9 +148,8 @@ void VRPTabuList::show()
 
     for(int i=0;i<this->num_entries;i++)
     {
-        printf("Tabu entry %d: (%d,%d)\n",((start_index+i)%this->max_entries),
-            this->hash_vals1[((start_index+i)%this->max_entries)],
-            this->hash_vals2[((start_index+i)%this->max_entries)]);
+        printf("Tabu entry %d: %llx\n",((start_index+i)%this->max_entries),
+            this->hash_vals[((start_index+i)%this->max_entries)]);
     }
 
     return;
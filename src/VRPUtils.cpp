@@ -243,3 +243,193 @@ int VRPRouteCompare(const void *a, const void *b)
 
 }
 
+VRPHash VRPHashMix(VRPHash x)
+{
+	///
+	/// Scrambles the bits of x (the SplitMix64 finalizer).  Used to
+	/// generate the random keys for the solution hash reproducibly.
+	///
+
+	x+=0x9E3779B97F4A7C15ULL;
+	x=(x^(x>>30))*0xBF58476D1CE4E5B9ULL;
+	x=(x^(x>>27))*0x94D049BB133111EBULL;
+	return x^(x>>31);
+}
+
+
+VRPEdgeSet::VRPEdgeSet()
+{
+	///
+	/// Constructs an empty edge set.  The table is allocated
+	/// when the first edge is added.
+	///
+
+	this->num_edges=0;
+	this->size=0;
+	this->keys=NULL;
+}
+
+VRPEdgeSet::~VRPEdgeSet()
+{
+	///
+	/// Destructor for the edge set.
+	///
+
+	if(this->keys)
+		delete [] this->keys;
+}
+
+VRPHash VRPEdgeSet::key(int a, int b)
+{
+	///
+	/// Returns the key of the undirected edge a-b, which is never 0.
+	///
+
+	if(a>b)
+	{
+		int t=a;
+		a=b;
+		b=t;
+	}
+	return (((VRPHash)(a+1))<<32) | (VRPHash)(b+1);
+}
+
+int VRPEdgeSet::find(VRPHash k)
+{
+	///
+	/// Returns the slot holding key k, or the empty slot where it
+	/// would be placed.
+	///
+
+	int i=(int)(VRPHashMix(k)&(VRPHash)(this->size-1));
+	while(this->keys[i]!=0 && this->keys[i]!=k)
+		i=(i+1)&(this->size-1);
+	return i;
+}
+
+void VRPEdgeSet::grow()
+{
+	///
+	/// Doubles the size of the table and places the edges again.
+	///
+
+	VRPHash *old_keys=this->keys;
+	int i,old_size=this->size;
+
+	this->size=(old_size==0)?16:2*old_size;
+	this->keys=new VRPHash[this->size];
+	for(i=0;i<this->size;i++)
+		this->keys[i]=0;
+
+	for(i=0;i<old_size;i++)
+	{
+		if(old_keys[i]!=0)
+			this->keys[this->find(old_keys[i])]=old_keys[i];
+	}
+
+	if(old_keys)
+		delete [] old_keys;
+}
+
+bool VRPEdgeSet::add(int a, int b)
+{
+	///
+	/// Adds the edge a-b to the set.  Returns false if it was already
+	/// there.
+	///
+
+	VRPHash k=this->key(a,b);
+	int i;
+
+	// Keep the table at most half full
+	if(2*(this->num_edges+1)>this->size)
+		this->grow();
+
+	i=this->find(k);
+	if(this->keys[i]==k)
+		return false;
+
+	this->keys[i]=k;
+	this->num_edges++;
+	return true;
+}
+
+bool VRPEdgeSet::contains(int a, int b)
+{
+	///
+	/// Returns true if the edge a-b is in the set.
+	///
+
+	if(this->num_edges==0)
+		return false;
+
+	return this->keys[this->find(this->key(a,b))]!=0;
+}
+
+bool VRPEdgeSet::remove(int a, int b)
+{
+	///
+	/// Removes the edge a-b from the set.  Returns false if it was not
+	/// there.  The keys that follow it in the same cluster are shifted
+	/// back so that no deleted markers are needed.
+	///
+
+	int i,j,h,mask;
+
+	if(this->num_edges==0)
+		return false;
+
+	i=this->find(this->key(a,b));
+	if(this->keys[i]==0)
+		return false;
+
+	mask=this->size-1;
+	this->keys[i]=0;
+	this->num_edges--;
+
+	j=i;
+	for(;;)
+	{
+		j=(j+1)&mask;
+		if(this->keys[j]==0)
+			break;
+
+		// The key in slot j can fill slot i if i is on its probe path
+		h=(int)(VRPHashMix(this->keys[j])&(VRPHash)mask);
+		if(((i-h)&mask) < ((j-h)&mask))
+		{
+			this->keys[i]=this->keys[j];
+			this->keys[j]=0;
+			i=j;
+		}
+	}
+
+	return true;
+}
+
+bool VRPEdgeSet::get_edge(int k, int *a, int *b)
+{
+	///
+	/// Places the endpoints of the edge in slot k of the table in a<b
+	/// and returns true, or returns false if slot k is empty.  Slots run
+	/// from 0 to size-1.
+	///
+
+	if(this->keys[k]==0)
+		return false;
+
+	*a=(int)(this->keys[k]>>32)-1;
+	*b=(int)(this->keys[k]&0xFFFFFFFFULL)-1;
+	return true;
+}
+
+void VRPEdgeSet::clear()
+{
+	///
+	/// Removes all edges from the set.
+	///
+
+	for(int i=0;i<this->size;i++)
+		this->keys[i]=0;
+	this->num_edges=0;
+}
@@ -78,7 +78,7 @@ int main(int argc, char **argv)
    // A few things required by VRPH
    int i;
    double best_sol=VRP_INFINITY;
-   int best_sol_buff[500];
+   VRPIndex best_sol_buff[500];
 #endif
 
    vrp_problem *vrp;
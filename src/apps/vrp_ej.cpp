@@ -30,7 +30,8 @@ int main(int argc, char *argv[])
     char outfile[VRPH_STRING_SIZE];
     bool has_outfile=false, has_solfile=false;
     int i,j,n,num_ejected, num_trials, num_heur_sols, num_improvements;
-    int *ejected_buff, *heur_solbuff, *ej_solbuff, *best_solbuff;
+    int *ejected_buff;
+    VRPIndex *heur_solbuff, *ej_solbuff, *best_solbuff;
     int method=-1;
     clock_t start, stop;
 
@@ -71,9 +72,9 @@ int main(int argc, char *argv[])
 
     // Declare some buffers for solutions, nodes to eject, etc.
     ejected_buff=new int[n+2];
-    heur_solbuff=new int[n+2];
-    ej_solbuff=new int[n+2];
-    best_solbuff=new int[n+2];
+    heur_solbuff=new VRPIndex[n+2];
+    ej_solbuff=new VRPIndex[n+2];
+    best_solbuff=new VRPIndex[n+2];
     num_ejected=num_trials=0;
     num_heur_sols=1;
 
@@ -61,7 +61,7 @@ void OSI_recover_route(int id, int **orderings, VRPRoute *r)
   
 }
 
-void OSI_recover_solution(OsiSolverInterface *si, int **orderings, int *sol_buff)
+void OSI_recover_solution(OsiSolverInterface *si, int **orderings, VRPIndex *sol_buff)
 {
     ///
     /// Extracts the solution from the current set partitioning instance
@@ -226,7 +226,8 @@ int main(int argc, char **argv)
 {
     VRPH_version();
 
-    int i, j, k, n, status, num_attempts, *sol_buff, *IP_sol_buff;
+    int i, j, k, n, status, num_attempts;
+    VRPIndex *sol_buff, *IP_sol_buff;
     char in_file[200];
     double lambda, best_heur_sol=VRP_INFINITY;
     bool first_sol=false, bootstrap=false;;
@@ -288,8 +289,8 @@ int main(int argc, char **argv)
     // This will be used to import/export solutions
     fresh_solution = new VRPSolution(n);
     // Create buffers for importing solutions
-    sol_buff= new int[n+2];
-    IP_sol_buff = new int[n+2];
+    sol_buff= new VRPIndex[n+2];
+    IP_sol_buff = new VRPIndex[n+2];
 
     // Declare an OSI interface
     si=new OsiGlpkSolverInterface;
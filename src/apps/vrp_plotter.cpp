@@ -102,8 +102,8 @@ int main(int argc, char *argv[])
     printf("Imported instance\n");
 
     V.read_solution_file(solfile);
-    int *sol;
-    sol=new int[V.get_num_nodes()+2];
+    VRPIndex *sol;
+    sol=new VRPIndex[V.get_num_nodes()+2];
     V.export_canonical_solution_buff(sol);
     V.import_solution_buff(sol);
     printf("Imported solution\n");
@@ -30,6 +30,7 @@ int main(int argc, char *argv[])
     int i,n;
     clock_t start, stop;
     double elapsed;
+    VRPViolation violation;
 
     // Default  parameter settings
     bool verbose=false;
@@ -54,10 +55,12 @@ int main(int argc, char *argv[])
     bool has_fixed_edges_file=false;
     int heuristics=0;
     double dev=.01;
-    int *final_sol;
+    VRPIndex *final_sol;
     double final_obj=VRP_INFINITY;
     bool do_pdf=false;
-    int *my_sol_buff;
+    bool shared_states=false;
+    VRPIndex *my_sol_buff;
+    VRP *W, **states=NULL;
 
 
     if(argc<2 || (strncmp(argv[1],"-help",5)==0)||(strncmp(argv[1],"--help",6)==0)||(strncmp(argv[1],"-h",2)==0))
@@ -69,20 +72,30 @@ int main(int argc, char *argv[])
         
         fprintf(stderr,"\t-a <accept_type> 0 for VRPH_FIRST_ACCEPT or 1 for VRPH_BEST_ACCEPT\n\t\t(default is VRPH_FIRST_ACCEPT)\n");
         
+        fprintf(stderr,"\t-c searches ONE_POINT_MOVE, TWO_POINT_MOVE, TWO_OPT and OR_OPT\n");
+        fprintf(stderr,"\t\t together in one pass over each neighborhood in the downhill phase\n");
+
         fprintf(stderr,"\t-d <deviation> runs the RTR search with given deviation\n");
         fprintf(stderr,"\t\t default is dev=.01\n");
 
+        fprintf(stderr,"\t-e <size> solves the routes with at most size customers exactly\n");
+        fprintf(stderr,"\t\t with HELD_KARP (default is 12, at most 16)\n");
+
         fprintf(stderr,"\t-fix <fixed_edge_file> will fix all of the edges in the provided file\n");
                 
         fprintf(stderr,"\t-h <heuristic> applies the specified heuristics (can be repeated)\n");
         fprintf(stderr,"\t\t default is ONE_POINT_MOVE, TWO_POINT_MOVE, and TWO_OPT\n");
-        fprintf(stderr,"\t\t others available are OR_OPT, THREE_OPT, and CROSS_EXCHANGE\n");
+        fprintf(stderr,"\t\t others available are OR_OPT, THREE_OPT, CROSS_EXCHANGE, SWAP_STAR,\n");
+        fprintf(stderr,"\t\t and HELD_KARP, which solves short routes exactly in place of THREE_OPT\n");
         fprintf(stderr,"\t\t Example: -h OR_OPT -h THREE_OPT -h TWO_OPT -h ONE_POINT_MOVE\n");
         fprintf(stderr,"\t\t Setting -h KITCHEN_SINK applies all heuristics in the \n");
         fprintf(stderr,"\t\t improvement phase\n");
         
         fprintf(stderr,"\t-sol <sol_file> begins with an existing solution contained\n");
         fprintf(stderr,"\t\t in sol_file\n");
+
+        fprintf(stderr,"\t-S runs the search from each initial solution in its own search\n");
+        fprintf(stderr,"\t\t state sharing the instance data\n");
         
         fprintf(stderr,"\t-v prints verbose output to stdout\n");
         
@@ -108,6 +121,9 @@ int main(int argc, char *argv[])
 
         fprintf(stderr,"\t-pdf will create a .pdf from the .ps file created by -plot\n");
 
+        fprintf(stderr,"\t-q always makes the best move over all nodes in the downhill phase\n");
+        fprintf(stderr,"\t\t for ONE_POINT_MOVE, TWO_POINT_MOVE and TWO_OPT (requires -a 1)\n");
+
         fprintf(stderr,"\t-r will search the neighborhood in a random fashion\n");
 
         fprintf(stderr,"\t-t <tabu_list_size> will use a primitive Tabu Search in the uphill phase\n");
@@ -139,7 +155,7 @@ int main(int argc, char *argv[])
     // Get # of non-VRPH_DEPOT nodes
     n=VRPGetDimension(infile);
     int num_days=VRPGetNumDays(infile);
-    my_sol_buff=new int[n+2];
+    my_sol_buff=new VRPIndex[n+2];
 
 
     VRP V(n,num_days);
@@ -147,7 +163,7 @@ int main(int argc, char *argv[])
         
 
     // Allocate the buffer for the final solution
-    final_sol=new int[n+2];    
+    final_sol=new VRPIndex[n+2];    
 
     // Parse command line
     for(i=2;i<argc;i++)
@@ -164,9 +180,19 @@ int main(int argc, char *argv[])
                 accept_type=VRPH_FIRST_ACCEPT;
         }
 
+        if(strcmp(argv[i],"-c")==0)
+            heuristics|=VRPH_COMPOSITE_SEARCH;
+
         if(strcmp(argv[i],"-d")==0)
             dev=atof(argv[i+1]);
 
+        if(strcmp(argv[i],"-e")==0)
+        {
+            V.held_karp_size=atoi(argv[i+1]);
+            if(V.held_karp_size<0 || V.held_karp_size>HELD_KARP_MAX_SIZE)
+                report_error("%s: size must be between 0 and %d\n",__FUNCTION__,HELD_KARP_MAX_SIZE);
+        }
+
         if(strcmp(argv[i],"-D")==0)
             intensity=atoi(argv[i+1]);
 
@@ -191,6 +217,10 @@ int main(int argc, char *argv[])
                 heuristics|=THREE_OPT;
             if(strcmp(argv[i+1],"CROSS_EXCHANGE")==0)
                 heuristics|=CROSS_EXCHANGE;
+            if(strcmp(argv[i+1],"SWAP_STAR")==0)
+                heuristics|=SWAP_STAR;
+            if(strcmp(argv[i+1],"HELD_KARP")==0)
+                V.use_held_karp=true;
             if(strcmp(argv[i+1],"THREE_POINT_MOVE")==0)
                 heuristics|=THREE_POINT_MOVE;
             if(strcmp(argv[i+1],"KITCHEN_SINK")==0)
@@ -249,6 +279,9 @@ int main(int argc, char *argv[])
         if(strcmp(argv[i],"-pdf")==0)
             do_pdf=true;
 
+        if(strcmp(argv[i],"-q")==0)
+            heuristics|=VRPH_MOVE_QUEUE;
+
 
 
         if(strcmp(argv[i],"-sol")==0)
@@ -257,6 +290,9 @@ int main(int argc, char *argv[])
             strcpy(sol_file,argv[i+1]);
         }
 
+        if(strcmp(argv[i],"-S")==0)
+            shared_states=true;
+
         if(strcmp(argv[i],"-t")==0)
         {
             tabu=VRPH_TABU;    
@@ -319,6 +355,15 @@ int main(int argc, char *argv[])
     start=clock();
     if(!has_sol_file)
     {
+        if(shared_states)
+        {
+            // One search state per initial solution, all on V's instance
+            // data.  V must outlive them.
+            states=new VRP *[num_lambdas];
+            for(i=0;i<num_lambdas;i++)
+                states[i]=new VRP(&V);
+        }
+
         // No solution imported - start from scratch
         for(i=0;i<num_lambdas;i++)
         {
@@ -338,12 +383,19 @@ int main(int argc, char *argv[])
             if(verbose)
                 printf("CW solution %d[L=%1.4f]: %5.4f\n",i,lambda_vals[i], V.get_total_route_length());
 
+            W=&V;
+            if(shared_states)
+            {
+                W=states[i];
+                W->clone(&V);
+            }
+
             // Run the record-to-record travel algorithm with the given parameters
-            V.RTR_solve(heuristics, intensity, max_tries, num_perturbs, dev, nlist_size, 
+            W->RTR_solve(heuristics, intensity, max_tries, num_perturbs, dev, nlist_size, 
                 perturb_type, accept_type, verbose);
         
             // Check for a new global best solution - recall the best solution found
-            V.get_best_sol_buff(my_sol_buff);
+            W->get_best_sol_buff(my_sol_buff);
             V.import_solution_buff(my_sol_buff);
             if(V.get_total_route_length()-V.get_total_service_time() < final_obj)
             {
@@ -352,11 +404,18 @@ int main(int argc, char *argv[])
             }
             
             if(verbose)
-                printf("%5.2f\n",V.get_best_total_route_length()-V.get_total_service_time());
+                printf("%5.2f\n",W->get_best_total_route_length()-V.get_total_service_time());
 
             // Reset best
             V.set_best_total_route_length(VRP_INFINITY);
         }
+
+        if(shared_states)
+        {
+            for(i=0;i<num_lambdas;i++)
+                delete states[i];
+            delete [] states;
+        }
     }
     else
     {
@@ -379,6 +438,14 @@ int main(int argc, char *argv[])
    
     // Restore the best solution found
     V.import_solution_buff(final_sol);
+
+    // Make sure that it satisfies every constraint, including time windows
+    if(V.check_feasibility(&violation)==false)
+    {
+        fprintf(stderr,"Length violation: %f  Capacity violation: %d  Time window violation: %f\n",
+            violation.length_violation,violation.capacity_violation,violation.time_window_violation);
+        report_error("%s: final solution is infeasible\n",__FUNCTION__);
+    }
     
     elapsed=(double)(stop-start)/CLOCKS_PER_SEC;
   
@@ -222,7 +222,7 @@ int main(int argc, char *argv[])
 
     double best_obj=VRP_INFINITY;
     double this_obj, start_obj;
-    int *best_sol=new int[n+2];
+    VRPIndex *best_sol=new VRPIndex[n+2];
 
     time_t start=clock();
     if(has_solfile == false)
@@ -277,8 +277,7 @@ int main(int argc, char *argv[])
         printf("Solution before cleaning individual routes: %5.3f\n",V.get_total_route_length()-
         V.get_total_service_time());
     // Clean up the individual routes since the SA routine doesn't do this for us
-    for(i=1;i<=V.get_total_number_of_routes();i++)
-        V.clean_route(i,ONE_POINT_MOVE+TWO_POINT_MOVE+TWO_OPT+THREE_OPT+THREE_POINT_MOVE);
+    V.clean_routes(ONE_POINT_MOVE+TWO_POINT_MOVE+TWO_OPT+THREE_OPT+THREE_POINT_MOVE);
     if(verbose)
     {
         printf("Solution after cleaning individual routes: %5.3f\n",V.get_total_route_length()-